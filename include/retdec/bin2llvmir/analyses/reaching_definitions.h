@@ -3,20 +3,25 @@
 * @brief Reaching definitions analysis (RDA) builds UD and DU chains.
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 *
-* Right now, this works on an entire module. But we could insert an another layer
-* that represents functions. Then it would be possible to associate BBs with
-* functions that own them and recompute RDA only for the selected function.
+* Definitions of each function are densely numbered and sets of definitions
+* reaching basic blocks are bit vectors indexed by these numbers. They are
+* computed by a worklist solver visiting basic blocks in reverse post-order.
+* Functions of a module are analysed in parallel by @c runOnModule(). Results
+* for a single function can be recomputed by @c runOnFunction(), results for
+* several functions (in parallel) by @c runOnFunctions().
 */
 
 #ifndef RETDEC_BIN2LLVMIR_ANALYSES_REACHING_DEFINITIONS_H
 #define RETDEC_BIN2LLVMIR_ANALYSES_REACHING_DEFINITIONS_H
 
+#include <atomic>
 #include <map>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include <llvm/ADT/BitVector.h>
 #include <llvm/ADT/SmallPtrSet.h>
 #include <llvm/IR/Module.h>
 
@@ -29,6 +34,7 @@ namespace bin2llvmir {
 class Definition;
 class Use;
 class BasicBlockEntry;
+class DefinitionNumbering;
 class ReachingDefinitionsAnalysis;
 
 using Changed = bool;
@@ -72,6 +78,34 @@ class Use
 		DefSet defs;
 };
 
+/**
+ * Dense numbering of definitions and their sources in one function.
+ */
+class DefinitionNumbering
+{
+	public:
+		unsigned addDefinition(Definition* d);
+		void finalize();
+
+		std::size_t size() const;
+		Definition* getDefinition(unsigned id) const;
+		bool getSourceId(const llvm::Value* src, unsigned& id) const;
+		void removeDefinitions(llvm::BitVector& bv, unsigned source) const;
+		void getDefinitions(
+				const llvm::BitVector& bv,
+				unsigned source,
+				std::vector<Definition*>& res) const;
+
+	private:
+		std::vector<Definition*> _defs;
+		std::unordered_map<const llvm::Value*, unsigned> _sourceIds;
+		/// Numbers of definitions of each source.
+		std::vector<std::vector<unsigned>> _sourceDefs;
+		/// Masks of definitions of sources with many definitions, empty for
+		/// the other sources.
+		std::vector<llvm::BitVector> _sourceMasks;
+};
+
 class BasicBlockEntry
 {
 	public:
@@ -82,8 +116,10 @@ class BasicBlockEntry
 				std::ostream& out,
 				const BasicBlockEntry& bbe);
 
-		void initializeKillDefSets();
-		Changed initDefsOut();
+		void initializeKillGenSets(const DefinitionNumbering& numbering);
+		Changed initDefsOut(
+				const llvm::BitVector& defsIn,
+				const DefinitionNumbering& numbering);
 
 		const DefSet& defsFromUse(const llvm::Instruction* I) const;
 		const UseSet& usesFromDef(const llvm::Instruction* I) const;
@@ -98,16 +134,19 @@ class BasicBlockEntry
 
 		BBEntrySet prevBBs;
 
-		// defsIn is union of prevBBs' defsOuts
-		DefSet defsOut;
-		DefSet genDefs;
-		UnorderedValSet killDefs;
+		/// Number of the first definition in @c defs, the others follow.
+		unsigned firstDefId = 0;
 
-		bool changed = false;
+		// defsIn is union of prevBBs' defsOuts
+		llvm::BitVector defsOut;
+		/// Numbers of the last definitions of sources defined in this block.
+		std::vector<unsigned> genDefs;
+		/// Numbers of sources defined in this block.
+		std::vector<unsigned> killSources;
 
 	private:
 		unsigned id;
-	    static int newUID;
+		static std::atomic<int> newUID;
 };
 
 class ReachingDefinitionsAnalysis
@@ -121,7 +160,13 @@ class ReachingDefinitionsAnalysis
 				llvm::Function& F,
 				Config* c = nullptr,
 				bool trackFlagRegs = false);
+		bool runOnFunctions(
+				llvm::Module& M,
+				const std::vector<llvm::Function*>& fncs,
+				Config* c = nullptr,
+				bool trackFlagRegs = false);
 		void clear();
+		void clearFunction(const llvm::Function* F);
 		bool wasRun() const;
 
 	public:
@@ -135,19 +180,31 @@ class ReachingDefinitionsAnalysis
 				const ReachingDefinitionsAnalysis& rda);
 
 	private:
-		void run();
-		const BasicBlockEntry& getBasicBlockEntry(const llvm::Instruction* I) const;
-		void initializeBasicBlocks(llvm::Module& M);
-		void initializeBasicBlocks(llvm::Function& F);
-		void initializeBasicBlocksPrev();
-		void initializeKillGenSets();
-		void propagate();
-		void initializeDefsAndUses();
-		void clearInternal();
+		using BBEntryMap = std::unordered_map<const llvm::BasicBlock*, BasicBlockEntry>;
+
+	private:
+		void run(llvm::Function& F, BBEntryMap& bbs) const;
+		void initializeBasicBlocks(llvm::Function& F, BBEntryMap& bbs) const;
+		void initializeBasicBlocksPrev(BBEntryMap& bbs) const;
+		void initializeKillGenSets(
+				llvm::Function& F,
+				BBEntryMap& bbs,
+				DefinitionNumbering& numbering) const;
+		void propagate(
+				llvm::Function& F,
+				BBEntryMap& bbs,
+				const DefinitionNumbering& numbering) const;
+		void initializeDefsAndUses(
+				BBEntryMap& bbs,
+				const DefinitionNumbering& numbering) const;
+		void clearInternal(BBEntryMap& bbs) const;
+		void registerDefsAndUses(BBEntryMap& bbs);
 
 	private:
-		std::map<const llvm::Function*, std::map<const llvm::BasicBlock*, BasicBlockEntry>> bbMap;
-//		std::map<const llvm::BasicBlock*, BasicBlockEntry> bbMap;
+		std::unordered_map<const llvm::Function*, BBEntryMap> bbMap;
+		/// Definitions and uses of instructions in all the entries.
+		std::unordered_map<const llvm::Instruction*, Definition*> _defMap;
+		std::unordered_map<const llvm::Instruction*, Use*> _useMap;
 		bool _trackFlagRegs = false;
 		const llvm::GlobalVariable* _specialGlobal = nullptr;
 		bool _run = false;
@@ -193,11 +193,25 @@ class Decoder : public llvm::ModulePass
 				retdec::utils::Address from;
 				eType type;
 				cs_mode mode = CS_MODE_BIG_ENDIAN;
+				/// Order in which the target was pushed into JumpTargets.
+				std::size_t sequence = 0;
 
 			private:
 				mutable std::string name;
 		};
 
+		/**
+		 * Worklist of jump targets ordered by their type priority and
+		 * address.
+		 *
+		 * Targets are kept in a binary heap. A target equal (same type and
+		 * address) to an already pending one is ignored, the first pushed
+		 * one is used. Duplicates are removed lazily, when their first
+		 * occurrence is popped or when the targets are iterated.
+		 *
+		 * Popped addresses are kept in a bitmap over the address ranges
+		 * set by @c setPopedRanges(), other addresses in a set.
+		 */
 		class JumpTargets
 		{
 			friend std::ostream& operator<<(std::ostream &out, const JumpTargets& jts);
@@ -206,7 +220,7 @@ class Decoder : public llvm::ModulePass
 				{
 					if (jt.address.isDefined())
 					{
-						_data.insert(jt);
+						pushHeap(jt);
 					}
 				}
 
@@ -218,7 +232,7 @@ class Decoder : public llvm::ModulePass
 				{
 					if (a.isDefined())
 					{
-						_data.insert(JumpTarget(c, a, t, m));
+						pushHeap(JumpTarget(c, a, t, m));
 					}
 				}
 
@@ -231,7 +245,7 @@ class Decoder : public llvm::ModulePass
 				{
 					if (a.isDefined())
 					{
-						_data.insert(JumpTarget(c, a, t, m, f));
+						pushHeap(JumpTarget(c, a, t, m, f));
 					}
 				}
 
@@ -244,18 +258,22 @@ class Decoder : public llvm::ModulePass
 				{
 					if (a.isDefined())
 					{
-						_data.insert(JumpTarget(c, a, t, m, retdec::utils::Address::getUndef, name));
+						pushHeap(JumpTarget(c, a, t, m, retdec::utils::Address::getUndef, name));
 					}
 				}
 
 				std::size_t size() const
 				{
+					removeDuplicates();
 					return _data.size();
 				}
 
 				void clear()
 				{
 					_data.clear();
+					_popedBits.clear();
+					_popedRanges.clear();
+					_popedOther.clear();
 				}
 
 				bool empty()
@@ -265,32 +283,57 @@ class Decoder : public llvm::ModulePass
 
 				const JumpTarget& top()
 				{
-					return *_data.begin();
+					return _data.front();
 				}
 
-				void pop()
+				void pop();
+				bool wasAlreadyPoped(JumpTarget& ct) const;
+				void setPopedRanges(
+						const retdec::utils::AddressRangeContainer& ranges1,
+						const retdec::utils::AddressRangeContainer& ranges2);
+
+				/// Iteration in the order of popping, without duplicates.
+				std::vector<JumpTarget>::const_iterator begin() const
 				{
-					_poped.insert(top().address);
-					_data.erase(top());
+					removeDuplicates();
+					return _data.begin();
 				}
-
-				bool wasAlreadyPoped(JumpTarget& ct) const
+				std::vector<JumpTarget>::const_iterator end() const
 				{
-					return _poped.count(ct.address);
+					return _data.end();
 				}
 
-				auto begin()
+			private:
+				/// Heap comparator, the first target to pop is on the top.
+				static bool isPopedLater(const JumpTarget& a, const JumpTarget& b)
 				{
-					return _data.begin();
+					if (b < a) return true;
+					if (a < b) return false;
+					return a.sequence > b.sequence;
 				}
-				auto end()
+
+				static bool isSameTarget(const JumpTarget& a, const JumpTarget& b)
 				{
-					return _data.end();
+					return !(a < b) && !(b < a);
 				}
 
-			public:
-				std::set<JumpTarget> _data;
-				std::set<retdec::utils::Address> _poped;
+				void pushHeap(const JumpTarget& jt);
+				void removeDuplicates() const;
+				void setPoped(retdec::utils::Address a);
+				const std::pair<retdec::utils::AddressRange, std::size_t>* getPopedRange(
+						retdec::utils::Address a) const;
+
+			private:
+				/// Heap of pending targets. Sorted vector is a valid heap,
+				/// so it can be sorted for iteration.
+				mutable std::vector<JumpTarget> _data;
+				std::size_t _pushed = 0;
+
+				/// Ranges covered by @c _popedBits and index of their first bit.
+				std::vector<std::pair<retdec::utils::AddressRange, std::size_t>> _popedRanges;
+				std::vector<bool> _popedBits;
+				/// Popped addresses outside of @c _popedRanges.
+				std::set<retdec::utils::Address> _popedOther;
 		};
 
 	private:
@@ -310,9 +353,14 @@ class Decoder : public llvm::ModulePass
 		void initJumpTargets();
 		void initJumpTargetsWithStaticCode();
 		void removeZeroSequences(retdec::utils::AddressRangeContainer& rs);
+		void initDecodedInstructionCache();
+		void freeDecodedInstructionCache();
 
 		void doDecoding();
 		bool looksLikeValidJumpTarget(retdec::utils::Address addr);
+		std::size_t countDecodableInstructions(
+				retdec::utils::Address addr,
+				std::size_t size);
 
 		void doStaticCodeRecognition();
 
@@ -326,6 +374,7 @@ class Decoder : public llvm::ModulePass
 				int ord);
 		bool loadOrds(const std::string& libName);
 		void removeStaticallyLinkedFunctions();
+		bool isProtectedStaticallyLinkedFunction(const std::string& name) const;
 		void hackDeleteKnownLinkedFunctions();
 
 		void fixMipsDelaySlots();
@@ -341,6 +390,7 @@ class Decoder : public llvm::ModulePass
 		DebugFormat* _debug = nullptr;
 
 		std::unique_ptr<capstone2llvmir::Capstone2LlvmIrTranslator> _c2l;
+		std::unique_ptr<capstone2llvmir::DecodedInstructionCache> _decodedInsns;
 
 		const std::string _asm2llvmGv = "_asm_program_counter";
 		const std::string _asm2llvmMd = "llvmToAsmGlobalVariableName";
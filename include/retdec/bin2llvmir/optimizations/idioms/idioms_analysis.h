@@ -7,7 +7,9 @@
 #ifndef RETDEC_BIN2LLVMIR_OPTIMIZATIONS_IDIOMS_IDIOMS_ANALYSIS_H
 #define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_IDIOMS_IDIOMS_ANALYSIS_H
 
+#include <bitset>
 #include <cstdio>
+#include <initializer_list>
 
 #include <llvm/ADT/Statistic.h>
 #include <llvm/IR/BasicBlock.h>
@@ -53,11 +55,15 @@ public:
 
 private:
 	bool analyse(llvm::Function & f, llvm::Pass * p, int (IdiomsAnalysis::*exchanger)(llvm::Function &, llvm::Pass *) const, const char * fname);
-	bool analyse(llvm::BasicBlock & bb, llvm::Instruction * (IdiomsAnalysis::*exchanger)(llvm::BasicBlock::iterator) const, const char * fname);
+	bool analyse(llvm::BasicBlock & bb, std::initializer_list<unsigned> opcodes, llvm::Instruction * (IdiomsAnalysis::*exchanger)(llvm::BasicBlock::iterator) const, const char * fname);
+	void collectOpcodes(llvm::BasicBlock & bb);
 
 	void print_dbg(const char * str, const llvm::Instruction & i) const {
 		DEBUG(llvm::errs() << str << " detected an idiom starting at " << i.getName() << "\n");
 	}
+
+	/// Opcodes of instructions in the analysed BasicBlock.
+	std::bitset<llvm::Instruction::OtherOpsEnd> bb_opcodes;
 };
 
 } // namespace bin2llvmir
@@ -166,7 +166,7 @@ class ParamReturn : public llvm::ModulePass
 		Lti* _lti = nullptr;
 
 		std::map<llvm::Value*, DataFlowEntry> _fnc2calls;
-		ReachingDefinitionsAnalysis _RDA;
+		ReachingDefinitionsAnalysis* _RDA = nullptr;
 };
 
 } // namespace bin2llvmir
@@ -7,12 +7,14 @@
 #ifndef RETDEC_BIN2LLVMIR_OPTIMIZATIONS_SIMPLE_TYPES_SIMPLE_TYPES_H
 #define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_SIMPLE_TYPES_SIMPLE_TYPES_H
 
+#include <deque>
 #include <functional>
 #include <list>
 #include <map>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Module.h>
@@ -122,9 +124,11 @@ struct EquationEntryHash
 	std::size_t operator() (const EquationEntry& e) const { return e.hash(); }
 };
 
-using ValueEntrySet = std::unordered_set<ValueEntry, ValueEntryHash>;
-using TypeEntrySet = std::unordered_set<TypeEntry, TypeEntryHash>;
-using EquationEntrySet = std::unordered_set<EquationEntry, EquationEntryHash>;
+/// Entries of sets are kept in insertion order in vectors. Sets are small
+/// and there are many of them, hash sets would need much more memory.
+using ValueEntrySet = std::vector<ValueEntry>;
+using TypeEntrySet = std::vector<TypeEntry>;
+using EquationEntrySet = std::vector<EquationEntry>;
 
 /**
  * Equivalence set -- object in set have to same type.
@@ -133,8 +137,10 @@ class EqSet
 {
 	public:
 		EqSet();
+		/// @a v must not be in any set yet, duplicates are not checked.
 		void insert(Config* config, llvm::Value* v, eSourcePriority p = eSourcePriority::PRIORITY_NONE);
 		void insert(llvm::Type* t, eSourcePriority p = eSourcePriority::PRIORITY_NONE);
+		void insert(const EquationEntry& e);
 		void propagate(llvm::Module* module);
 		void apply(
 				llvm::Module* module,
@@ -162,7 +168,8 @@ class EqSet
 
 		/// Type of an entire equivalence set.
 		TypeEntry masterType;
-		/// Values in the set.
+		/// Values in the set. Each value is in at most one set, so it is
+		/// inserted only once.
 		ValueEntrySet valSet;
 		/// This allows to add certain types to set without having a value for them.
 		TypeEntrySet typeSet;
@@ -178,6 +185,7 @@ class EqSetContainer
 {
 	public:
 		EqSet& createEmptySet();
+		void removeLastSet();
 		void propagate(llvm::Module* module);
 		void apply(
 				llvm::Module* module,
@@ -188,7 +196,9 @@ class EqSetContainer
 		friend std::ostream& operator<<(std::ostream& out, const EqSetContainer& eqs);
 
 	public:
-		std::list<EqSet> eqSets;
+		/// Sets are added and removed only at the end, references to them
+		/// stay valid.
+		std::deque<EqSet> eqSets;
 };
 
 using ValueMap = std::unordered_map<llvm::Value*, EqSet*>;
@@ -206,8 +216,10 @@ class SimpleTypesAnalysis : public llvm::ModulePass
 
 		virtual bool runOnModule(llvm::Module& m) override;
 		virtual void getAnalysisUsage(llvm::AnalysisUsage& AU) const override;
+		bool runOnModuleCustom(llvm::Module& M, Config* c, FileImage* o);
 
 	private:
+		bool run(llvm::Module& M, bool first);
 		void buildEqSets(llvm::Module& M);
 		void buildEquations();
 		void processRoot(llvm::Value* root);
@@ -221,7 +233,7 @@ class SimpleTypesAnalysis : public llvm::ModulePass
 		EqSetContainer eqSets;
 		ValuePairList val2PtrVal;
 
-		ReachingDefinitionsAnalysis RDA;
+		ReachingDefinitionsAnalysis* RDA = nullptr;
 		llvm::Module* module = nullptr;
 		const llvm::GlobalVariable* _specialGlobal = nullptr;
 		Config* config = nullptr;
@@ -0,0 +1,74 @@
+/**
+ * @file include/retdec/bin2llvmir/providers/analyses.h
+ * @brief Analyses provider for bin2llvmirl.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_BIN2LLVMIR_PROVIDERS_ANALYSES_H
+#define RETDEC_BIN2LLVMIR_PROVIDERS_ANALYSES_H
+
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+
+#include "retdec/bin2llvmir/analyses/reaching_definitions.h"
+#include "retdec/bin2llvmir/providers/config.h"
+
+namespace retdec {
+namespace bin2llvmir {
+
+/**
+ * Completely static object -- all members and methods are static -> it can be
+ * used by anywhere in bin2llvmirl. It provides analyses results associated
+ * with modules, which are shared by all the passes that ask for them.
+ *
+ * Results are computed when they are asked for the first time. Every other
+ * request recomputes them only for functions that were changed (or added)
+ * since the last request. Changes are detected by a fingerprint of all the
+ * function's parts the analysis depends on, so passes do not need to report
+ * which functions they modified.
+ *
+ * @attention Results are up to date only right after they are returned. If
+ * a pass modifies the module, it must ask for them again to get them updated.
+ */
+class AnalysesProvider
+{
+	public:
+		static ReachingDefinitionsAnalysis* getReachingDefinitions(
+				llvm::Module* m,
+				Config* c,
+				bool trackFlagRegs = false);
+
+		static void clear();
+
+	private:
+		/// Sequence of function parts reaching definitions depend on.
+		using Fingerprint = std::vector<std::uintptr_t>;
+
+		/// Reaching definitions of a module and fingerprints of functions
+		/// they were computed for.
+		struct CachedReachingDefinitions
+		{
+			ReachingDefinitionsAnalysis rda;
+			std::unordered_map<const llvm::Function*, Fingerprint> fingerprints;
+		};
+
+		static Fingerprint getReachingDefinitionsFingerprint(
+				const llvm::Function& f);
+
+	private:
+		using RdaKey = std::pair<llvm::Module*, bool>;
+		/// Mapping of modules and flag register tracking settings to
+		/// reaching definitions computed for them.
+		static std::map<RdaKey, CachedReachingDefinitions> _module2rda;
+};
+
+} // namespace bin2llvmir
+} // namespace retdec
+
+#endif
@@ -7,9 +7,13 @@
 #ifndef RETDEC_BIN2LLVMIR_PROVIDERS_ASM_INSTRUCTION_H
 #define RETDEC_BIN2LLVMIR_PROVIDERS_ASM_INSTRUCTION_H
 
+#include <set>
+#include <vector>
+
 #include <capstone/capstone.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Module.h>
+#include <llvm/IR/ValueHandle.h>
 
 #include "retdec/llvm-support/utils.h"
 #include "retdec/utils/address.h"
@@ -342,19 +346,64 @@ class AsmInstruction
 		static retdec::utils::Address getInstructionAddress(
 				llvm::Instruction* inst);
 		static bool isLlvmToAsmInstruction(const llvm::Value* inst);
+		static void registerLlvmToAsmInstruction(llvm::StoreInst* s);
 		static void clear();
 
 	private:
 		const llvm::GlobalVariable* getLlvmToAsmGlobalVariablePrivate(
 				llvm::Module* m) const;
 		bool isLlvmToAsmInstructionPrivate(llvm::Value* inst) const;
+		bool instructionsCanBeErased(
+				const std::set<llvm::LoadInst*>& reloadable);
+		std::set<llvm::LoadInst*> getReloadableLoads();
+		void reloadGlobalsUsedByOthers(
+				const std::set<llvm::LoadInst*>& reloadable);
 
 	private:
 		using ModuleGlobalPair = std::pair<const llvm::Module*, const llvm::GlobalVariable*>;
 
+		/**
+		 * Address-indexed table of special LLVM to ASM mapping instructions
+		 * of one module.
+		 *
+		 * Addresses are covered by flat vectors of slots, each holding
+		 * an index (plus one) into @c markers, or zero if there is no
+		 * instruction at the address. Markers are held by weak value handles,
+		 * so instructions erased from the module drop out of the table.
+		 */
+		struct InstructionTable
+		{
+			/// Continuous addresses starting at @c start.
+			struct Range
+			{
+				retdec::utils::Address start;
+				std::vector<unsigned> slots;
+			};
+
+			const llvm::Module* module = nullptr;
+			/// Ranges sorted by their starts.
+			std::vector<Range> ranges;
+			std::vector<llvm::WeakVH> markers;
+		};
+
+	private:
+		static InstructionTable* getInstructionTable(const llvm::Module* m);
+		static llvm::StoreInst* findInInstructionTable(
+				const llvm::Module* m,
+				retdec::utils::Address addr);
+		static void addToInstructionTable(
+				InstructionTable& t,
+				llvm::StoreInst* s,
+				retdec::utils::Address addr);
+		static unsigned* getInstructionTableSlot(
+				InstructionTable& t,
+				retdec::utils::Address addr,
+				bool create);
+
 	private:
 		llvm::StoreInst* _llvmToAsmInstr = nullptr;
 		static std::vector<ModuleGlobalPair> _cache;
+		static std::vector<InstructionTable> _tables;
 };
 
 } // namespace bin2llvmir
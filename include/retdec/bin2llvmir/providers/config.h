@@ -28,6 +28,7 @@ class Config
 
 	public:
 		retdec::config::Config& getConfig();
+		const std::string& getConfigPath() const;
 
 		// Function
 		//
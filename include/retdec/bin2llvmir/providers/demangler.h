@@ -8,6 +8,7 @@
 #define RETDEC_BIN2LLVMIR_PROVIDERS_DEMANGLER_H
 
 #include <map>
+#include <memory>
 
 #include <llvm/IR/Module.h>
 
@@ -41,10 +42,26 @@ class DemanglerProvider
 
 		static void clear();
 
+		static void preloadDemanglers();
+
+	private:
+		enum class DemanglerKind
+		{
+			GCC,
+			MS,
+			BORLAND
+		};
+
+		static retdec::demangler::CDemangler* getDemangler(DemanglerKind k);
+
 	private:
 		using Demangler = std::unique_ptr<retdec::demangler::CDemangler>;
 		/// Mapping of modules to demanglers associated with them.
-		static std::map<llvm::Module*, Demangler> _module2demangler;
+		static std::map<llvm::Module*, retdec::demangler::CDemangler*>
+				_module2demangler;
+		/// Demanglers shared by all the modules. Instantiation of demangler
+		/// grammars is expensive, so every kind is created only once.
+		static std::map<DemanglerKind, Demangler> _demanglers;
 };
 
 } // namespace bin2llvmir
@@ -7,6 +7,11 @@
 #ifndef RETDEC_BIN2LLVMIR_PROVIDERS_LTI_H
 #define RETDEC_BIN2LLVMIR_PROVIDERS_LTI_H
 
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include <llvm/IR/Module.h>
 
 #include "retdec/ctypes/context.h"
@@ -79,6 +84,12 @@ class Lti
 		FunctionPair getPairFunction(const std::string& name);
 		llvm::Function* getLlvmFunction(const std::string& name);
 
+	public:
+		static std::shared_ptr<retdec::ctypes::Module> getLtiFile(
+				const std::string& filePath,
+				unsigned defaultBitWidth);
+		static void clearCache();
+
 	private:
 		void loadLtiFile(const std::string& filePath);
 		llvm::Type* getLlvmType(std::shared_ptr<retdec::ctypes::Type> type);
@@ -87,8 +98,16 @@ class Lti
 		llvm::Module* _module = nullptr;
 		Config* _config = nullptr;
 		retdec::loader::Image* _image = nullptr;
-		std::unique_ptr<retdec::ctypes::Module> _ltiModule;
-		ctypesparser::JSONCTypesParser _ltiParser;
+		/// Loaded LTI files in the order of their loading.
+		std::vector<std::shared_ptr<retdec::ctypes::Module>> _ltiModules;
+
+	private:
+		using LtiFileKey = std::pair<std::string, unsigned>;
+		/// Parsed LTI files shared by all the modules in the process.
+		/// LTI files are immutable, so there is no need to parse them for
+		/// each module again.
+		static std::map<LtiFileKey, std::shared_ptr<retdec::ctypes::Module>>
+				_ltiFileCache;
 };
 
 class LtiProvider
@@ -83,6 +83,12 @@ llvm::Argument* modifyFunctionArgumentType(
 		llvm::Argument* arg,
 		llvm::Type* type);
 
+bool isStoredBetween(
+		const llvm::Value* ptr,
+		llvm::BasicBlock::iterator first,
+		llvm::BasicBlock::iterator last);
+void reloadGlobalsAfterSplit(llvm::BasicBlock* oldBb, llvm::BasicBlock* newBb);
+
 llvm::Function* splitFunctionOn(
 		llvm::Instruction* inst,
 		const std::string& fncName = "");
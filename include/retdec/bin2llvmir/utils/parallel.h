@@ -0,0 +1,24 @@
+/**
+* @file include/retdec/bin2llvmir/utils/parallel.h
+* @brief Running independent tasks on several threads.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_BIN2LLVMIR_UTILS_PARALLEL_H
+#define RETDEC_BIN2LLVMIR_UTILS_PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+
+namespace retdec {
+namespace bin2llvmir {
+
+void runInParallel(
+		std::size_t n,
+		const std::function<void(std::size_t)>& task,
+		std::size_t threads = 0);
+
+} // namespace bin2llvmir
+} // namespace retdec
+
+#endif
@@ -9,6 +9,7 @@
 
 #include "retdec/capstone2llvmir/arm/arm_defs.h"
 #include "retdec/capstone2llvmir/capstone2llvmir.h"
+#include "retdec/capstone2llvmir/dispatch_table.h"
 
 namespace retdec {
 namespace capstone2llvmir {
@@ -168,9 +169,11 @@ class Capstone2LlvmIrTranslatorArm : public Capstone2LlvmIrTranslator
 				llvm::Value* n);
 
 	protected:
-		static std::map<
-			std::size_t,
-			void (Capstone2LlvmIrTranslatorArm::*)(cs_insn* i, cs_arm*, llvm::IRBuilder<>&)> _i2fm;
+		using TranslationFunction = void (Capstone2LlvmIrTranslatorArm::*)(
+				cs_insn* i,
+				cs_arm*,
+				llvm::IRBuilder<>&);
+		static const DispatchTable<TranslationFunction, ARM_INS_ENDING> _i2fm;
 
 		// These are used to save lines needed to declare locale operands in
 		// each translation function.
@@ -16,9 +16,11 @@
 #include <llvm/IR/Instruction.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Module.h>
+#include <llvm/IR/ValueHandle.h>
 #include <llvm/Support/raw_ostream.h>
 
 #include "retdec/utils/address.h"
+#include "retdec/capstone2llvmir/decoded_instruction_cache.h"
 #include "retdec/capstone2llvmir/exceptions.h"
 
 namespace retdec {
@@ -160,6 +162,22 @@ class Capstone2LlvmIrTranslator
 				llvm::IRBuilder<>& irb,
 				bool stopOnBranch = false);
 
+	// Translation settings.
+	//
+	public:
+		void setRegisterLoadCaching(bool b);
+		bool isRegisterLoadCaching() const;
+
+	// Disassembly methods.
+	//
+	public:
+		void setDecodedInstructionCache(const DecodedInstructionCache* cache);
+		bool disasmIter(
+				const uint8_t** code,
+				size_t* size,
+				uint64_t* address,
+				cs_insn* insn);
+
 	// Public pure virtual methods that must be implemented in concrete classes.
 	//
 	public:
@@ -339,6 +357,11 @@ class Capstone2LlvmIrTranslator
 
 		llvm::Value* genValueNegate(llvm::IRBuilder<>& irb, llvm::Value* val);
 
+		void reuseRegisterLoads(
+				llvm::BasicBlock* bb,
+				llvm::Instruction* prev,
+				llvm::IRBuilder<>& irb);
+
 	// Translation helper methods.
 	//
 	protected:
@@ -376,6 +399,16 @@ class Capstone2LlvmIrTranslator
 		cs_mode _basicMode = CS_MODE_LITTLE_ENDIAN;
 		cs_mode _extraMode = CS_MODE_LITTLE_ENDIAN;
 
+		/// Instructions disassembled in advance, or @c nullptr.
+		const DecodedInstructionCache* _decodedInsns = nullptr;
+
+		/// If @c true, registers loaded by previous instructions of the same
+		/// basic block are not loaded again until they are stored.
+		bool _registerLoadCaching = false;
+		/// The last load of each register in the current basic block that
+		/// can be reused. Handles become null if loads are erased.
+		std::map<llvm::GlobalVariable*, llvm::WeakVH> _registerLoads;
+
 		llvm::Module* _module = nullptr;
 		llvm::GlobalVariable* _asm2llvmGv = nullptr;
 		llvm::Function* _callFunction = nullptr; // void (i<arch_sz>)
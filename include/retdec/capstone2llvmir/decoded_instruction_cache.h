@@ -0,0 +1,111 @@
+/**
+ * @file include/retdec/capstone2llvmir/decoded_instruction_cache.h
+ * @brief Instructions disassembled in advance by several threads.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_CAPSTONE2LLVMIR_DECODED_INSTRUCTION_CACHE_H
+#define RETDEC_CAPSTONE2LLVMIR_DECODED_INSTRUCTION_CACHE_H
+
+#include <cstdint>
+#include <vector>
+
+#include <capstone/capstone.h>
+
+#include "retdec/utils/address.h"
+
+namespace retdec {
+namespace capstone2llvmir {
+
+/**
+ * Address-indexed cache of instructions disassembled in advance.
+ *
+ * Added ranges of bytes are split into chunks, which are disassembled
+ * linearly in parallel, each worker thread with its own Capstone handle.
+ * Translators and other users then take instructions from the cache with
+ * @c disasmIter(), which behaves as @c cs_disasm_iter() but returns @c false
+ * if the instruction is not in the cache. Users fall back to Capstone in
+ * such a case. The result is therefore the same as if no cache was used.
+ *
+ * Only details of the used operands are kept for each instruction, so the
+ * cache takes only a fraction of the memory of the same number of
+ * @c cs_insn structures.
+ */
+class DecodedInstructionCache
+{
+	public:
+		DecodedInstructionCache(cs_arch a, cs_mode basic, cs_mode extra);
+
+		/// @name Decoding
+		/// @{
+		void addRange(
+				retdec::utils::Address start,
+				std::vector<uint8_t>&& bytes);
+		void decode(std::size_t threads = 0);
+		/// @}
+
+		/// @name Queries
+		/// @{
+		cs_arch getArchitecture() const;
+		cs_mode getBasicMode() const;
+		cs_mode getExtraMode() const;
+		std::size_t size() const;
+		bool disasmIter(
+				const uint8_t** code,
+				size_t* size,
+				uint64_t* address,
+				cs_insn* insn) const;
+		/// @}
+
+	private:
+		/// Bytes to disassemble.
+		struct Range
+		{
+			retdec::utils::Address start;
+			std::vector<uint8_t> bytes;
+		};
+
+		/// Part of a range disassembled by one worker.
+		struct Chunk
+		{
+			const Range* range = nullptr;
+			/// Offset of the first byte of the chunk in the range.
+			std::size_t begin = 0;
+			/// Offset behind the last byte of the chunk in the range.
+			std::size_t end = 0;
+			/// Serialized instructions starting in the chunk.
+			std::vector<uint8_t> records;
+			/// Addresses of the instructions and offsets of their records.
+			std::vector<std::pair<uint64_t, std::size_t>> offsets;
+		};
+
+		/// Position of an instruction record.
+		struct Entry
+		{
+			uint64_t address;
+			const Chunk* chunk;
+			std::size_t offset;
+		};
+
+	private:
+		void decodeChunk(csh handle, cs_insn* insn, Chunk& chunk) const;
+		void storeInstruction(const cs_insn* insn, Chunk& chunk) const;
+		void loadInstruction(const Entry& entry, cs_insn* insn) const;
+		std::size_t getMinInstructionSize() const;
+		std::size_t getUsedDetailSize(const cs_detail* detail) const;
+
+	private:
+		cs_arch _arch;
+		cs_mode _basicMode;
+		cs_mode _extraMode;
+
+		std::vector<Range> _ranges;
+		std::vector<Chunk> _chunks;
+		/// Instructions sorted by their addresses.
+		std::vector<Entry> _entries;
+};
+
+} // namespace capstone2llvmir
+} // namespace retdec
+
+#endif
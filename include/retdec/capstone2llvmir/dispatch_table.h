@@ -0,0 +1,65 @@
+/**
+ * @file include/retdec/capstone2llvmir/dispatch_table.h
+ * @brief Dense table of instruction translation functions.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_CAPSTONE2LLVMIR_DISPATCH_TABLE_H
+#define RETDEC_CAPSTONE2LLVMIR_DISPATCH_TABLE_H
+
+#include <cstddef>
+#include <initializer_list>
+
+namespace retdec {
+namespace capstone2llvmir {
+
+/**
+ * Table of handlers (e.g. translation functions) indexed directly by Capstone
+ * instruction IDs from @c 0 to @c N - 1.
+ *
+ * The table is built by a @c constexpr constructor from a list of ID and
+ * handler pairs, so tables defined with constant initializers are filled in
+ * at compile time and a lookup is a single array load. IDs without a handler
+ * (or out of the table) are mapped to @c nullptr.
+ */
+template<typename Handler, std::size_t N>
+class DispatchTable
+{
+	public:
+		struct Entry
+		{
+			std::size_t id;
+			Handler handler;
+		};
+
+	public:
+		constexpr DispatchTable(std::initializer_list<Entry> entries) :
+				_handlers()
+		{
+			for (const Entry& e : entries)
+			{
+				if (e.id < N)
+				{
+					_handlers[e.id] = e.handler;
+				}
+			}
+		}
+
+		constexpr Handler operator[](std::size_t id) const
+		{
+			return id < N ? _handlers[id] : nullptr;
+		}
+
+		constexpr std::size_t size() const
+		{
+			return N;
+		}
+
+	private:
+		Handler _handlers[N];
+};
+
+} // namespace capstone2llvmir
+} // namespace retdec
+
+#endif
@@ -8,6 +8,7 @@
 #define RETDEC_CAPSTONE2LLVMIR_MIPS_MIPS_H
 
 #include "retdec/capstone2llvmir/capstone2llvmir.h"
+#include "retdec/capstone2llvmir/dispatch_table.h"
 #include "retdec/capstone2llvmir/mips/mips_defs.h"
 
 namespace retdec {
@@ -111,9 +112,11 @@ class Capstone2LlvmIrTranslatorMips : public Capstone2LlvmIrTranslator
 		bool isFpInstructionVariant(cs_insn* i);
 
 	protected:
-		static std::map<
-			std::size_t,
-			void (Capstone2LlvmIrTranslatorMips::*)(cs_insn* i, cs_mips*, llvm::IRBuilder<>&)> _i2fm;
+		using TranslationFunction = void (Capstone2LlvmIrTranslatorMips::*)(
+				cs_insn* i,
+				cs_mips*,
+				llvm::IRBuilder<>&);
+		static const DispatchTable<TranslationFunction, MIPS_INS_ENDING> _i2fm;
 
 		// These are used to save lines needed to declare locale operands in
 		// each translation function.
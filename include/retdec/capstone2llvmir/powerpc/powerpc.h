@@ -8,6 +8,7 @@
 #define RETDEC_CAPSTONE2LLVMIR_POWERPC_POWERPC_H
 
 #include "retdec/capstone2llvmir/capstone2llvmir.h"
+#include "retdec/capstone2llvmir/dispatch_table.h"
 #include "retdec/capstone2llvmir/powerpc/powerpc_defs.h"
 
 namespace retdec {
@@ -133,9 +134,11 @@ class Capstone2LlvmIrTranslatorPowerpc : public Capstone2LlvmIrTranslator
 		bool isCrRegister(cs_ppc_op& op);
 
 	protected:
-		static std::map<
-			std::size_t,
-			void (Capstone2LlvmIrTranslatorPowerpc::*)(cs_insn* i, cs_ppc*, llvm::IRBuilder<>&)> _i2fm;
+		using TranslationFunction = void (Capstone2LlvmIrTranslatorPowerpc::*)(
+				cs_insn* i,
+				cs_ppc*,
+				llvm::IRBuilder<>&);
+		static const DispatchTable<TranslationFunction, PPC_INS_ENDING> _i2fm;
 
 		// These are used to save lines needed to declare locale operands in
 		// each translation function.
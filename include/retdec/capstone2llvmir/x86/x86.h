@@ -12,6 +12,7 @@
 #include <utility>
 
 #include "retdec/capstone2llvmir/capstone2llvmir.h"
+#include "retdec/capstone2llvmir/dispatch_table.h"
 #include "retdec/capstone2llvmir/x86/x86_defs.h"
 
 namespace retdec {
@@ -38,6 +39,12 @@ class Capstone2LlvmIrTranslatorX86 : public Capstone2LlvmIrTranslator
 		virtual uint32_t getArchByteSize() override;
 		virtual uint32_t getArchBitSize() override;
 
+		virtual TranslationResult translate(
+				const std::vector<uint8_t>& bytes,
+				retdec::utils::Address a,
+				llvm::IRBuilder<>& irb,
+				bool stopOnBranch = false) override;
+
 	public:
 		llvm::Function* getX87DataStoreFunction();
 		llvm::Function* getX87TagStoreFunction();
@@ -83,6 +90,12 @@ class Capstone2LlvmIrTranslatorX86 : public Capstone2LlvmIrTranslator
 
 		virtual llvm::Value* getCurrentPc(cs_insn* i);
 
+		bool isStatusFlagRegister(uint32_t r) const;
+		void removeOverwrittenFlagStores(
+				llvm::BasicBlock* bb,
+				llvm::Instruction* prev,
+				llvm::IRBuilder<>& irb);
+
 	protected:
 		cs_mode _origBasicMode = CS_MODE_LITTLE_ENDIAN;
 
@@ -99,10 +112,19 @@ class Capstone2LlvmIrTranslatorX86 : public Capstone2LlvmIrTranslator
 		/// map -- it will deal with added enums.
 		std::vector<uint32_t> _reg2parentMap;
 
-		/// Mapping of Capstone instruction IDs to their translation functions.
-		static std::map<
-			std::size_t,
-			void (Capstone2LlvmIrTranslatorX86::*)(cs_insn* i, cs_x86*, llvm::IRBuilder<>&)> _i2fm;
+		using TranslationFunction = void (Capstone2LlvmIrTranslatorX86::*)(
+				cs_insn* i,
+				cs_x86*,
+				llvm::IRBuilder<>&);
+		/// Mapping of Capstone instruction IDs to their translation functions,
+		/// filled in at compile time.
+		static const DispatchTable<TranslationFunction, X86_INS_ENDING> _i2fm;
+
+		/// Last stores to status flags in the current basic block that were
+		/// not read yet. If a flag is stored again before it is read (and
+		/// before any call or a new block), the previous store and the flag
+		/// computation used only by it are removed.
+		std::map<uint32_t, llvm::StoreInst*> _unreadFlagStores;
 
 
 	// Translation helper methods.
@@ -27,6 +27,7 @@ class Parameters
 		bool isVerboseOutput() const;
 		bool isKeepAllFunctions() const;
 		bool isSelectedDecodeOnly() const;
+		bool isSkipStaticCode() const;
 		bool isFrontendFunction(const std::string& funcName) const;
 		/// @}
 
@@ -35,6 +36,7 @@ class Parameters
 		void setIsVerboseOutput(bool b);
 		void setIsKeepAllFunctions(bool b);
 		void setIsSelectedDecodeOnly(bool b);
+		void setIsSkipStaticCode(bool b);
 		void setOutputFile(const std::string& n);
 		void setFrontendOutputFile(const std::string& n);
 		void setOrdinalNumbersDirectory(const std::string& n);
@@ -87,6 +89,11 @@ class Parameters
 		/// results.
 		bool _selectedDecodeOnly = false;
 
+		/// Do not decode functions detected as statically linked code.
+		/// Only their declarations are created.
+		/// This speeds up decompilation of binaries with a lot of library code.
+		bool _skipStaticCode = false;
+
 		std::string _outputFile;
 		std::string _frontendOutputFile;
 		std::string _ordinalNumbersDirectory;
@@ -7,6 +7,11 @@
 #ifndef RETDEC_CPDETECT_COMPILER_DETECTOR_HEURISTICS_HEURISTICS_H
 #define RETDEC_CPDETECT_COMPILER_DETECTOR_HEURISTICS_HEURISTICS_H
 
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
 #include "retdec/cpdetect/compiler_detector/search/search.h"
 #include "retdec/cpdetect/cptypes.h"
 #include "retdec/fileformat/file_format/file_format.h"
@@ -66,8 +71,13 @@ class Heuristics
 
 		std::vector<const retdec::fileformat::Section*> sections; ///< section information
 		std::map<std::string, std::size_t> sectionNameMap;        ///< section name counts
+		std::map<std::string, const retdec::fileformat::Section*> firstSectionMap; ///< first section with each name
 		std::size_t noOfSections;                                 ///< section count
 
+		std::set<std::string> importedLibraries;      ///< names of imported libraries
+		std::set<std::string> importedLibrariesLower; ///< lower-case names of imported libraries
+		std::set<std::string> exportNames;            ///< names of exported symbols
+
 		/**
 		 * If @c true original language is detected with high reliability.
 		 * This disables further detection of used programming languages.
@@ -129,6 +139,10 @@ class Heuristics
 		/// @{
 		std::size_t findSectionName(const std::string &sectionName) const;
 		std::size_t findSectionNameStart(const std::string &sectionName) const;
+		const retdec::fileformat::Section* getSectionByName(const std::string &sectionName) const;
+		bool hasImportedLibrary(const std::string &libraryName) const;
+		bool hasImportedLibraryCaseInsensitive(const std::string &libraryName) const;
+		bool hasExport(const std::string &exportName) const;
 		/// @}
 
 	public:
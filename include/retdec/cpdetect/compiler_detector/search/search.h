@@ -7,6 +7,13 @@
 #ifndef RETDEC_CPDETECT_COMPILER_DETECTOR_SEARCH_SEARCH_H
 #define RETDEC_CPDETECT_COMPILER_DETECTOR_SEARCH_SEARCH_H
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/StringRef.h>
+
 #include "retdec/cpdetect/cptypes.h"
 #include "retdec/fileformat/file_format/file_format.h"
 
@@ -38,20 +45,71 @@ class Search
 				std::size_t getBytesAfter() const;
 				/// @}
 		};
+
+		/**
+		 * Signature pattern compiled into values and masks of bytes
+		 *
+		 * Pattern is split by slashes into parts. Each part is stored both
+		 * aligned to the start of a byte and shifted by one nibble, so it can
+		 * be compared with raw bytes of file on any nibble offset.
+		 */
+		class SignaturePattern
+		{
+			public:
+				/**
+				 * Part of pattern between two slashes
+				 */
+				struct Part
+				{
+					std::size_t nibbles = 0;               ///< number of nibbles of part
+					std::vector<std::uint8_t> values[2];   ///< values of bytes (indexed by nibble shift)
+					std::vector<std::uint8_t> masks[2];    ///< masks of bytes (indexed by nibble shift)
+					std::size_t anchorStart[2] = {0, 0};   ///< start of the longest run of fixed bytes
+					std::size_t anchorSize[2] = {0, 0};    ///< size of the longest run of fixed bytes
+				};
+			private:
+				std::vector<Part> parts;  ///< parts of pattern separated by slashes
+				std::size_t length;       ///< length of pattern in nibbles (slash is one nibble)
+				std::size_t fixedNibbles; ///< number of nibbles which are not wildcards
+				bool valid;               ///< @c true if pattern contains only supported characters
+			public:
+				SignaturePattern(const std::string &pattern);
+				~SignaturePattern();
+
+				/// @name Pattern getters
+				/// @{
+				const std::vector<Part>& getParts() const;
+				std::size_t getLength() const;
+				std::size_t getNumberOfSlashes() const;
+				std::size_t getNumberOfFixedNibbles() const;
+				bool isValid() const;
+				/// @}
+		};
 	private:
-		retdec::fileformat::FileFormat &parser; ///< parser of input file
-		std::string nibbles;             ///< content of file in hexadecimal string representation
-		std::string plain;               ///< content of file as plain string
-		std::vector<RelativeJump> jumps; ///< representation of supported relative jumps
-		std::size_t averageSlashLen;     ///< average length of one slash representation
-		bool fileLoaded;                 ///< @c true if file was successfully loaded, @c false otherwise
-		bool fileSupported;              ///< @c true if search of patterns is supported for input file, @c false otherwise
+		retdec::fileformat::FileFormat &parser;    ///< parser of input file
+		llvm::ArrayRef<std::uint8_t> content;      ///< content of file in little endian
+		std::vector<std::uint8_t> swappedContent;  ///< content of big endian file converted to little endian
+		llvm::StringRef plain;                     ///< content of file as plain string
+		mutable std::vector<std::uint64_t> trigrams; ///< presence of each 3-byte sequence in file
+		mutable bool trigramsBuilt;                ///< @c true if index of 3-byte sequences was built
+		std::vector<RelativeJump> jumps;           ///< representation of supported relative jumps
+		std::size_t averageSlashLen;               ///< average length of one slash representation
+		bool fileLoaded;                           ///< @c true if file was successfully loaded, @c false otherwise
+		bool fileSupported;                        ///< @c true if search of patterns is supported for input file, @c false otherwise
 
 		/// @name Auxiliary methods
 		/// @{
+		bool loadLittleEndianContent();
 		bool haveSlashes() const;
 		std::size_t nibblesFromBytes(std::size_t nBytes) const;
 		std::size_t bytesFromNibbles(std::size_t nNibbles) const;
+		std::size_t getNumberOfNibbles() const;
+		char getNibble(std::size_t nibbleOffset) const;
+		bool matchesPart(const SignaturePattern::Part &part, std::size_t nibbleOffset) const;
+		bool matchesSignature(const SignaturePattern &signature, std::size_t nibbleOffset) const;
+		bool findSignature(const SignaturePattern &signature, std::size_t firstNibble, std::size_t lastNibble) const;
+		void buildTrigramIndex() const;
+		bool mayContainString(const std::string &str, std::size_t areaSize) const;
 		/// @}
 	public:
 		Search(retdec::fileformat::FileFormat &fileParser);
@@ -65,8 +123,7 @@ class Search
 
 		/// @name Getters
 		/// @{
-		const std::string& getNibbles() const;
-		const std::string& getPlainString() const;
+		llvm::StringRef getPlainString() const;
 		/// @}
 
 		/// @name Jump methods
@@ -77,15 +134,20 @@ class Search
 		/// @name Search methods based on signatures
 		/// @{
 		unsigned long long countImpNibbles(const std::string &signPattern) const;
+		unsigned long long countImpNibbles(const SignaturePattern &signature) const;
 		unsigned long long findUnslashedSignature(const std::string &signPattern, std::size_t startOffset, std::size_t stopOffset) const;
+		unsigned long long findUnslashedSignature(const SignaturePattern &signature, std::size_t startOffset, std::size_t stopOffset) const;
 		unsigned long long findSlashedSignature(const std::string &signPattern, std::size_t startOffset, std::size_t stopOffset) const;
+		unsigned long long findSlashedSignature(const SignaturePattern &signature, std::size_t startOffset, std::size_t stopOffset) const;
 		unsigned long long exactComparison(const std::string &signPattern, std::size_t fileOffset, std::size_t shift = 0) const;
+		unsigned long long exactComparison(const SignaturePattern &signature, std::size_t fileOffset, std::size_t shift = 0) const;
 		bool countSimilarity(const std::string &signPattern, Similarity &sim, std::size_t fileOffset, std::size_t shift = 0) const;
 		bool areaSimilarity(const std::string &signPattern, Similarity &sim, std::size_t startOffset, std::size_t stopOffset) const;
 		/// @}
 
 		/// @name Search methods based on plain-string comparison
 		/// @{
+		std::size_t findString(const std::string &str, std::size_t startOffset = 0) const;
 		bool hasString(const std::string &str) const;
 		bool hasString(const std::string &str, std::size_t fileOffset) const;
 		bool hasString(const std::string &str, std::size_t startOffset, std::size_t stopOffset) const;
@@ -67,7 +67,9 @@ enum LoadFlags
 	NONE              = 0,
 	NO_FILE_HASHES    = 1,
 	NO_VERBOSE_HASHES = 2,
-	DETECT_STRINGS    = 4
+	DETECT_STRINGS    = 4,
+	LAZY_LOAD         = 8, ///< load expensive components (resources, certificates, ...) on first access
+	PARALLEL_HASHES   = 16 ///< hash sections and segments on all hardware threads
 };
 
 } // namespace fileformat
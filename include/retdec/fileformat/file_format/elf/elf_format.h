@@ -45,6 +45,7 @@ class ElfFormat : public FileFormat
 		/// @name Virtual initialization methods
 		/// @{
 		virtual std::size_t initSectionTableHashOffsets() override;
+		virtual void loadComponent(Component component) override;
 		/// @}
 
 		/// @name Auxiliary methods
@@ -10,9 +10,13 @@
 #include <fstream>
 #include <initializer_list>
 #include <map>
+#include <memory>
 #include <set>
 #include <vector>
 
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/Support/MemoryBuffer.h>
+
 #include "retdec/config/config.h"
 #include "retdec/utils/byte_value_storage.h"
 #include "retdec/utils/non_copyable.h"
@@ -41,13 +45,17 @@ struct LoaderErrorInfo
 class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils::NonCopyable
 {
 	private:
-		std::ifstream auxStream;                 ///< auxiliary member for opening of input file
-		std::vector<unsigned char> *loadedBytes; ///< reference to serialized content of input file
-		LoadFlags loadFlags;                     ///< load flags for configurable file loading
+		std::ifstream auxStream;                     ///< auxiliary member for opening of input file
+		std::unique_ptr<llvm::MemoryBuffer> fileBuffer; ///< read-only (usually memory-mapped) content of input file
+		std::vector<unsigned char> streamBytes;      ///< content of input stream (if not read from file)
+		llvm::ArrayRef<unsigned char> loadedBytes;   ///< serialized content of input file
+		LoadFlags loadFlags;                         ///< load flags for configurable file loading
+		mutable std::uint32_t deferredComponents;    ///< components whose loading is postponed until their first use
 
 		/// @name Initialization methods
 		/// @{
 		void init();
+		bool loadBytes();
 		void initStream();
 		template<typename T> void initFormatArch(T derivedPtr, const retdec::config::Architecture &arch);
 		/// @}
@@ -70,7 +78,7 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		std::vector<SymbolTable*> symbolTables;                           ///< symbol tables
 		std::vector<RelocationTable*> relocationTables;                   ///< relocation tables
 		std::vector<DynamicTable*> dynamicTables;                         ///< tables with dynamic records
-		std::vector<unsigned char> bytes;                                 ///< content of file as bytes
+		llvm::ArrayRef<unsigned char> bytes;                              ///< content of file as bytes
 		std::vector<String> strings;                                      ///< detected strings
 		std::vector<ElfNoteSecSeg> noteSecSegs;                           ///< note sections or segemnts found in ELF file
 		std::set<std::uint64_t> unknownRelocs;                            ///< unknown relocations
@@ -97,6 +105,24 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		/// @name Protected detection methods
 		/// @{
 		void computeSectionTableHashes();
+		void computeSecSegHashes();
+		/// @}
+
+		/// @name Lazy loading of components
+		/// @{
+		/// Components which are expensive to load and which are not needed
+		/// by all the users of the file format.
+		enum Component
+		{
+			COMPONENT_RICH_HEADER  = 1,
+			COMPONENT_RESOURCES    = 2,
+			COMPONENT_CERTIFICATES = 4,
+			COMPONENT_DOTNET       = 8,
+			COMPONENT_NOTES        = 16
+		};
+		void loadOrDeferComponent(Component component);
+		void loadDeferredComponent(Component component) const;
+		virtual void loadComponent(Component component);
 		/// @}
 
 		/// @name Setters
@@ -246,8 +272,8 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		const std::vector<SymbolTable*>& getSymbolTables() const;
 		const std::vector<RelocationTable*>& getRelocationTables() const;
 		const std::vector<DynamicTable*>& getDynamicTables() const;
-		const std::vector<unsigned char>& getBytes() const;
-		const std::vector<unsigned char>& getLoadedBytes() const;
+		llvm::ArrayRef<unsigned char> getBytes() const;
+		llvm::ArrayRef<unsigned char> getLoadedBytes() const;
 		const unsigned char* getBytesData() const;
 		const unsigned char* getLoadedBytesData() const;
 		const std::vector<String>& getStrings() const;
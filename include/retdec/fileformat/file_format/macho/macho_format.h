@@ -34,7 +34,6 @@ class MachOFormat : public FileFormat
 		unsigned long long entryPointOffset = 0;                       ///< entry point offset
 		std::uint32_t chosenArchOffset = 0;                            ///< offset of chosen architecture from universal binary
 		std::uint32_t chosenArchSize = 0;                              ///< size of chosen architecture from universal binary
-		std::vector<std::uint8_t> chosenArchBytes;                     ///< bytes of chosen architecture from universal binary
 		std::size_t sectionCounter = 0;                                ///< number of segment commands found
 		std::size_t segmentCounter = 0;                                ///< number of section commands found
 		std::vector<MachOSymbol> symbols;                              ///< temporary symbol representation
@@ -51,6 +51,7 @@ class PeFormat : public FileFormat
 		/// @name Virtual initialization methods
 		/// @{
 		virtual std::size_t initSectionTableHashOffsets() override;
+		virtual void loadComponent(Component component) override;
 		/// @}
 
 		/// @name Auxiliary methods
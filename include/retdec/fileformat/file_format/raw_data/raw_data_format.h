@@ -8,6 +8,7 @@
 #define RETDEC_FILEFORMAT_FILE_FORMAT_RAW_DATA_RAW_DATA_FORMAT_H
 
 #include <cassert>
+#include <vector>
 
 #include "retdec/utils/address.h"
 #include "retdec/fileformat/file_format/file_format.h"
@@ -35,6 +36,7 @@ class RawDataFormat : public FileFormat
 {
 	private:
 		Section *section = nullptr;
+		std::vector<unsigned char> appendedBytes; ///< content of file with appended data
 		std::string secName = ".data";
 		Section::Type secType = Section::Type::DATA;
 		bool hasEntryPoint = false;
@@ -112,7 +114,9 @@ class RawDataFormat : public FileFormat
 		 * @param d Data to append.
 		 * @return Address in memory where data were added.
 		 * @note Data are simply copied to the end of the first section's binary
-		 * data and to the end of file stream. The size of data is determined by
+		 * data. File content is copied to a buffer owned by this instance on
+		 * the first append, the data are appended there, and both serialized
+		 * and loaded bytes then refer to the buffer. The size of data is determined by
 		 * sizeof(), so keep this in mind when using it -- it is ok to append
 		 * C basic and composite types, but appending high-level abstract
 		 * C++ types (e.g. vectors) makes no sense and will not produce an
@@ -124,9 +128,14 @@ class RawDataFormat : public FileFormat
 			const auto *pd = reinterpret_cast<const unsigned char*>(&d);
 			assert(pd && "Invalid data");
 			assert(section && "Section must be initialized in constructor");
-			std::vector<unsigned char> aBytes(pd, pd + sizeof(d));
-			const auto pos = bytes.size();
-			bytes.insert(bytes.end(), aBytes.begin(), aBytes.end());
+			if (bytes.data() != appendedBytes.data())
+			{
+				appendedBytes.assign(bytes.begin(), bytes.end());
+			}
+			const auto pos = appendedBytes.size();
+			appendedBytes.insert(appendedBytes.end(), pd, pd + sizeof(d));
+			bytes = appendedBytes;
+			setLoadedBytes(&appendedBytes);
 			section->setSizeInFile(bytes.size());
 			section->setSizeInMemory(bytes.size());
 			section->load(this);
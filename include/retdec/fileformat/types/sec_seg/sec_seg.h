@@ -35,9 +35,9 @@ class SecSeg
 			INFO               ///< auxiliary information
 		};
 	private:
-		std::string crc32;                ///< CRC32 of section or segment data
-		std::string md5;                  ///< MD5 of section or segment data
-		std::string sha256;               ///< SHA256 of section or segment data
+		mutable std::string crc32;        ///< CRC32 of section or segment data
+		mutable std::string md5;          ///< MD5 of section or segment data
+		mutable std::string sha256;       ///< SHA256 of section or segment data
 		std::string name;                 ///< name of section or segment
 		llvm::StringRef bytes;            ///< reference to content of section or segment
 		Type type;                        ///< type
@@ -51,8 +51,9 @@ class SecSeg
 		bool entrySizeIsValid;            ///< size of one entry in section or segment
 		bool isInMemory;                  ///< @c true if the section or segment will appear in the memory image of a process
 		bool loaded;                      ///< @c true if content of section or segment was successfully loaded from input file
+		mutable bool hashesPending;       ///< @c true if hashes were requested but not computed yet
 
-		void computeHashes();
+		void computeHashes() const;
 	public:
 		SecSeg();
 		virtual ~SecSeg() = 0;
@@ -125,6 +126,7 @@ class SecSeg
 		void invalidateMemorySize();
 		void invalidateEntrySize();
 		void load(const FileFormat *sOwner);
+		void computePendingHashes() const;
 		void dump(std::string &sDump) const;
 		bool hasCrc32() const;
 		bool hasMd5() const;
@@ -0,0 +1,212 @@
+/**
+* @file include/retdec/llvmir2hll/llvmir2hll.h
+* @brief Conversion of an LLVM IR module into the target high-level language.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_LLVMIR2HLL_LLVMIR2HLL_H
+#define RETDEC_LLVMIR2HLL_LLVMIR2HLL_H
+
+#include <string>
+
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Analysis/ScalarEvolution.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Pass.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "retdec/llvmir2hll/pattern/pattern_finder_runner.h"
+#include "retdec/llvmir2hll/support/smart_ptr.h"
+#include "retdec/llvmir2hll/support/types.h"
+
+namespace retdec {
+
+namespace config {
+
+class Config;
+
+} // namespace config
+
+namespace llvmir2hll {
+
+class AliasAnalysis;
+class ArithmExprEvaluator;
+class CallInfoObtainer;
+class Config;
+class HLLWriter;
+class LLVMIR2BIRConverter;
+class Module;
+class Semantics;
+class VarNameGen;
+class VarRenamer;
+
+/**
+* @brief Options of the conversion of LLVM IR into the target HLL.
+*
+* The default values are the same as the default values of the corresponding
+* parameters of llvmir2hll.
+*/
+struct LlvmIr2HllOptions {
+	/// Name of the target HLL.
+	std::string targetHll = "!bad!";
+	/// Emission of debugging messages.
+	bool debug = false;
+	/// The used semantics in the form 'sem1,sem2,...'.
+	std::string semantics;
+	/// Path to the configuration file (it is updated at the end).
+	std::string configPath;
+	/// An already loaded config to be used instead of @c configPath.
+	///
+	/// If it is given, the config is not re-read from @c configPath, which is
+	/// then used only to save the updated config.
+	const retdec::config::Config *config = nullptr;
+	bool emitDebugComments = false;
+	std::string enabledOpts;
+	std::string disabledOpts;
+	bool noOpts = false;
+	bool aggressiveOpts = false;
+	bool noVarRenaming = false;
+	bool noSymbolicNames = false;
+	bool keepAllBrackets = false;
+	bool keepUnreachableFuncs = false;
+	bool keepLibraryFunctions = false;
+	bool noTimeVaryingInfo = false;
+	bool noCompoundOperators = false;
+	bool validateModule = false;
+	std::string findPatterns;
+	std::string aliasAnalysis = "simple";
+	std::string varNameGen = "fruit";
+	std::string varNameGenPrefix;
+	std::string varRenamer = "readable";
+	std::string llvmir2BirConverter = "orig";
+	bool emitCfgs = false;
+	std::string cfgWriter = "dot";
+	bool emitCg = false;
+	std::string cgWriter = "dot";
+	std::string callInfoObtainer = "optim";
+	std::string arithmExprEvaluator = "c";
+	std::string forcedModuleName;
+	bool strictFpuSemantics = false;
+	/// Base name of the emitted CFG and CG files.
+	std::string outputFilename;
+};
+
+/**
+* @brief This class is the main chunk of code that converts an LLVM
+*        module to the specified high-level language (HLL).
+*
+* The decompilation is composed of the following steps:
+* 1) The pass is instantiated with the output stream, where the target code
+*    will be emitted, and with the options of the conversion.
+* 2) The function runOnModule() is called, which decompiles the given
+*    LLVM IR into BIR (backend IR).
+* 3) The resulting IR is then converted into the requested HLL at the end of
+*    runOnModule().
+*
+* The pass does not depend on the way the LLVM module was obtained, so it can
+* be run either on a module parsed from a file (llvmir2hll) or directly on
+* a module produced in the same process (retdec-decompiler).
+*/
+class LlvmIr2Hll: public llvm::ModulePass {
+public:
+	LlvmIr2Hll(llvm::raw_pwrite_stream &out, const LlvmIr2HllOptions &options);
+
+	virtual const char *getPassName() const override { return "Decompiler"; }
+	virtual bool runOnModule(llvm::Module &m) override;
+
+	static ShPtr<Semantics> getSemantics(const std::string &usedSemantics);
+	static void preloadSemantics(const std::string &usedSemantics);
+
+public:
+	/// Class identification.
+	static char ID;
+
+private:
+	virtual void getAnalysisUsage(llvm::AnalysisUsage &au) const override {
+		au.addRequired<llvm::LoopInfoWrapperPass>();
+		au.addRequired<llvm::ScalarEvolutionWrapperPass>();
+		au.setPreservesAll();
+	}
+
+	bool initialize(llvm::Module &m);
+	void createSemantics();
+	void createSemanticsFromParameter();
+	void createSemanticsFromLLVMIR();
+	bool loadConfig();
+	void saveConfig();
+	void convertLLVMIRToBIR();
+	void removeLibraryFuncs();
+	void removeCodeUnreachableInCFG();
+	void removeFuncsPrefixedWith(const StringSet &prefixes);
+	void removeUnreachableFuncs();
+	void fixSignedUnsignedTypes();
+	void convertLLVMIntrinsicFunctions();
+	void obtainDebugInfo();
+	void initAliasAnalysis();
+	void runOptimizations();
+	void renameVariables();
+	void convertConstantsToSymbolicNames();
+	void validateResultingModule();
+	void findPatterns();
+	void emitCFGs();
+	void emitCG();
+	void emitTargetHLLCode();
+	void finalize();
+	void cleanup();
+
+	StringSet parseListOfOpts(const std::string &opts) const;
+	std::string getTypeOfRunOptimizations() const;
+	StringVector getIdsOfPatternFindersToBeRun() const;
+	PatternFinderRunner::PatternFinders instantiatePatternFinders(
+		const StringVector &pfsIds);
+	ShPtr<PatternFinderRunner> instantiatePatternFinderRunner() const;
+	StringSet getPrefixesOfFuncsToBeRemoved() const;
+
+	bool unreachableFuncsShouldBeRemoved() const;
+	bool unreachableFuncsWereAlreadyRemoved() const;
+
+private:
+	/// Output stream into which the generated code will be emitted.
+	llvm::raw_pwrite_stream &out;
+
+	/// Options of the conversion.
+	LlvmIr2HllOptions options;
+
+	/// The input LLVM module.
+	llvm::Module *llvmModule;
+
+	/// The resulting module in BIR.
+	ShPtr<Module> resModule;
+
+	/// The used semantics.
+	ShPtr<Semantics> semantics;
+
+	/// The used config.
+	ShPtr<Config> config;
+
+	/// The used HLL writer.
+	ShPtr<HLLWriter> hllWriter;
+
+	/// The used alias analysis.
+	ShPtr<AliasAnalysis> aliasAnalysis;
+
+	/// The used obtainer of information about function and function calls.
+	ShPtr<CallInfoObtainer> cio;
+
+	/// The used evaluator of arithmetical expressions.
+	ShPtr<ArithmExprEvaluator> arithmExprEvaluator;
+
+	/// The used generator of variable names.
+	ShPtr<VarNameGen> varNameGen;
+
+	/// The used renamer of variables.
+	ShPtr<VarRenamer> varRenamer;
+
+	/// The used convereter of LLVM IR to BIR.
+	ShPtr<LLVMIR2BIRConverter> llvm2BIRConverter;
+};
+
+} // namespace llvmir2hll
+} // namespace retdec
+
+#endif
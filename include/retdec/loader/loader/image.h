@@ -8,6 +8,7 @@
 #define RETDEC_LOADER_RETDEC_LOADER_IMAGE_H
 
 #include <memory>
+#include <vector>
 
 #include "retdec/utils/byte_value_storage.h"
 #include "retdec/fileformat/fftypes.h"
@@ -41,6 +42,7 @@ public:
 
 	virtual bool getXByte(std::uint64_t address, std::uint64_t x, std::uint64_t& res, retdec::utils::Endianness e = retdec::utils::Endianness::UNKNOWN) const override;
 	virtual bool getXBytes(std::uint64_t address, std::uint64_t x, std::vector<std::uint8_t>& res) const override;
+	virtual std::size_t readBytes(std::uint64_t address, std::uint8_t* res, std::size_t size) const override;
 
 	virtual bool setXByte(std::uint64_t address, std::uint64_t x, std::uint64_t val, retdec::utils::Endianness e = retdec::utils::Endianness::UNKNOWN) override;
 	virtual bool setXBytes(std::uint64_t address, const std::vector<std::uint8_t>& res) override;
@@ -81,6 +83,7 @@ protected:
 	void removeSegment(Segment* segment);
 	void nameSegment(Segment* segment);
 	void sortSegments();
+	void invalidateSegmentIndex();
 
 	void setStatusMessage(const std::string& message);
 
@@ -89,12 +92,29 @@ private:
 	const Segment* _getSegment(const std::string& name) const;
 	const Segment* _getSegmentWithIndex(std::size_t index) const;
 	const Segment* _getSegmentFromAddress(std::uint64_t address) const;
+	void _buildSegmentIndex() const;
+
+	/**
+	 * Continuous address range <start, end> in which all addresses map to
+	 * the same segment.
+	 */
+	struct SegmentIndexEntry
+	{
+		std::uint64_t start;
+		std::uint64_t end;
+		const Segment* segment;
+	};
 
 	std::shared_ptr<retdec::fileformat::FileFormat> _fileFormat;
 	std::vector<std::unique_ptr<Segment>> _segments;
 	std::uint64_t _baseAddress;
 	NameGenerator _namelessSegNameGen;
 	std::string _statusMessage;
+	/// Non-overlapping address ranges sorted by start address.
+	mutable std::vector<SegmentIndexEntry> _segmentIndex;
+	mutable bool _segmentIndexValid;
+	/// Index into @c _segmentIndex of the last successful lookup.
+	mutable std::size_t _lastSegmentIndexHit;
 };
 
 } // namespace loader
@@ -7,13 +7,23 @@
 #ifndef RETDEC_STACOFIN_STACOFIN_H
 #define RETDEC_STACOFIN_STACOFIN_H
 
+#include <map>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "retdec/utils/address.h"
 
+namespace yaracpp {
+	class YaraRule;
+} // namespace yaracpp
+
 namespace retdec {
+namespace fileformat {
+	class FileFormat;
+} // namespace fileformat
+
 namespace loader {
 	class Image;
 } // namespace loader
@@ -49,6 +59,15 @@ struct DetectedFunction
 };
 
 
+/**
+ * Detected functions indexed by their address. Detections at the same address
+ * are ordered from the biggest one.
+ */
+using DetectedFunctionsMultimap = std::multimap<
+		retdec::utils::Address,
+		DetectedFunction>;
+
+
 /**
  * Finder implementation using Yara.
  */
@@ -64,21 +83,26 @@ class Finder
 		void search(
 			const retdec::loader::Image &image,
 			const std::string &yaraFile);
+		void search(
+			const retdec::loader::Image &image,
+			const std::set<std::string> &yaraFiles);
 		/// @}
 
 		/// @name Getters.
 		/// @{
 		CoveredCode getCoveredCode();
-		std::vector<DetectedFunction> getDectedFunctions();
-		const std::vector<DetectedFunction>& accessDectedFunctions();
+		const DetectedFunctionsMultimap& accessDetectedFunctions() const;
 		/// @}
 
 	private:
-		CoveredCode coveredCode;                         ///< Code coverage.
-		std::vector<DetectedFunction> detectedFunctions; ///< Functions.
+		CoveredCode coveredCode;                     ///< Code coverage.
+		DetectedFunctionsMultimap detectedFunctions; ///< Functions.
 
-		void sort();
-		bool isSorted = true; ///< @c true if detected functions are sorted.
+		void addDetectedFunctions(
+			const retdec::fileformat::FileFormat &fileFormat,
+			const yaracpp::YaraRule &detectedRule,
+			const std::string &yaraFile);
+		void addDetectedFunction(const DetectedFunction &detectedFunction);
 };
 
 } // namespace stacofin
@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <functional>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace retdec {
@@ -40,6 +41,7 @@ public:
 
 	virtual bool getXByte(std::uint64_t address, std::uint64_t x, std::uint64_t& res, Endianness e = Endianness::UNKNOWN) const = 0;
 	virtual bool getXBytes(std::uint64_t address, std::uint64_t x, std::vector<std::uint8_t>& res) const = 0;
+	virtual std::size_t readBytes(std::uint64_t address, std::uint8_t* res, std::size_t size) const;
 
 	virtual bool setXByte(std::uint64_t address, std::uint64_t x, std::uint64_t val, Endianness e = Endianness::UNKNOWN) = 0;
 	virtual bool setXBytes(std::uint64_t address, const std::vector<std::uint8_t>& val) = 0;
@@ -65,6 +67,34 @@ public:
 	bool getFloat(std::uint64_t address, float& res) const;
 	bool getDouble(std::uint64_t address, double& res) const;
 
+	/**
+	 * Read an integer of type @a T located at the provided address using the
+	 * specified endian or default file endian. Unlike the vector-based getters,
+	 * this does not allocate any memory in implementations that override
+	 * @c getXByte() efficiently.
+	 *
+	 * @param address Address to read integer from
+	 * @param res Result integer
+	 * @param e Endian - if specified it is forced, otherwise file's endian is used
+	 *
+	 * @return Status of operation (@c true if all is OK, @c false otherwise)
+	 */
+	template <typename T>
+	bool read(std::uint64_t address, T& res, Endianness e = Endianness::UNKNOWN) const
+	{
+		static_assert(std::is_integral<T>::value && sizeof(T) <= sizeof(std::uint64_t),
+			"read<T>() supports only integers of at most 64 bits");
+
+		std::uint64_t val = 0;
+		if (!getXByte(address, sizeof(T), val, e))
+		{
+			return false;
+		}
+
+		res = static_cast<T>(val);
+		return true;
+	}
+
 	bool set1Byte(std::uint64_t address, std::uint64_t val, Endianness e = Endianness::UNKNOWN);
 	bool set2Byte(std::uint64_t address, std::uint64_t val, Endianness e = Endianness::UNKNOWN);
 	bool set4Byte(std::uint64_t address, std::uint64_t val, Endianness e = Endianness::UNKNOWN);
@@ -90,6 +120,7 @@ public:
 
 protected:
 	bool createValueFromBytes(const std::vector<std::uint8_t>& data, std::uint64_t& value, Endianness endian, std::uint64_t offset = 0, std::uint64_t size = 0) const;
+	bool createValueFromBytes(const std::uint8_t* data, std::size_t dataSize, std::uint64_t& value, Endianness endian, std::uint64_t offset = 0, std::uint64_t size = 0) const;
 	bool createBytesFromValue(std::uint64_t data, std::uint64_t x, std::vector<std::uint8_t>& value, Endianness endian) const;
 
 	bool get10ByteImpl(const std::vector<std::uint8_t>& data, long double& res) const;
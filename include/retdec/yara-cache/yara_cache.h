@@ -0,0 +1,50 @@
+/**
+ * @file include/retdec/yara-cache/yara_cache.h
+ * @brief Cache of compiled YARA rules.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_YARA_CACHE_YARA_CACHE_H
+#define RETDEC_YARA_CACHE_YARA_CACHE_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <yara.h>
+
+namespace retdec {
+namespace yara_cache {
+
+/// Name of the directory with compiled rules placed next to the source rules.
+const std::string LOCAL_CACHE_DIR_NAME = "yarac-cache";
+
+/// Path to a file with rules and the namespace its rules are compiled into
+/// (an empty namespace means the default one).
+using NamespacedRuleFile = std::pair<std::string, std::string>;
+
+bool isCompiledRuleFile(const std::string &ruleFile);
+std::string getRuleFileKey(const std::string &ruleFile);
+std::string getDefaultCacheDir();
+bool isTrustedCachePath(const std::string &path);
+YR_RULES* compileRules(const std::vector<NamespacedRuleFile> &ruleFiles);
+bool compileRuleFiles(
+		const std::vector<NamespacedRuleFile> &ruleFiles,
+		const std::string &outputFile);
+bool compileRuleFile(const std::string &ruleFile, const std::string &outputFile);
+bool addToCache(
+		const std::string &ruleFile,
+		const std::string &cacheDir,
+		bool shared = false);
+std::string getLocalCompiledRuleFile(const std::string &ruleFile);
+std::string getCompiledRuleFile(
+		const std::string &ruleFile,
+		const std::string &cacheDir = getDefaultCacheDir());
+std::string getCompiledRuleFiles(
+		const std::vector<NamespacedRuleFile> &ruleFiles,
+		const std::string &cacheDir = getDefaultCacheDir());
+
+} // namespace yara_cache
+} // namespace retdec
+
+#endif
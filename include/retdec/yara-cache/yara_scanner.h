@@ -0,0 +1,118 @@
+/**
+ * @file include/retdec/yara-cache/yara_scanner.h
+ * @brief Scanner matching several namespaced sets of YARA rules at once.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_YARA_CACHE_YARA_SCANNER_H
+#define RETDEC_YARA_CACHE_YARA_SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <yara.h>
+
+#include "retdec/yara-cache/yara_cache.h"
+#include "yaracpp/types/yara_rule.h"
+
+namespace retdec {
+namespace yara_cache {
+
+/**
+ * @brief Scanner matching several namespaced sets of YARA rules at once.
+ *
+ * Unlike @c yaracpp::YaraDetector, which reports detected rules regardless of
+ * the file they come from, the scanner compiles every file into its namespace
+ * and reports the detected rules per namespace. Consumers that used to run one
+ * detector per rule set can therefore scan the input only once.
+ *
+ * Source rule files are compiled together into one set of rules, which is
+ * stored into the cache of compiled rules. Files with already compiled rules
+ * cannot be merged, so each of them is scanned as a separate set. The same
+ * holds for source files whose rules were all compiled during installation.
+ */
+class YaraScanner
+{
+	public:
+		explicit YaraScanner(const std::string &cacheDir = getDefaultCacheDir());
+		~YaraScanner();
+
+		/// @name Rules
+		/// @{
+		bool addRuleFile(
+				const std::string &ruleFile,
+				const std::string &nameSpace = std::string());
+		/// @}
+
+		/// @name Scanning
+		/// @{
+		bool analyze(const std::string &filePath, bool storeAll = false);
+		bool analyze(
+				const std::uint8_t *data,
+				std::size_t size,
+				bool storeAll = false,
+				std::size_t baseOffset = 0);
+		/// @}
+
+		/// @name Results
+		/// @{
+		const std::vector<yaracpp::YaraRule>& getDetectedRules(
+				const std::string &nameSpace = std::string()) const;
+		const std::vector<yaracpp::YaraRule>& getUndetectedRules(
+				const std::string &nameSpace = std::string()) const;
+		bool isInValidState() const;
+		/// @}
+
+	private:
+		/// Compiled rules and the namespace their results are reported in
+		/// (an empty namespace means the namespace of each rule).
+		struct RuleSet
+		{
+			YR_RULES *rules;
+			std::string nameSpace;
+		};
+
+		/// Settings and results of a single scan.
+		struct ScanContext
+		{
+			YaraScanner *scanner;
+			const std::string *nameSpace;
+			std::size_t baseOffset;
+			bool storeAll;
+		};
+
+		YaraScanner(const YaraScanner&) = delete;
+		YaraScanner& operator=(const YaraScanner&) = delete;
+
+		bool prepareRules();
+		bool loadLocalCompiledRules();
+		void clearResults();
+		static int scanCallback(int message, void *messageData, void *userData);
+
+		/// Directory of the cache of compiled rules.
+		std::string cacheDir;
+		/// Source rule files compiled together.
+		std::vector<NamespacedRuleFile> sourceFiles;
+		/// Files with already compiled rules.
+		std::vector<NamespacedRuleFile> compiledFiles;
+		/// Rule sets ready for scanning.
+		std::vector<RuleSet> ruleSets;
+		/// Detected rules per namespace.
+		std::map<std::string, std::vector<yaracpp::YaraRule>> detected;
+		/// Undetected rules per namespace (only if requested).
+		std::map<std::string, std::vector<yaracpp::YaraRule>> undetected;
+		/// @c true if YARA was initialized.
+		bool initialized = false;
+		/// @c true if the rule sets are ready for scanning.
+		bool prepared = false;
+		/// @c false if some rules cannot be loaded or compiled.
+		bool stateIsValid = true;
+};
+
+} // namespace yara_cache
+} // namespace retdec
+
+#endif
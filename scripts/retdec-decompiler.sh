@@ -86,12 +86,13 @@ print_help()
 	echo "               --static-code-sigfile path             Adds additional signature file for static code detection."
 	echo "               --static-code-archive path             Adds additional signature file for static code detection from given archive."
 	echo "               --no-default-static-signatures         No default signatures for statically linked code analysis are loaded (options static-code-sigfile/archive are still available)."
+	echo "               --skip-static-code                     Do not decode functions detected as statically linked code, only declare them. Faster decompilation of binaries with a lot of library code."
 	echo "               --max-memory bytes                     Limits the maximal memory of fileinfo, unpacker, bin2llvmir, and llvmir2hll into the given number of bytes."
 	echo "               --no-memory-limit                      Disables the default memory limit (half of system RAM) of fileinfo, unpacker, bin2llvmir, and llvmir2hll."
 }
 SCRIPT_NAME=$0
 GETOPT_SHORTOPT="a:e:hkl:m:o:p:"
-GETOPT_LONGOPT="arch:,help,keep-unreachable-funcs,target-language:,mode:,output:,pdb:,backend-aggressive-opts,backend-arithm-expr-evaluator:,backend-call-info-obtainer:,backend-cfg-test,backend-disabled-opts:,backend-emit-cfg,backend-emit-cg,backend-cg-conversion:,backend-cfg-conversion:,backend-enabled-opts:,backend-find-patterns:,backend-force-module-name:,backend-keep-all-brackets,backend-keep-library-funcs,backend-llvmir2bir-converter:,backend-no-compound-operators,backend-no-debug,backend-no-debug-comments,backend-no-opts,backend-no-symbolic-names,backend-no-time-varying-info,backend-no-var-renaming,backend-semantics,backend-strict-fpu-semantics,backend-var-renamer:,cleanup,graph-format:,raw-entry-point:,raw-section-vma:,endian:,select-decode-only,select-functions:,select-ranges:,fileinfo-verbose,fileinfo-use-all-external-patterns,generate-log,config:,color-for-ida,no-config,stop-after:,static-code-sigfile:,static-code-archive:,no-default-static-signatures,ar-name:,ar-index:,max-memory:,no-memory-limit"
+GETOPT_LONGOPT="arch:,help,keep-unreachable-funcs,target-language:,mode:,output:,pdb:,backend-aggressive-opts,backend-arithm-expr-evaluator:,backend-call-info-obtainer:,backend-cfg-test,backend-disabled-opts:,backend-emit-cfg,backend-emit-cg,backend-cg-conversion:,backend-cfg-conversion:,backend-enabled-opts:,backend-find-patterns:,backend-force-module-name:,backend-keep-all-brackets,backend-keep-library-funcs,backend-llvmir2bir-converter:,backend-no-compound-operators,backend-no-debug,backend-no-debug-comments,backend-no-opts,backend-no-symbolic-names,backend-no-time-varying-info,backend-no-var-renaming,backend-semantics,backend-strict-fpu-semantics,backend-var-renamer:,cleanup,graph-format:,raw-entry-point:,raw-section-vma:,endian:,select-decode-only,select-functions:,select-ranges:,fileinfo-verbose,fileinfo-use-all-external-patterns,generate-log,config:,color-for-ida,no-config,stop-after:,static-code-sigfile:,static-code-archive:,no-default-static-signatures,skip-static-code,ar-name:,ar-index:,max-memory:,no-memory-limit"
 
 #
 # Check proper combination of input arguments.
@@ -730,6 +731,10 @@ while true; do
 	--no-default-static-signatures)
 		DO_NOT_LOAD_STATIC_SIGNATURES=1
 		shift;;
+	--skip-static-code)
+		[ "$SKIP_STATIC_CODE" ] && print_error_and_die "Duplicate option: --skip-static-code"
+		SKIP_STATIC_CODE=1
+		shift;;
 	--fileinfo-verbose)				# Enable --verbose mode in fileinfo.
 		[ "$FILEINFO_VERBOSE" ] && print_error_and_die "Duplicate option: --fileinfo-verbose"
 		FILEINFO_VERBOSE=1
@@ -1185,6 +1190,11 @@ if [ "$MODE" = "bin" ] || [ "$MODE" = "raw" ]; then
 		"$CONFIGTOOL" "$CONFIG" --write --decode-only-selected "false"
 	fi
 
+	# Store skip statically linked code flag.
+	if [ "$SKIP_STATIC_CODE" ]; then
+		"$CONFIGTOOL" "$CONFIG" --write --skip-static-code "true"
+	fi
+
 	# Store selected functions or selected ranges into config for frontend.
 	if [ "$SELECTED_FUNCTIONS" ]; then
 		for f in "${SELECTED_FUNCTIONS[@]}"; do
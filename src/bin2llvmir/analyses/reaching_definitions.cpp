@@ -4,15 +4,16 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <atomic>
 #include <iomanip>
 #include <iostream>
 #include <set>
 #include <sstream>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include <llvm/ADT/PostOrderIterator.h>
-#include <llvm/Analysis/OrderedBasicBlock.h>
 #include <llvm/IR/CFG.h>
 #include <llvm/IR/Instruction.h>
 #include <llvm/IR/Instructions.h>
@@ -22,6 +23,7 @@
 #include "retdec/bin2llvmir/analyses/reaching_definitions.h"
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
 #include "retdec/bin2llvmir/utils/instruction.h"
+#include "retdec/bin2llvmir/utils/parallel.h"
 #define debug_enabled false
 #include "retdec/llvm-support/utils.h"
 
@@ -38,23 +40,81 @@ namespace bin2llvmir {
 //=============================================================================
 //
 
+namespace {
+
+/// Sources with more than 1/MASK_RATIO of all definitions of a function
+/// get bit masks of their definitions.
+const std::size_t MASK_RATIO = 64;
+
+/// Modules with fewer functions are analysed on the calling thread only,
+/// starting other threads would take longer than the analysis itself.
+const std::size_t PARALLEL_MIN_FUNCTIONS = 64;
+
+} // anonymous namespace
+
 bool ReachingDefinitionsAnalysis::runOnModule(
 		Module& M,
 		Config* c,
 		bool trackFlagRegs)
+{
+	clear();
+
+	std::vector<Function*> fncs;
+	for (auto& F : M.getFunctionList())
+	{
+		fncs.push_back(&F);
+	}
+	return runOnFunctions(M, fncs, c, trackFlagRegs);
+}
+
+/**
+ * Compute RDA for functions @a fncs of module @a M. Results for other
+ * functions computed before are kept, results for @a fncs are recomputed.
+ *
+ * Functions are analysed independently and only read the module, so they
+ * are analysed in parallel if there are enough of them. Results are
+ * registered in the order of @a fncs.
+ */
+bool ReachingDefinitionsAnalysis::runOnFunctions(
+		llvm::Module& M,
+		const std::vector<llvm::Function*>& fncs,
+		Config* c,
+		bool trackFlagRegs)
 {
 	_trackFlagRegs = trackFlagRegs;
 	_config = c;
 	_specialGlobal = AsmInstruction::getLlvmToAsmGlobalVariable(&M);
 
-	clear();
-	initializeBasicBlocks(M);
-	run();
+	for (auto* F : fncs)
+	{
+		clearFunction(F);
+	}
+
+	std::vector<BBEntryMap> results(fncs.size());
+	runInParallel(
+			fncs.size(),
+			[this, &fncs, &results](std::size_t i)
+			{
+				run(*fncs[i], results[i]);
+			},
+			fncs.size() < PARALLEL_MIN_FUNCTIONS ? 1 : 0);
+
+	for (std::size_t i = 0; i < fncs.size(); ++i)
+	{
+		// Swap keeps entries in place, pointers to them stay valid.
+		auto& bbs = bbMap[fncs[i]];
+		bbs.swap(results[i]);
+		registerDefsAndUses(bbs);
+	}
 
 	_run = true;
 	return false;
 }
 
+/**
+ * Compute RDA for function @a F only. Results for other functions computed
+ * before are kept, results for @a F are recomputed.
+ */
 bool ReachingDefinitionsAnalysis::runOnFunction(
 		llvm::Function& F,
 		Config* c,
@@ -64,39 +124,47 @@ bool ReachingDefinitionsAnalysis::runOnFunction(
 	_config = c;
 	_specialGlobal = AsmInstruction::getLlvmToAsmGlobalVariable(F.getParent());
 
-	clear();
-	initializeBasicBlocks(F);
-	run();
+	clearFunction(&F);
+	auto& bbs = bbMap[&F];
+	run(F, bbs);
+	registerDefsAndUses(bbs);
 
 	_run = true;
 	return false;
 }
 
-void ReachingDefinitionsAnalysis::run()
+/**
+ * Compute RDA for function @a F into entries @a bbs. Nothing but @a bbs is
+ * modified, so this can run for several functions at once.
+ */
+void ReachingDefinitionsAnalysis::run(llvm::Function& F, BBEntryMap& bbs) const
 {
-	initializeBasicBlocksPrev();
-	initializeKillGenSets();
-	propagate();
-	initializeDefsAndUses();
-
-	LOG << *this << "\n";
+	DefinitionNumbering numbering;
 
-	clearInternal();
-}
+	initializeBasicBlocks(F, bbs);
+	initializeBasicBlocksPrev(bbs);
+	initializeKillGenSets(F, bbs, numbering);
+	propagate(F, bbs, numbering);
+	initializeDefsAndUses(bbs, numbering);
 
-void ReachingDefinitionsAnalysis::initializeBasicBlocks(llvm::Module& M)
-{
-	for (auto &F : M.getFunctionList())
+	if (debug_enabled)
 	{
-		initializeBasicBlocks(F);
+		for (auto& p : bbs)
+		{
+			LOG << p.second;
+		}
 	}
+
+	clearInternal(bbs);
 }
 
-void ReachingDefinitionsAnalysis::initializeBasicBlocks(llvm::Function& F)
+void ReachingDefinitionsAnalysis::initializeBasicBlocks(
+		llvm::Function& F,
+		BBEntryMap& bbs) const
 {
 	for (auto &B : F)
 	{
-		BasicBlockEntry bbe(&B);
+		BasicBlockEntry& bbe = bbs.emplace(&B, BasicBlockEntry(&B)).first->second;
 
 		for (auto &I : B)
 		{
@@ -168,17 +236,63 @@ void ReachingDefinitionsAnalysis::initializeBasicBlocks(llvm::Function& F)
 				// Maybe, there are other users or definitions.
 			}
 		}
+	}
+}
 
-		bbMap[&F][&B] = bbe;
+/**
+ * Register definitions and uses in entries @a bbs so that they can be found
+ * by their instructions.
+ */
+void ReachingDefinitionsAnalysis::registerDefsAndUses(BBEntryMap& bbs)
+{
+	for (auto& p : bbs)
+	{
+		// Vectors are complete, pointers to their elements are stable.
+		for (auto& d : p.second.defs)
+		{
+			_defMap.emplace(d.def, &d);
+		}
+		for (auto& u : p.second.uses)
+		{
+			_useMap.emplace(u.use, &u);
+		}
 	}
 }
 
 void ReachingDefinitionsAnalysis::clear()
 {
 	bbMap.clear();
+	_defMap.clear();
+	_useMap.clear();
 	_run = false;
 }
 
+/**
+ * Remove results for function @a F. Function is used only as a key, it does
+ * not need to exist anymore.
+ */
+void ReachingDefinitionsAnalysis::clearFunction(const llvm::Function* F)
+{
+	auto fIt = bbMap.find(F);
+	if (fIt == bbMap.end())
+	{
+		return;
+	}
+
+	for (auto& p : fIt->second)
+	{
+		for (auto& d : p.second.defs)
+		{
+			_defMap.erase(d.def);
+		}
+		for (auto& u : p.second.uses)
+		{
+			_useMap.erase(u.use);
+		}
+	}
+	bbMap.erase(fIt);
+}
+
 bool ReachingDefinitionsAnalysis::wasRun() const
 {
 	return _run;
@@ -188,22 +302,21 @@ bool ReachingDefinitionsAnalysis::wasRun() const
  * Clear internal structures used to compute RDA, but not needed to use it once
  * it is computed.
  */
-void ReachingDefinitionsAnalysis::clearInternal()
+void ReachingDefinitionsAnalysis::clearInternal(BBEntryMap& bbs) const
 {
-	for (auto& pair1 : bbMap)
-	for (auto& pair : pair1.second)
+	for (auto& pair : bbs)
 	{
 		BasicBlockEntry& bb = pair.second;
 		bb.defsOut.clear();
 		bb.genDefs.clear();
-		bb.killDefs.clear();
+		bb.killSources.clear();
 	}
 }
 
-void ReachingDefinitionsAnalysis::initializeBasicBlocksPrev()
+void ReachingDefinitionsAnalysis::initializeBasicBlocksPrev(
+		BBEntryMap& bbs) const
 {
-	for (auto &pair1 : bbMap)
-	for (auto& pair : pair1.second)
+	for (auto& pair : bbs)
 	{
 		auto B = pair.first;
 		auto &entry = pair.second;
@@ -211,131 +324,206 @@ void ReachingDefinitionsAnalysis::initializeBasicBlocksPrev()
 		for (auto PI = pred_begin(B), E = pred_end(B); PI != E; ++PI)
 		{
 			auto* pred = *PI;
-			auto p = pair1.second.find(pred);
+			auto p = bbs.find(pred);
 
-			assert(p != pair1.second.end() && "we should have all BBs stored in bbMap");
+			assert(p != bbs.end() && "we should have all BBs stored in bbMap");
 
 			entry.prevBBs.insert( &p->second );
 		}
 	}
 }
 
-void ReachingDefinitionsAnalysis::initializeKillGenSets()
+/**
+ * Number all definitions in function @a F (definitions in each basic block get
+ * consecutive numbers) and initialize kill and gen sets of its basic blocks.
+ */
+void ReachingDefinitionsAnalysis::initializeKillGenSets(
+		llvm::Function& F,
+		BBEntryMap& bbs,
+		DefinitionNumbering& numbering) const
 {
-	for (auto &pair1 : bbMap)
-	for (auto& pair : pair1.second)
+	for (auto& B : F)
 	{
-		pair.second.initializeKillDefSets();
+		auto& bbe = bbs.find(&B)->second;
+		bbe.firstDefId = numbering.size();
+		for (auto& d : bbe.defs)
+		{
+			numbering.addDefinition(&d);
+		}
+	}
+	numbering.finalize();
+
+	for (auto& pair : bbs)
+	{
+		pair.second.initializeKillGenSets(numbering);
 	}
 }
 
-void ReachingDefinitionsAnalysis::propagate()
+/**
+ * Compute sets of definitions reaching ends of basic blocks by a worklist
+ * algorithm. Basic blocks unreachable from the entry block are not processed,
+ * nothing reaches their ends.
+ */
+void ReachingDefinitionsAnalysis::propagate(
+		llvm::Function& F,
+		BBEntryMap& bbs,
+		const DefinitionNumbering& numbering) const
 {
-	for (auto &pair1 : bbMap)
+	if (F.empty())
 	{
-		const Function* fnc = pair1.first;
+		return;
+	}
 
-		std::vector<BasicBlockEntry*> workList;
-		workList.reserve(pair1.second.size());
-		ReversePostOrderTraversal<const Function*> RPOT(fnc); // Expensive to create
-		for (auto I = RPOT.begin(); I != RPOT.end(); ++I)
-		{
-			const BasicBlock* bb = *I;
-			auto fIt = pair1.second.find(bb);
-			assert(fIt != pair1.second.end());
-			workList.push_back(&(fIt->second));
+	std::vector<BasicBlockEntry*> order;
+	order.reserve(bbs.size());
+	std::unordered_map<const BasicBlock*, std::size_t> orderIds;
+	ReversePostOrderTraversal<const Function*> RPOT(&F); // Expensive to create
+	for (auto I = RPOT.begin(); I != RPOT.end(); ++I)
+	{
+		const BasicBlock* bb = *I;
+		auto fIt = bbs.find(bb);
+		assert(fIt != bbs.end());
+		orderIds[bb] = order.size();
+		order.push_back(&(fIt->second));
+		fIt->second.defsOut.resize(numbering.size());
+	}
 
-			fIt->second.changed = true;
-		}
+	// Blocks are processed in reverse post-order, each sweep processes only
+	// those whose predecessors changed in the previous one or sooner.
+	//
+	std::vector<bool> pending(order.size(), true);
+	BitVector defsIn(numbering.size());
+	bool changed = true;
+	while (changed)
+	{
+		changed = false;
 
-		bool changed = true;
-		while (changed)
+		for (std::size_t i = 0; i < order.size(); ++i)
 		{
-			changed = false;
+			if (!pending[i])
+			{
+				continue;
+			}
+			pending[i] = false;
 
-			for (auto* bbe : workList)
+			auto* bbe = order[i];
+			defsIn.reset();
+			for (auto* p : bbe->prevBBs)
 			{
-				changed |= bbe->initDefsOut();
+				defsIn |= p->defsOut;
+			}
+
+			if (bbe->initDefsOut(defsIn, numbering))
+			{
+				for (auto SI = succ_begin(bbe->bb), E = succ_end(bbe->bb);
+						SI != E;
+						++SI)
+				{
+					auto oIt = orderIds.find(*SI);
+					if (oIt != orderIds.end())
+					{
+						pending[oIt->second] = true;
+						changed = true;
+					}
+				}
 			}
 		}
 	}
 }
 
-void ReachingDefinitionsAnalysis::initializeDefsAndUses()
+void ReachingDefinitionsAnalysis::initializeDefsAndUses(
+		BBEntryMap& bbs,
+		const DefinitionNumbering& numbering) const
 {
-	for (auto &pair1 : bbMap)
-	for (auto& pair : pair1.second)
+	std::unordered_map<const Value*, Definition*> lastDefs;
+	std::vector<Definition*> inDefs;
+	BitVector defsIn;
+
+	for (auto& pair : bbs)
 	{
 		BasicBlockEntry &bb = pair.second;
-		OrderedBasicBlock obb(bb.bb);
-
-		for (Use &u : bb.uses)
+		bool defsInReady = false;
+
+		// Definitions and uses are stored in the order of their instructions.
+		// Use of each source is reached by the last definition of the source
+		// before it, or by definitions reaching the block if there is none.
+		//
+		lastDefs.clear();
+		auto dIt = bb.defs.begin();
+		auto uIt = bb.uses.begin();
+		for (auto& I : *bb.bb)
 		{
-			for (auto dIt = bb.defs.rbegin(); dIt != bb.defs.rend(); ++dIt)
+			for (; uIt != bb.uses.end() && uIt->use == &I; ++uIt)
 			{
-				Definition &d = *dIt;
+				Use& u = *uIt;
 
-				if (d.getSource() != u.src)
+				auto lIt = lastDefs.find(u.src);
+				if (lIt != lastDefs.end())
 				{
+					lIt->second->uses.insert(&u);
+					u.defs.insert(lIt->second);
 					continue;
 				}
 
-				if (obb.dominates(d.def, u.use))
+				unsigned source = 0;
+				if (!numbering.getSourceId(u.src, source))
 				{
-					d.uses.insert(&u);
-					u.defs.insert(&d);
-					break;
+					continue;
 				}
-			}
-
-			if (u.defs.empty())
-			{
-				for (auto p : bb.prevBBs)
-				for (auto d : p->defsOut)
+				if (!defsInReady)
 				{
-					if (d->getSource() == u.src)
+					defsIn.clear();
+					defsIn.resize(numbering.size());
+					for (auto p : bb.prevBBs)
 					{
-						d->uses.insert(&u);
-						u.defs.insert(d);
+						if (!p->defsOut.empty())
+						{
+							defsIn |= p->defsOut;
+						}
 					}
+					defsInReady = true;
+				}
+
+				numbering.getDefinitions(defsIn, source, inDefs);
+				for (auto* d : inDefs)
+				{
+					d->uses.insert(&u);
+					u.defs.insert(d);
 				}
 			}
+
+			for (; dIt != bb.defs.end() && dIt->def == &I; ++dIt)
+			{
+				lastDefs[dIt->src] = &(*dIt);
+			}
 		}
 	}
 }
 
-const BasicBlockEntry& ReachingDefinitionsAnalysis::getBasicBlockEntry(
-		const Instruction* I) const
-{
-	auto* F = I->getFunction();
-	auto pair1 = bbMap.find(F);
-	assert(pair1 != bbMap.end() && "we do not have this function in bbMap");
-
-	auto* BB = I->getParent();
-	auto pair = pair1->second.find(BB);
-	assert(pair != pair1->second.end() && "we do not have this basic block in bbMap");
-
-	return pair->second;
-}
-
 const DefSet& ReachingDefinitionsAnalysis::defsFromUse(const Instruction* I) const
 {
-	return getBasicBlockEntry(I).defsFromUse(I);
+	static DefSet emptyDefSet;
+	auto* u = getUse(I);
+	return u ? u->defs : emptyDefSet;
 }
 
 const UseSet& ReachingDefinitionsAnalysis::usesFromDef(const Instruction* I) const
 {
-	return getBasicBlockEntry(I).usesFromDef(I);
+	static UseSet emptyUseSet;
+	auto* d = getDef(I);
+	return d ? d->uses : emptyUseSet;
 }
 
 const Definition* ReachingDefinitionsAnalysis::getDef(const Instruction* I) const
 {
-	return getBasicBlockEntry(I).getDef(I);
+	auto it = _defMap.find(I);
+	return it != _defMap.end() ? it->second : nullptr;
 }
 
 const Use* ReachingDefinitionsAnalysis::getUse(const Instruction* I) const
 {
-	return getBasicBlockEntry(I).getUse(I);
+	auto it = _useMap.find(I);
+	return it != _useMap.end() ? it->second : nullptr;
 }
 
 std::ostream& operator<<(std::ostream& out, const ReachingDefinitionsAnalysis& rda)
@@ -348,6 +536,122 @@ std::ostream& operator<<(std::ostream& out, const ReachingDefinitionsAnalysis& r
 	return out;
 }
 
+//
+//=============================================================================
+//  DefinitionNumbering
+//=============================================================================
+//
+
+/**
+ * Give the next number to definition @a d.
+ * @return Number of the definition.
+ */
+unsigned DefinitionNumbering::addDefinition(Definition* d)
+{
+	auto it = _sourceIds.emplace(d->getSource(), _sourceIds.size()).first;
+	if (it->second == _sourceDefs.size())
+	{
+		_sourceDefs.emplace_back();
+	}
+	_sourceDefs[it->second].push_back(_defs.size());
+	_defs.push_back(d);
+	return _defs.size() - 1;
+}
+
+/**
+ * Build masks of sources with many definitions. Call this after all the
+ * definitions were added.
+ */
+void DefinitionNumbering::finalize()
+{
+	_sourceMasks.assign(_sourceDefs.size(), BitVector());
+	for (std::size_t i = 0; i < _sourceDefs.size(); ++i)
+	{
+		if (_sourceDefs[i].size() * MASK_RATIO > _defs.size())
+		{
+			_sourceMasks[i].resize(_defs.size());
+			for (auto id : _sourceDefs[i])
+			{
+				_sourceMasks[i].set(id);
+			}
+		}
+	}
+}
+
+std::size_t DefinitionNumbering::size() const
+{
+	return _defs.size();
+}
+
+Definition* DefinitionNumbering::getDefinition(unsigned id) const
+{
+	return _defs[id];
+}
+
+/**
+ * Get number @a id of source @a src.
+ * @return @c True if @a src is defined in the function, @c false otherwise.
+ */
+bool DefinitionNumbering::getSourceId(const llvm::Value* src, unsigned& id) const
+{
+	auto it = _sourceIds.find(src);
+	if (it == _sourceIds.end())
+	{
+		return false;
+	}
+	id = it->second;
+	return true;
+}
+
+/**
+ * Remove all definitions of source number @a source from @a bv.
+ */
+void DefinitionNumbering::removeDefinitions(
+		llvm::BitVector& bv,
+		unsigned source) const
+{
+	if (!_sourceMasks[source].empty())
+	{
+		bv.reset(_sourceMasks[source]);
+	}
+	else
+	{
+		for (auto id : _sourceDefs[source])
+		{
+			bv.reset(id);
+		}
+	}
+}
+
+/**
+ * Get all definitions of source number @a source in @a bv into @a res.
+ */
+void DefinitionNumbering::getDefinitions(
+		const llvm::BitVector& bv,
+		unsigned source,
+		std::vector<Definition*>& res) const
+{
+	res.clear();
+	if (!_sourceMasks[source].empty())
+	{
+		BitVector tmp(bv);
+		tmp &= _sourceMasks[source];
+		for (int id = tmp.find_first(); id != -1; id = tmp.find_next(id))
+		{
+			res.push_back(_defs[id]);
+		}
+	}
+	else
+	{
+		for (auto id : _sourceDefs[source])
+		{
+			if (bv.test(id))
+			{
+				res.push_back(_defs[id]);
+			}
+		}
+	}
+}
 
 //
 //=============================================================================
@@ -355,7 +659,7 @@ std::ostream& operator<<(std::ostream& out, const ReachingDefinitionsAnalysis& r
 //=============================================================================
 //
 
-int BasicBlockEntry::newUID = 0;
+std::atomic<int> BasicBlockEntry::newUID(0);
 
 BasicBlockEntry::BasicBlockEntry(const llvm::BasicBlock* b) :
 	bb(b),
@@ -364,19 +668,25 @@ BasicBlockEntry::BasicBlockEntry(const llvm::BasicBlock* b) :
 
 }
 
-void BasicBlockEntry::initializeKillDefSets()
+/**
+ * Initialize kill and gen sets using numbers from @a numbering.
+ */
+void BasicBlockEntry::initializeKillGenSets(const DefinitionNumbering& numbering)
 {
-	killDefs.clear();
+	killSources.clear();
 	genDefs.clear();
 
-	for (auto dIt = defs.rbegin(); dIt != defs.rend(); ++dIt)
+	std::unordered_set<unsigned> seen;
+	seen.reserve(defs.size());
+	for (std::size_t i = defs.size(); i > 0; --i)
 	{
-		Definition& d = *dIt;
+		unsigned source = 0;
+		numbering.getSourceId(defs[i-1].getSource(), source);
 
-		bool added = (killDefs.insert(d.getSource())).second;
-		if (added)
+		if (seen.insert(source).second)
 		{
-			genDefs.insert(&d);
+			killSources.push_back(source);
+			genDefs.push_back(firstDefId + i - 1);
 		}
 	}
 }
@@ -384,32 +694,31 @@ void BasicBlockEntry::initializeKillDefSets()
 /**
  * REACH_in[B] = Sum (p in pred[B]) (REACH_out[p])
  * REACH_out[B] = GEN[B] + ( REACH_in[B] - KILL[B] )
+ *
+ * @param defsIn     REACH_in[B].
+ * @param numbering  Numbering of definitions in the function.
+ * @return @c True if REACH_out[B] changed.
  */
-Changed BasicBlockEntry::initDefsOut()
+Changed BasicBlockEntry::initDefsOut(
+		const llvm::BitVector& defsIn,
+		const DefinitionNumbering& numbering)
 {
-	auto oldSz = defsOut.size();
-
-	if (defsOut.empty() && !genDefs.empty())
+	BitVector out(defsIn);
+	for (auto source : killSources)
 	{
-		defsOut = std::move(genDefs);
+		numbering.removeDefinitions(out, source);
 	}
-
-	for (auto* p : prevBBs)
+	for (auto id : genDefs)
 	{
-		if (p->changed)
-		{
-			for (auto* d : p->defsOut)
-			{
-				if (killDefs.find(d->getSource()) == killDefs.end())
-				{
-					defsOut.insert(d);
-				}
-			}
-		}
+		out.set(id);
 	}
 
-	changed = oldSz != defsOut.size();
-	return changed;
+	if (out == defsOut)
+	{
+		return false;
+	}
+	defsOut = std::move(out);
+	return true;
 }
 
 std::string BasicBlockEntry::getName() const
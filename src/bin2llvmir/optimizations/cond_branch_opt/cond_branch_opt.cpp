@@ -12,6 +12,7 @@
 
 #include "retdec/bin2llvmir/analyses/symbolic_tree.h"
 #include "retdec/bin2llvmir/optimizations/cond_branch_opt/cond_branch_opt.h"
+#include "retdec/bin2llvmir/providers/analyses.h"
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
 #define debug_enabled false
 #include "retdec/llvm-support/utils.h"
@@ -61,8 +62,10 @@ bool CondBranchOpt::run()
 
 	bool changed = false;
 
-	ReachingDefinitionsAnalysis RDA;
-	RDA.runOnModule(*_module, _config, true);
+	auto& RDA = *AnalysesProvider::getReachingDefinitions(
+			_module,
+			_config,
+			true);
 
 //dumpModuleToFile(_module);
 	for (auto& f : *_module)
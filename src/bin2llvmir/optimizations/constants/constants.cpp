@@ -22,6 +22,7 @@
 #include "retdec/utils/time.h"
 #include "retdec/bin2llvmir/analyses/symbolic_tree.h"
 #include "retdec/bin2llvmir/optimizations/constants/constants.h"
+#include "retdec/bin2llvmir/providers/analyses.h"
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
 #include "retdec/bin2llvmir/utils/global_var.h"
 #include "retdec/bin2llvmir/utils/instruction.h"
@@ -74,8 +75,7 @@ bool ConstantsAnalysis::runOnModule(Module &M)
 
 	m_module = &M;
 
-	ReachingDefinitionsAnalysis RDA;
-	RDA.runOnModule(M, config);
+	auto& RDA = *AnalysesProvider::getReachingDefinitions(&M, config);
 
 	setPic32GpValue(RDA);
 
@@ -4,6 +4,7 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <algorithm>
 #include <iostream>
 #include <map>
 
@@ -12,6 +13,7 @@
 #include "retdec/utils/conversion.h"
 #include "retdec/utils/string.h"
 #include "retdec/bin2llvmir/optimizations/decoder/decoder.h"
+#include "retdec/bin2llvmir/providers/lti.h"
 #include "retdec/bin2llvmir/utils/defs.h"
 #define debug_enabled false
 #include "retdec/llvm-support/utils.h"
@@ -107,6 +109,7 @@ bool Decoder::run()
 	LOG << std::endl;
 
 	doDecoding();
+	freeDecodedInstructionCache();
 	checkIfSomethingDecoded();
 
 	fixMainName();
@@ -156,7 +159,6 @@ void Decoder::initRangesAndTargets()
 	}
 
 	initJumpTargets();
-	findDelphiFunctionTable();
 
 	// TODO: This will screw decoding of 2 exotic tests, but removed ranges
 	// look ok -- should be removed:
@@ -178,6 +180,48 @@ void Decoder::initRangesAndTargets()
 
 	removeZeroSequences(_allowedRanges);
 	removeZeroSequences(_alternativeRanges);
+
+	initDecodedInstructionCache();
+	findDelphiFunctionTable();
+}
+
+/**
+ * Disassemble all allowed ranges in parallel before the (sequential)
+ * translation. The translator and other users of the Capstone engine take
+ * instructions from the resulting cache instead of disassembling them again.
+ */
+void Decoder::initDecodedInstructionCache()
+{
+	_decodedInsns.reset(new DecodedInstructionCache(
+			_c2l->getArchitecture(),
+			_c2l->getBasicMode(),
+			_config->getConfig().architecture.isEndianBig()
+					? CS_MODE_BIG_ENDIAN
+					: CS_MODE_LITTLE_ENDIAN));
+
+	for (auto& r : _allowedRanges)
+	{
+		std::vector<std::uint8_t> bytes(r.getSize());
+		bytes.resize(_image->getImage()->readBytes(
+				r.getStart(),
+				bytes.data(),
+				bytes.size()));
+		_decodedInsns->addRange(r.getStart(), std::move(bytes));
+	}
+	_decodedInsns->decode();
+	_c2l->setDecodedInstructionCache(_decodedInsns.get());
+
+	LOG << "\t" << _decodedInsns->size()
+			<< " instructions disassembled in advance" << std::endl;
+}
+
+/**
+ * The cache is not needed after the decoding, free its memory.
+ */
+void Decoder::freeDecodedInstructionCache()
+{
+	_c2l->setDecodedInstructionCache(nullptr);
+	_decodedInsns.reset();
 }
 
 void Decoder::removeZeroSequences(retdec::utils::AddressRangeContainer& rs)
@@ -295,6 +339,18 @@ void Decoder::initJumpTargetsWithStaticCode()
 		LOG << "\t\tstatically linked: " << name << " @ " << start << std::endl;
 		_jumpTargets.push(_config, start, JumpTarget::eType::STATICALLY_LINKED_FUNCTION, m, name);
 
+		// Function is created for the jump target, but its body is never
+		// translated -> it ends up as a declaration.
+		if (_config->getConfig().parameters.isSkipStaticCode()
+				&& !isProtectedStaticallyLinkedFunction(name))
+		{
+			AddressRange r(start, end);
+			_allowedRanges.remove(r);
+			_alternativeRanges.remove(r);
+			_processedRanges.insert(r);
+			LOG << "\t\tnot decoded: " << r << std::endl;
+		}
+
 		Address next = end + 1;
 		LOG << "\t\tafter statically linked: " << name << " @ " << end << std::endl;
 		_jumpTargets.push(_config, next, JumpTarget::eType::SYMBOL_FUNCTION, m);
@@ -1148,6 +1204,7 @@ if (_config->getConfig().architecture.isArmOrThumb())
 
 	std::map<Address, std::pair<AsmInstruction, AsmInstruction>> instrMap;
 
+	_jumpTargets.setPopedRanges(_allowedRanges, _alternativeRanges);
 	while (!_jumpTargets.empty())
 	{
 		JumpTarget jt = _jumpTargets.top();
@@ -1243,10 +1300,8 @@ if (jt.type == JumpTarget::eType::DELAY_SLOT)
 	size = 4;
 }
 
-		std::vector<std::uint8_t> code;
-		std::vector<std::uint64_t> tmp;
-		_image->getImage()->get1ByteArray(start, tmp, size);
-		std::copy(tmp.begin(), tmp.end(), std::back_inserter(code)); // TODO: no copy -> slow
+		std::vector<std::uint8_t> code(size);
+		code.resize(_image->getImage()->readBytes(start, code.data(), size));
 
 		LOG << "\t\tsize to decode : " << size << " vs. " << code.size() << std::endl;
 
@@ -1334,6 +1389,16 @@ LOG << "===========> SWITCH MODE #2 " << _currentMode << " -> " << jt.mode << st
 		AsmInstruction last(tRes.last);
 		CallInst* termCall = tRes.branchCall;
 
+		for (auto ai = first; ai.isValid(); ai = ai.getNext())
+		{
+			AsmInstruction::registerLlvmToAsmInstruction(
+					ai.getLlvmToAsmInstruction());
+			if (ai == last)
+			{
+				break;
+			}
+		}
+
 		LOG << "\t\ttranslated : " << tRange << std::endl;
 		LOG << "\t\tfirst      : " << first.getAddress() << std::endl;
 		LOG << "\t\tlast       : " << last.getAddress() << std::endl;
@@ -1733,6 +1798,14 @@ else if ((_config->getConfig().architecture.isPpc() || isArmOrThumb())
 		Address end = lastAi.isValid()
 				? Address(lastAi.getAddress() + lastAi.getByteSize() - 1) // TODO: getEndAddress() should do start + size - 1
 				: start;
+		if (lastAi.isInvalid())
+		{
+			auto scIt = _staticCode.find(a);
+			if (scIt != _staticCode.end())
+			{
+				end = scIt->second.second.getEnd();
+			}
+		}
 
 		if (f->getName().empty() || f->getName() == "entry_point") // TODO: entry point nicer
 		{
@@ -1820,6 +1893,16 @@ else if ((_config->getConfig().architecture.isPpc() || isArmOrThumb())
 		if (slIt != _staticCode.end())
 		{
 			cf->setIsStaticallyLinked();
+
+			// Not decoded -> signature can only come from LTI.
+			auto* lti = LtiProvider::getLti(_module);
+			if (lti && f->isDeclaration())
+			{
+				if (auto ltiFnc = lti->getLtiFunction(cf->getName()))
+				{
+					cf->setDeclarationString(ltiFnc->getDeclaration());
+				}
+			}
 		}
 
 		auto dfIt = _debug->functions.find(a);
@@ -1936,32 +2019,16 @@ bool Decoder::looksLikeValidJumpTarget(retdec::utils::Address addr)
 	if (_config->isMipsOrPic32())
 	{
 		static const unsigned insnNum = 4;
-		std::vector<std::uint8_t> code;
-		std::vector<std::uint64_t> tmp;
-		_image->getImage()->get1ByteArray(addr, tmp, insnNum*4);
-		std::copy(tmp.begin(), tmp.end(), std::back_inserter(code)); // TODO: no copy -> slow
-		auto& engine = _c2l->getCapstoneEngine();
-		cs_insn* insn = nullptr;
-		const uint8_t* c = code.data();
-		size_t count = cs_disasm(engine, c, code.size(), addr, 0, &insn);
-		if (count > 0)
-		{
-			cs_free(insn, count);
-		}
+		auto count = countDecodableInstructions(addr, insnNum*4);
 		if (count == insnNum) // all data were successfully disassembled into instructions.
 		{
 			return true;
 		}
 		else if (_c2l->getBasicMode() == CS_MODE_MIPS32)
 		{
-			insn = nullptr;
 			_c2l->modifyBasicMode(CS_MODE_MIPS64);
-			count = cs_disasm(engine, c, code.size(), addr, 0, &insn);
+			count = countDecodableInstructions(addr, insnNum*4);
 			_c2l->modifyBasicMode(CS_MODE_MIPS32);
-			if (count > 0)
-			{
-				cs_free(insn, count);
-			}
 			if (count == insnNum) // all data were successfully disassembled into instructions.
 			{
 				return true;
@@ -1974,18 +2041,7 @@ bool Decoder::looksLikeValidJumpTarget(retdec::utils::Address addr)
 	if (_config->getConfig().architecture.isPpc())
 	{
 		static const unsigned insnNum = 4;
-		std::vector<std::uint8_t> code;
-		std::vector<std::uint64_t> tmp;
-		_image->getImage()->get1ByteArray(addr, tmp, insnNum*4);
-		std::copy(tmp.begin(), tmp.end(), std::back_inserter(code)); // TODO: no copy -> slow
-		auto& engine = _c2l->getCapstoneEngine();
-		cs_insn* insn = nullptr;
-		const uint8_t* c = code.data();
-		size_t count = cs_disasm(engine, c, code.size(), addr, 0, &insn);
-		if (count > 0)
-		{
-			cs_free(insn, count);
-		}
+		auto count = countDecodableInstructions(addr, insnNum*4);
 		if (count == insnNum) // all data were successfully disassembled into instructions.
 		{
 			return true;
@@ -1995,18 +2051,7 @@ bool Decoder::looksLikeValidJumpTarget(retdec::utils::Address addr)
 	if (_config->getConfig().architecture.isArmOrThumb())
 	{
 		static const unsigned insnNum = 4;
-		std::vector<std::uint8_t> code;
-		std::vector<std::uint64_t> tmp;
-		_image->getImage()->get1ByteArray(addr, tmp, insnNum*4);
-		std::copy(tmp.begin(), tmp.end(), std::back_inserter(code)); // TODO: no copy -> slow
-		auto& engine = _c2l->getCapstoneEngine();
-		cs_insn* insn = nullptr;
-		const uint8_t* c = code.data();
-		size_t count = cs_disasm(engine, c, code.size(), addr, 0, &insn);
-		if (count > 0)
-		{
-			cs_free(insn, count);
-		}
+		auto count = countDecodableInstructions(addr, insnNum*4);
 		if (count == insnNum) // all data were successfully disassembled into instructions.
 		{
 			return true;
@@ -2016,6 +2061,30 @@ bool Decoder::looksLikeValidJumpTarget(retdec::utils::Address addr)
 	return false;
 }
 
+/**
+ * Count instructions which can be disassembled one after another from the
+ * first @a size bytes at address @a addr in the current mode.
+ */
+std::size_t Decoder::countDecodableInstructions(
+		retdec::utils::Address addr,
+		std::size_t size)
+{
+	std::vector<std::uint8_t> code(size);
+	size_t codeSize = _image->getImage()->readBytes(addr, code.data(), size);
+	const uint8_t* bytes = code.data();
+	uint64_t address = addr;
+	cs_insn* insn = cs_malloc(_c2l->getCapstoneEngine());
+
+	std::size_t count = 0;
+	while (_c2l->disasmIter(&bytes, &codeSize, &address, insn))
+	{
+		++count;
+	}
+
+	cs_free(insn, 1);
+	return count;
+}
+
 bool Decoder::initTranslator()
 {
 	auto& a = _config->getConfig().architecture;
@@ -2087,6 +2156,9 @@ bool Decoder::initTranslator()
 			_module,
 			basicMode,
 			extraMode);
+	// Instructions in MIPS delay slots are moved around after the decoding
+	// (see fixMipsDelaySlots()), so they must not share register loads.
+	_c2l->setRegisterLoadCaching(arch != CS_ARCH_MIPS);
 	_currentMode = basicMode;
 	return false;
 }
@@ -2237,13 +2309,132 @@ std::ostream& operator<<(std::ostream &out, const Decoder::JumpTarget& jt)
 
 std::ostream& operator<<(std::ostream &out, const Decoder::JumpTargets& jts)
 {
-	for (auto& jt : jts._data)
+	for (auto& jt : jts)
 	{
 		out << jt << std::endl;
 	}
 	return out;
 }
 
+void Decoder::JumpTargets::pushHeap(const JumpTarget& jt)
+{
+	_data.push_back(jt);
+	_data.back().sequence = _pushed++;
+	std::push_heap(_data.begin(), _data.end(), isPopedLater);
+}
+
+/**
+ * Pop the top target together with all its duplicates, i.e. the same
+ * targets pushed while it was pending.
+ */
+void Decoder::JumpTargets::pop()
+{
+	JumpTarget jt = top();
+	setPoped(jt.address);
+	do
+	{
+		std::pop_heap(_data.begin(), _data.end(), isPopedLater);
+		_data.pop_back();
+	} while (!_data.empty() && isSameTarget(_data.front(), jt));
+}
+
+bool Decoder::JumpTargets::wasAlreadyPoped(JumpTarget& ct) const
+{
+	if (auto* r = getPopedRange(ct.address))
+	{
+		return _popedBits[r->second + (ct.address - r->first.getStart())];
+	}
+
+	return _popedOther.count(ct.address);
+}
+
+/**
+ * Get range from @c _popedRanges with address @p a, or @c nullptr if there is
+ * no such range.
+ */
+const std::pair<AddressRange, std::size_t>* Decoder::JumpTargets::getPopedRange(
+		retdec::utils::Address a) const
+{
+	auto it = std::upper_bound(
+			_popedRanges.begin(),
+			_popedRanges.end(),
+			a,
+			[](Address addr, const std::pair<AddressRange, std::size_t>& r)
+			{
+				return addr < r.first.getStart();
+			});
+	if (it != _popedRanges.begin() && (it - 1)->first.contains(a))
+	{
+		return &*(it - 1);
+	}
+
+	return nullptr;
+}
+
+/**
+ * Track popped addresses from ranges @p ranges1 and @p ranges2 in a bitmap.
+ * This should be called before the targets are popped.
+ */
+void Decoder::JumpTargets::setPopedRanges(
+		const retdec::utils::AddressRangeContainer& ranges1,
+		const retdec::utils::AddressRangeContainer& ranges2)
+{
+	_popedRanges.clear();
+	for (auto* rs : {&ranges1, &ranges2})
+	{
+		for (auto& r : *rs)
+		{
+			_popedRanges.emplace_back(r, 0);
+		}
+	}
+	std::sort(_popedRanges.begin(), _popedRanges.end());
+
+	std::size_t bits = 0;
+	for (auto& r : _popedRanges)
+	{
+		r.second = bits;
+		bits += r.first.getSize();
+	}
+	_popedBits.assign(bits, false);
+
+	std::set<Address> other;
+	other.swap(_popedOther);
+	for (auto a : other)
+	{
+		setPoped(a);
+	}
+}
+
+void Decoder::JumpTargets::setPoped(retdec::utils::Address a)
+{
+	if (auto* r = getPopedRange(a))
+	{
+		_popedBits[r->second + (a - r->first.getStart())] = true;
+	}
+	else
+	{
+		_popedOther.insert(a);
+	}
+}
+
+/**
+ * Sort pending targets and keep only the first pushed of the same targets.
+ * Sorted targets still form a valid heap.
+ */
+void Decoder::JumpTargets::removeDuplicates() const
+{
+	std::sort(
+			_data.begin(),
+			_data.end(),
+			[](const JumpTarget& a, const JumpTarget& b)
+			{
+				return isPopedLater(b, a);
+			});
+	_data.erase(
+			std::unique(_data.begin(), _data.end(), isSameTarget),
+			_data.end());
+}
+
 retdec::utils::Address Decoder::getJumpTarget(llvm::Value* val)
 {
 	if (auto* ci = dyn_cast<ConstantInt>(val))
@@ -2285,17 +2476,9 @@ void Decoder::removeStaticallyLinkedFunctions()
 	// Merge control flow pass with decoding and move main detection right after it
 	// so that all statically linked functions may be removed as soon as possible.
 	//
-	std::set<std::string> protectedLinked = {
-			"__CrtSetReportHookW2",
-			"_CrtSetCheckCount",
-			"InterlockedExchange",
-			"___tmainCRTStartup",
-			"_WinMainCRTStartup",
-			"WinMainCRTStartup",
-	};
 	for (Function& f : _module->functions())
 	{
-		if (protectedLinked.count(f.getName()))
+		if (isProtectedStaticallyLinkedFunction(f.getName()))
 		{
 			continue;
 		}
@@ -2308,6 +2491,23 @@ void Decoder::removeStaticallyLinkedFunctions()
 	}
 }
 
+/**
+ * Statically linked functions with these names must be decoded and kept until
+ * the main detection pass, which uses their bodies.
+ */
+bool Decoder::isProtectedStaticallyLinkedFunction(const std::string& name) const
+{
+	static const std::set<std::string> protectedLinked = {
+			"__CrtSetReportHookW2",
+			"_CrtSetCheckCount",
+			"InterlockedExchange",
+			"___tmainCRTStartup",
+			"_WinMainCRTStartup",
+			"WinMainCRTStartup",
+	};
+	return protectedLinked.count(name);
+}
+
 void Decoder::hackDeleteKnownLinkedFunctions()
 {
 	for (Function& f : _module->getFunctionList())
@@ -2399,19 +2599,15 @@ void Decoder::findDelphiFunctionTable()
 
 	const csh& engine = _c2l->getCapstoneEngine();
 
-	std::vector<std::uint8_t> code;
-	std::vector<std::uint64_t> tmp;
-	_image->getImage()->get1ByteArray(ep, tmp, 0x20);
-	std::copy(tmp.begin(), tmp.end(), std::back_inserter(code));  // TODO: no copy -> slow
-
-	size_t size = code.size();
-	const uint8_t* bytes = code.data();
+	std::uint8_t code[0x20];
+	size_t size = _image->getImage()->readBytes(ep, code, sizeof(code));
+	const uint8_t* bytes = code;
 	uint64_t address = ep;
 	cs_insn* insn = cs_malloc(engine);
 	unsigned cntr = 0;
 
 	bool reached = false;
-	while (cs_disasm_iter(engine, &bytes, &size, &address, insn))
+	while (_c2l->disasmIter(&bytes, &size, &address, insn))
 	{
 		if (++cntr == 4)
 		{
@@ -348,17 +348,13 @@ void Decoder::doStaticCodeRecognition()
 	}
 
 	Finder codeFinder;
-	for (const auto &path : sigPaths)
-	{
-		codeFinder.search(*_image->getImage(), path);
-	}
+	codeFinder.search(*_image->getImage(), sigPaths);
 
 	LOG << "\n" << "Detected functions:" << std::endl;
 
-	std::map<retdec::utils::Address, std::map<std::string, retdec::utils::AddressRange>> sfncs;
-
-	for (auto& f : codeFinder.accessDectedFunctions())
+	for (auto& p : codeFinder.accessDetectedFunctions())
 	{
+		auto& f = p.second;
 		std::string n = f.names.front();
 
 		if (_config->isPic32())
@@ -412,19 +408,17 @@ void Decoder::doStaticCodeRecognition()
 
 		retdec::utils::AddressRange range(f.address, f.address + f.size - 1);
 
-		auto& sc = sfncs[f.address];
-		sc[n] = range;
-	}
-
-	for (auto& p : sfncs)
-	{
-		if (p.second.empty())
+		// Detections come ordered by address, so the hint is always right.
+		// From more detections at the same address, the alphabetically first
+		// name is used.
+		auto sc = _staticCode.emplace_hint(
+				_staticCode.end(),
+				f.address,
+				std::make_pair(n, range));
+		if (n <= sc->second.first)
 		{
-			continue;
+			sc->second = std::make_pair(n, range);
 		}
-
-		auto& front = *p.second.begin();
-		_staticCode[p.first] = std::make_pair(front.first, front.second);
 	}
 }
 
@@ -285,13 +285,13 @@ void DsmGenerator::getAsmInstructionHex(AsmInstruction& ai, std::ostream& ret)
 	static std::size_t longestHexa = _longestInst * 3 - 1;
 	const std::size_t aiHexa = ai.getByteSize() * 3 - 1;
 
-	std::vector<std::uint64_t> bytes;
-	if (_objf->getImage()->get1ByteArray(ai.getAddress(), bytes, ai.getByteSize()))
+	std::vector<std::uint8_t> bytes(ai.getByteSize());
+	if (_objf->getImage()->readBytes(ai.getAddress(), bytes.data(), bytes.size()) == bytes.size())
 	{
 		for (size_t i = 0; i < bytes.size(); ++i)
 		{
 			ret << (i == 0 ? "" : " ") << std::setw(2) << std::setfill('0')
-					<< std::hex << bytes[i];
+					<< std::hex << static_cast<unsigned>(bytes[i]);
 		}
 	}
 	else
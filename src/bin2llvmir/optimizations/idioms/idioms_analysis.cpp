@@ -4,6 +4,8 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
+
 #include "retdec/bin2llvmir/optimizations/idioms/idioms_analysis.h"
 
 using namespace llvm;
@@ -16,17 +18,38 @@ namespace bin2llvmir {
  */
 STATISTIC(NumIdioms, "Number of idioms exchanged in total");
 
+/**
+ * Collect opcodes of all instructions in BasicBlock
+ *
+ * @param bb BasicBlock to collect opcodes of
+ */
+void IdiomsAnalysis::collectOpcodes(llvm::BasicBlock & bb) {
+	bb_opcodes.reset();
+	for (Instruction & i : bb)
+		bb_opcodes.set(i.getOpcode());
+}
+
 /**
  * Analyse given BasicBlock and use instruction exchanger to transform
  * instruction idioms
  *
+ * Exchanger is called only if there is an instruction with one of its root
+ * opcodes in the BasicBlock. Opcodes have to be collected by collectOpcodes()
+ * before the first call for the BasicBlock.
+ *
  * @param bb BasicBlock to analyse
+ * @param opcodes opcodes of all the root instructions of idioms found by
+ *        exchanger (an exchanger may match more than one pattern)
  * @param exchanger instruction idiom exchanger
  * @param fname instruction idiom exchanger name (for debug purpose only)
  */
-bool IdiomsAnalysis::analyse(llvm::BasicBlock & bb, llvm::Instruction * (IdiomsAnalysis::*exchanger)(llvm::BasicBlock::iterator) const, const char * fname) {
+bool IdiomsAnalysis::analyse(llvm::BasicBlock & bb, std::initializer_list<unsigned> opcodes, llvm::Instruction * (IdiomsAnalysis::*exchanger)(llvm::BasicBlock::iterator) const, const char * fname) {
 	bool change_made = false;
 
+	if (std::none_of(opcodes.begin(), opcodes.end(),
+			[this](unsigned opcode) { return bb_opcodes.test(opcode); }))
+		return false;
+
 	for (BasicBlock::iterator iter = bb.begin(), end = bb.end(); iter != end; /**/) {
 		BasicBlock::iterator insn = iter;
 		++iter; // go to next instruction to use valid iterator in next loop
@@ -59,6 +82,10 @@ bool IdiomsAnalysis::analyse(llvm::BasicBlock & bb, llvm::Instruction * (IdiomsA
 		}
 	}
 
+	// Exchanged idioms may have removed or added some opcodes.
+	if (change_made)
+		collectOpcodes(bb);
+
 	return change_made;
 }
 
@@ -92,184 +119,186 @@ bool IdiomsAnalysis::doAnalysis(Function & f, Pass * p) {
 	// Inspect basic-block idioms
 	for (Function::iterator b = f.begin(); b != f.end(); ++b) {
 		BasicBlock & bb = *b;
+		collectOpcodes(bb);
+
 		if (arch == ARCH_POWERPC || arch == ARCH_ARM || arch == ARCH_x86 || arch == ARCH_THUMB || arch == ARCH_ANY)
 			if (cc == CC_GCC || cc == CC_Intel || cc == CC_VStudio || cc == CC_ANY) {
-				change_made |= analyse(bb, &IdiomsMagicDivMod::signedMod1,
+				change_made |= analyse(bb, {Instruction::Add}, &IdiomsMagicDivMod::signedMod1,
 											"IdiomsMagicDivMod::signedMod1");
 
-				change_made |= analyse(bb, &IdiomsMagicDivMod::signedMod2,
+				change_made |= analyse(bb, {Instruction::Add}, &IdiomsMagicDivMod::signedMod2,
 											"IdiomsMagicDivMod::signedMod2");
 
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicUnsignedDiv2,
+				change_made |= analyse(bb, {Instruction::LShr}, &IdiomsMagicDivMod::magicUnsignedDiv2,
 											"IdiomsMagicDivMod::magicUnsignedDiv2");
 
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicUnsignedDiv1,
+				change_made |= analyse(bb, {Instruction::Trunc}, &IdiomsMagicDivMod::magicUnsignedDiv1,
 											"IdiomsMagicDivMod::magicUnsignedDiv1");
 
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv1,
+				change_made |= analyse(bb, {Instruction::Sub}, &IdiomsMagicDivMod::magicSignedDiv1,
 											"IdiomsMagicDivMod::magicSignedDiv1");
 
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv2,
+				change_made |= analyse(bb, {Instruction::Sub}, &IdiomsMagicDivMod::magicSignedDiv2,
 											"IdiomsMagicDivMod::magicSignedDiv2");
 
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv3,
+				change_made |= analyse(bb, {Instruction::Sub}, &IdiomsMagicDivMod::magicSignedDiv3,
 											"IdiomsMagicDivMod::magicSignedDiv3");
 
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv4,
+				change_made |= analyse(bb, {Instruction::Sub}, &IdiomsMagicDivMod::magicSignedDiv4,
 											"IdiomsMagicDivMod::magicSignedDiv4");
 
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv5,
+				change_made |= analyse(bb, {Instruction::Sub}, &IdiomsMagicDivMod::magicSignedDiv5,
 											"IdiomsMagicDivMod::magicSignedDiv5");
 
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv6,
+				change_made |= analyse(bb, {Instruction::Sub}, &IdiomsMagicDivMod::magicSignedDiv6,
 											"IdiomsMagicDivMod::magicSignedDiv6");
 
 				// Found in PowerPC - div 10
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv7pos,
+				change_made |= analyse(bb, {Instruction::Sub}, &IdiomsMagicDivMod::magicSignedDiv7pos,
 											"IdiomsMagicDivMod::magicSignedDiv7pos");
 
 				// Found in PowerPC - the same as previous, but the divisor
 				// is negative, i.e. div -10
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv7neg,
+				change_made |= analyse(bb, {Instruction::Sub}, &IdiomsMagicDivMod::magicSignedDiv7neg,
 											"IdiomsMagicDivMod::magicSignedDiv7neg");
 
 				// Found in PowerPC - div 6
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv8pos,
+				change_made |= analyse(bb, {Instruction::Sub}, &IdiomsMagicDivMod::magicSignedDiv8pos,
 											"IdiomsMagicDivMod::magicSignedDiv8pos");
 
 				// Found in PowerPC - the same as previous, but the divisor
 				// is negative, i.e. div -3
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv8neg,
+				change_made |= analyse(bb, {Instruction::Sub}, &IdiomsMagicDivMod::magicSignedDiv8neg,
 											"IdiomsMagicDivMod::magicSignedDiv8neg");
 
-				change_made |= analyse(bb, &IdiomsMagicDivMod::unsignedMod,
+				change_made |= analyse(bb, {Instruction::Sub}, &IdiomsMagicDivMod::unsignedMod,
 											"IdiomsMagicDivMod::unsignedMod");
 		}
 
 		// all arch
 		if (cc == CC_GCC || cc == CC_ANY)
-			change_made |= analyse(bb, &IdiomsGCC::exchangeSignedModuloByTwo,
+			change_made |= analyse(bb, {Instruction::Sub}, &IdiomsGCC::exchangeSignedModuloByTwo,
 										"IdiomsGCC::exchangeSignedModuloByTwo");
 
 		// PowerPC model lacks FPU and x86 uses x87.
 		if (arch == ARCH_ARM || arch == ARCH_THUMB || arch == ARCH_MIPS || arch == ARCH_ANY)
 			if (cc == CC_GCC || cc == CC_ANY)
-				change_made |= analyse(bb, &IdiomsGCC::exchangeCopysign,
+				change_made |= analyse(bb, {Instruction::Or}, &IdiomsGCC::exchangeCopysign,
 											"IdiomsGCC::exchangeCopysign");
 
 		// PowerPC model lacks FPU and x86 uses x87.
 		if (arch == ARCH_ARM || arch == ARCH_THUMB || arch == ARCH_MIPS || arch == ARCH_ANY)
 			if (cc == CC_GCC || cc == CC_ANY)
-				change_made |= analyse(bb, &IdiomsGCC::exchangeFloatAbs,
+				change_made |= analyse(bb, {Instruction::And}, &IdiomsGCC::exchangeFloatAbs,
 											"IdiomsGCC::exchangeFloatAbs");
 
 		if (arch == ARCH_x86 || arch == ARCH_ANY)
 			if (cc == CC_Intel || cc == CC_VStudio || cc == CC_ANY)
-				change_made |= analyse(bb, &IdiomsVStudio::exchangeOrMinusOneAssign,
+				change_made |= analyse(bb, {Instruction::Or}, &IdiomsVStudio::exchangeOrMinusOneAssign,
 											"IdiomsVStudio::exchangeOrMinusOneAssign");
 
 		if (arch == ARCH_x86 || arch == ARCH_ANY)
 			if (cc == CC_Intel || cc == CC_VStudio || cc == CC_ANY)
-				change_made |= analyse(bb, &IdiomsVStudio::exchangeAndZeroAssign,
+				change_made |= analyse(bb, {Instruction::And}, &IdiomsVStudio::exchangeAndZeroAssign,
 										"IdiomsVStudio::exchangeAndZeroAssign");
 
 		// all arch
 		if (cc == CC_GCC || cc == CC_ANY)
-			change_made |= analyse(bb, &IdiomsGCC::exchangeCondBitShiftDiv1,
+			change_made |= analyse(bb, {Instruction::AShr}, &IdiomsGCC::exchangeCondBitShiftDiv1,
 										"IdiomsGCC::exchangeCondBitShiftDiv1");
 
 		// all arch
 		if (cc == CC_GCC || cc == CC_ANY)
-			change_made |= analyse(bb, &IdiomsGCC::exchangeCondBitShiftDiv2,
+			change_made |= analyse(bb, {Instruction::Sub}, &IdiomsGCC::exchangeCondBitShiftDiv2,
 										"IdiomsGCC::exchangeCondBitShiftDiv2");
 
 		// all arch
 		if (cc == CC_GCC || cc == CC_ANY)
-			change_made |= analyse(bb, &IdiomsGCC::exchangeCondBitShiftDiv3,
+			change_made |= analyse(bb, {Instruction::Sub}, &IdiomsGCC::exchangeCondBitShiftDiv3,
 										"IdiomsGCC::exchangeCondBitShiftDiv3");
 
 		// all arch
 		if (cc == CC_GCC || cc == CC_Intel || cc == CC_LLVM || cc == CC_VStudio || cc == CC_ANY)
-			change_made |= analyse(bb, &IdiomsCommon::exchangeSignedModulo2n,
+			change_made |= analyse(bb, {Instruction::Sub}, &IdiomsCommon::exchangeSignedModulo2n,
 										"IdiomsCommon::exchangeSignedModulo2n");
 
 		// all arch
 		if (cc == CC_GCC || cc == CC_Intel || cc == CC_ANY)
-			change_made |= analyse(bb, &IdiomsCommon::exchangeGreaterEqualZero,
+			change_made |= analyse(bb, {Instruction::Xor, Instruction::LShr}, &IdiomsCommon::exchangeGreaterEqualZero,
 										"IdiomsCommon::exchangeGreaterEqualZero");
 
 		// all arch
 		if (cc == CC_GCC || cc == CC_LLVM || cc == CC_VStudio || cc == CC_ANY)
-			change_made |= analyse(bb, &IdiomsGCC::exchangeXorMinusOne,
+			change_made |= analyse(bb, {Instruction::Xor}, &IdiomsGCC::exchangeXorMinusOne,
 										"IdiomsGCC::exchangeXorMinusOne");
 
 		if (arch == ARCH_POWERPC || arch == ARCH_ARM || arch == ARCH_THUMB || arch == ARCH_MIPS || arch == ARCH_ANY)
 			if (cc == CC_GCC || cc == CC_ANY)
-				change_made |= analyse(bb, &IdiomsCommon::exchangeDivByMinusTwo,
+				change_made |= analyse(bb, {Instruction::Sub}, &IdiomsCommon::exchangeDivByMinusTwo,
 											"IdiomsCommon::exchangeDivByMinusTwo");
 
 		// all arch
 		if (cc == CC_GCC || cc == CC_Intel || cc == CC_LLVM || cc == CC_ANY)
-			change_made |= analyse(bb, &IdiomsCommon::exchangeLessThanZero,
+			change_made |= analyse(bb, {Instruction::LShr}, &IdiomsCommon::exchangeLessThanZero,
 										"IdiomsCommon::exchangeLessThanZero");
 
 		// PowerPC model lacks FPU and x86 uses x87.
 		if (cc == CC_GCC || cc == CC_ANY)
 			if (arch == ARCH_ARM || arch == ARCH_THUMB || arch == ARCH_MIPS || arch == ARCH_ANY)
-				change_made |= analyse(bb, &IdiomsGCC::exchangeFloatNeg,
+				change_made |= analyse(bb, {Instruction::Xor}, &IdiomsGCC::exchangeFloatNeg,
 											"IdiomsGCC::exchangeFloatNeg");
 
 		// all arch
 		if (cc == CC_GCC || cc == CC_ANY)
-			change_made |= analyse(bb, &IdiomsCommon::exchangeUnsignedModulo2n,
+			change_made |= analyse(bb, {Instruction::And}, &IdiomsCommon::exchangeUnsignedModulo2n,
 										"IdiomsCommon::exchangeUnsignedModulo2n");
 
 		// all arch
 		if (cc == CC_LLVM || cc == CC_ANY)
-				change_made |= analyse(bb, &IdiomsLLVM::exchangeIsGreaterThanMinusOne,
+				change_made |= analyse(bb, {Instruction::ICmp}, &IdiomsLLVM::exchangeIsGreaterThanMinusOne,
 											"IdiomsLLVM::exchangeIsGreaterThanMinusOne");
 
 		// all arch
 		// all compilers
-		change_made |= analyse(bb, &IdiomsCommon::exchangeBitShiftSDiv1,
+		change_made |= analyse(bb, {Instruction::Or}, &IdiomsCommon::exchangeBitShiftSDiv1,
 									"IdiomsCommon::exchangeBitShiftSDiv1");
 
 		// all arch
 		// all compilers
-		change_made |= analyse(bb, &IdiomsCommon::exchangeBitShiftSDiv2,
+		change_made |= analyse(bb, {Instruction::AShr}, &IdiomsCommon::exchangeBitShiftSDiv2,
 									"IdiomsCommon::exchangeBitShiftSDiv2");
 
 		// all arch
 		// all compilers
-		change_made |= analyse(bb, &IdiomsCommon::exchangeBitShiftUDiv,
+		change_made |= analyse(bb, {Instruction::LShr}, &IdiomsCommon::exchangeBitShiftUDiv,
 									"IdiomsCommon::exchangeBitShiftUDiv");
 
 		// all arch
 		// all compilers
-		change_made |= analyse(bb, &IdiomsCommon::exchangeBitShiftMul,
+		change_made |= analyse(bb, {Instruction::Shl}, &IdiomsCommon::exchangeBitShiftMul,
 									"IdiomsCommon::exchangeBitShiftMul");
 
 		// all arch
 		if (cc == CC_LLVM || cc == CC_ANY) {
-			change_made |= analyse(bb, &IdiomsLLVM::exchangeIsGreaterThanMinusOne,
+			change_made |= analyse(bb, {Instruction::ICmp}, &IdiomsLLVM::exchangeIsGreaterThanMinusOne,
 										"IdiomsLLVM::exchangeIsGreaterThanMinusOne");
 		}
 
 		// all arch
 		if (cc == CC_LLVM || cc == CC_ANY) {
-			change_made |= analyse(bb, &IdiomsLLVM::exchangeCompareEq,
+			change_made |= analyse(bb, {Instruction::Xor}, &IdiomsLLVM::exchangeCompareEq,
 										"IdiomsLLVM::exchangeCompareEq");
 
 	#if 0
 			/* We do not recognize this well */
-			change_made |= analyse(bb, &IdiomsLLVM::exchangeCompareNeq,
+			change_made |= analyse(bb, {Instruction::Xor}, &IdiomsLLVM::exchangeCompareNeq,
 										"IdiomsLLVM::exchangeCompareNeq");
 	#endif
 
-			change_made |= analyse(bb, &IdiomsLLVM::exchangeCompareSlt,
+			change_made |= analyse(bb, {Instruction::And}, &IdiomsLLVM::exchangeCompareSlt,
 										"IdiomsLLVM::exchangeCompareSlt");
 
-			change_made |= analyse(bb, &IdiomsLLVM::exchangeCompareSle,
+			change_made |= analyse(bb, {Instruction::Or}, &IdiomsLLVM::exchangeCompareSle,
 									"IdiomsLLVM::exchangeCompareSle");
 		}
 	}
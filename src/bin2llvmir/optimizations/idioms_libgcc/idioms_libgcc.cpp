@@ -16,6 +16,7 @@
 #include "retdec/utils/string.h"
 #include "retdec/bin2llvmir/analyses/reaching_definitions.h"
 #include "retdec/bin2llvmir/optimizations/idioms_libgcc/idioms_libgcc.h"
+#include "retdec/bin2llvmir/providers/analyses.h"
 #include "retdec/bin2llvmir/utils/defs.h"
 #include "retdec/bin2llvmir/utils/instruction.h"
 #include "retdec/bin2llvmir/utils/type.h"
@@ -1459,9 +1460,8 @@ bool IdiomsLibgcc::runOnModule(Module& M)
 
 	if (_impl->isSomethingToLocalize())
 	{
-		ReachingDefinitionsAnalysis RDA;
-		RDA.runOnModule(*_module, _config);
-		_impl->localize(RDA);
+		auto* RDA = AnalysesProvider::getReachingDefinitions(_module, _config);
+		_impl->localize(*RDA);
 	}
 //	for (auto* i : _impl->_storesToRemove)
 //	{
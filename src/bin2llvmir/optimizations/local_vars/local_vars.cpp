@@ -14,6 +14,7 @@
 #include "retdec/llvm-support/utils.h"
 #include "retdec/utils/string.h"
 #include "retdec/bin2llvmir/optimizations/local_vars/local_vars.h"
+#include "retdec/bin2llvmir/providers/analyses.h"
 #include "retdec/bin2llvmir/utils/defs.h"
 #include "retdec/bin2llvmir/utils/instruction.h"
 
@@ -58,8 +59,7 @@ bool LocalVars::runOnModule(Module& M)
 		return false;
 	}
 
-	ReachingDefinitionsAnalysis RDA;
-	RDA.runOnModule(M, config);
+	auto& RDA = *AnalysesProvider::getReachingDefinitions(&M, config);
 
 	for (auto &F : M.getFunctionList())
 	for (auto &B : F)
@@ -35,6 +35,7 @@
 #define debug_enabled false
 #include "retdec/llvm-support/utils.h"
 #include "retdec/bin2llvmir/utils/type.h"
+#include "retdec/bin2llvmir/providers/analyses.h"
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
 #include "retdec/bin2llvmir/utils/ir_modifier.h"
 
@@ -151,7 +152,7 @@ bool ParamReturn::run()
 		return false;
 	}
 
-	_RDA.runOnModule(*_module, _config);
+	_RDA = AnalysesProvider::getReachingDefinitions(_module, _config);
 
 //dumpModuleToFile(_module);
 
@@ -161,7 +162,7 @@ bool ParamReturn::run()
 	dumpInfo();
 	applyToIr();
 
-	_RDA.clear();
+	_RDA = nullptr;
 
 //dumpModuleToFile(_module);
 //exit(1);
@@ -188,7 +189,7 @@ void ParamReturn::collectAllCalls()
 						&f,
 						DataFlowEntry(
 								_module,
-								_RDA,
+								*_RDA,
 								_config,
 								_image,
 								_dbgf,
@@ -221,7 +222,7 @@ void ParamReturn::collectAllCalls()
 					calledVal,
 					DataFlowEntry(
 							_module,
-							_RDA,
+							*_RDA,
 							_config,
 							_image,
 							_dbgf,
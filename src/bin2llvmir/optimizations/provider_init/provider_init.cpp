@@ -11,6 +11,7 @@
 #include "retdec/llvm-support/utils.h"
 #include "retdec/bin2llvmir/optimizations/provider_init/provider_init.h"
 #include "retdec/bin2llvmir/providers/abi.h"
+#include "retdec/bin2llvmir/providers/analyses.h"
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
 #include "retdec/bin2llvmir/providers/config.h"
 #include "retdec/bin2llvmir/providers/debugformat.h"
@@ -97,6 +98,7 @@ bool ProviderInitialization::runOnModule(Module& m)
 				f->getImage());
 
 		AsmInstruction::clear();
+		AnalysesProvider::clear();
 
 		firstRun = false;
 	}
@@ -21,6 +21,7 @@
 #include "retdec/utils/time.h"
 #include "retdec/bin2llvmir/analyses/reaching_definitions.h"
 #include "retdec/bin2llvmir/optimizations/simple_types/simple_types.h"
+#include "retdec/bin2llvmir/providers/analyses.h"
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
 #include "retdec/bin2llvmir/utils/defs.h"
 #include "retdec/bin2llvmir/utils/instruction.h"
@@ -81,22 +82,44 @@ bool SimpleTypesAnalysis::runOnModule(Module& M)
 		LOG << "[ABORT] object file is not available\n";
 		return false;
 	}
-	module = &M;
-	_specialGlobal = AsmInstruction::getLlvmToAsmGlobalVariable(module);
 
 	static bool first = true;
+	bool ret = run(M, first);
+	first = false;
+	return ret;
+}
+
+bool SimpleTypesAnalysis::runOnModuleCustom(
+		llvm::Module& M,
+		Config* c,
+		FileImage* o)
+{
+	config = c;
+	objf = o;
+	return run(M, true);
+}
+
+/**
+ * @param M     Module to analyse.
+ * @param first If set, run the whole analysis. Otherwise only fix types of
+ *              global strings used by calls, which is all that is done when
+ *              the pass runs again.
+ */
+bool SimpleTypesAnalysis::run(llvm::Module& M, bool first)
+{
+	module = &M;
+	_specialGlobal = AsmInstruction::getLlvmToAsmGlobalVariable(module);
 
 	if (first)
 	{
-		RDA.runOnModule(M, config);
+		RDA = AnalysesProvider::getReachingDefinitions(&M, config);
 		buildEqSets(M);
 		buildEquations();
 		eqSets.propagate(module);
 		eqSets.apply(module, config, objf, instToErase);
 		eraseObsoleteInstructions();
 		setGlobalConstants();
-		first = false;
-		RDA.clear();
+		RDA = nullptr;
 	}
 	else
 	{
@@ -338,7 +361,12 @@ void SimpleTypesAnalysis::processRoot(Value* root)
 
 		if (eqSet.valSet.size() <= 1 && eqSet.typeSet.size() <= 1 && eqSet.equationSet.size() <= 1)
 		{
-			eqSets.eqSets.pop_back();
+			// Values stay processed, but they do not belong to any set.
+			for (auto& ve : eqSet.valSet)
+			{
+				processedObjs[ve.value] = nullptr;
+			}
+			eqSets.removeLastSet();
 		}
 	}
 }
@@ -400,7 +428,7 @@ void SimpleTypesAnalysis::processUse(llvm::Value* current, Value* u, std::queue<
 					}
 					else
 					{
-						auto uses = RDA.usesFromDef(store);
+						auto uses = RDA->usesFromDef(store);
 						for (auto* u : uses)
 						{
 							toProcess.push(u->use);
@@ -526,7 +554,7 @@ void SimpleTypesAnalysis::processUse(llvm::Value* current, Value* u, std::queue<
 			}
 			else
 			{
-				auto uses = RDA.usesFromDef(user);
+				auto uses = RDA->usesFromDef(user);
 				for (auto* u : uses)
 				{
 					toProcess.push(u->use);
@@ -693,13 +721,14 @@ void SimpleTypesAnalysis::buildEquations()
 				<< llvmObjToString(p.second) << " (" << (fIt2 != processedObjs.end()) << ")"
 				<< std::endl;
 
-		if (fIt1 == processedObjs.end() || fIt2 == processedObjs.end())
+		if (fIt1 == processedObjs.end() || fIt2 == processedObjs.end()
+				|| fIt1->second == nullptr || fIt2->second == nullptr)
 		{
 			LOG << "\t\tskipped" << std::endl;
 			continue;
 		}
 
-		fIt1->second->equationSet.insert( EquationEntry::otherIsPtrToThis(fIt2->second) );
+		fIt1->second->insert(EquationEntry::otherIsPtrToThis(fIt2->second));
 		LOG << "\t\t#" << fIt1->second->id << " otherIsPtrToThis #" << fIt2->second->id << std::endl;
 	}
 }
@@ -720,10 +749,15 @@ void SimpleTypesAnalysis::eraseObsoleteInstructions()
 
 EqSet& EqSetContainer::createEmptySet()
 {
-	eqSets.push_back( EqSet() );
+	eqSets.emplace_back();
 	return eqSets.back();
 }
 
+void EqSetContainer::removeLastSet()
+{
+	eqSets.pop_back();
+}
+
 void EqSetContainer::propagate(llvm::Module* module)
 {
 	for (auto& eq : eqSets)
@@ -769,13 +803,18 @@ EqSet::EqSet() :
 
 }
 
+/**
+ * Insert value @a v with priority @a p, or with a priority from debug info if
+ * @a p is @c PRIORITY_NONE. Duplicates are not checked -- @a v must not be
+ * in any set yet (see @c SimpleTypesAnalysis::processValue()).
+ */
 void EqSet::insert(Config* config, llvm::Value* v, eSourcePriority p)
 {
 	auto& conf = config->getConfig();
 
 	if (p != eSourcePriority::PRIORITY_NONE)
 	{
-		valSet.insert( {v,p} );
+		valSet.emplace_back(v, p);
 	}
 	else
 	{
@@ -827,13 +866,32 @@ void EqSet::insert(Config* config, llvm::Value* v, eSourcePriority p)
 			}
 		}
 
-		valSet.insert( {v,p} );
+		valSet.emplace_back(v, p);
 	}
 }
 
 void EqSet::insert(llvm::Type* t, eSourcePriority p)
 {
-	typeSet.insert( {t,p} );
+	for (auto& te : typeSet)
+	{
+		if (te.type == t)
+		{
+			return;
+		}
+	}
+	typeSet.emplace_back(t, p);
+}
+
+void EqSet::insert(const EquationEntry& e)
+{
+	for (auto& ee : equationSet)
+	{
+		if (ee == e)
+		{
+			return;
+		}
+	}
+	equationSet.push_back(e);
 }
 
 /**
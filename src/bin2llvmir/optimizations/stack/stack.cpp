@@ -14,6 +14,7 @@
 
 #include "retdec/bin2llvmir/analyses/reaching_definitions.h"
 #include "retdec/bin2llvmir/optimizations/stack/stack.h"
+#include "retdec/bin2llvmir/providers/analyses.h"
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
 #include "retdec/bin2llvmir/utils/ir_modifier.h"
 #define debug_enabled false
@@ -71,8 +72,7 @@ bool StackAnalysis::run()
 
 //dumpModuleToFile(_module);
 
-	ReachingDefinitionsAnalysis RDA;
-	RDA.runOnModule(*_module, _config);
+	auto& RDA = *AnalysesProvider::getReachingDefinitions(_module, _config);
 
 	for (auto& f : *_module)
 	{
@@ -0,0 +1,154 @@
+/**
+ * @file src/bin2llvmir/providers/analyses.cpp
+ * @brief Analyses provider for bin2llvmirl.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include <llvm/IR/Instructions.h>
+
+#include "retdec/bin2llvmir/providers/analyses.h"
+
+using namespace llvm;
+
+namespace retdec {
+namespace bin2llvmir {
+
+std::map<AnalysesProvider::RdaKey, AnalysesProvider::CachedReachingDefinitions>
+		AnalysesProvider::_module2rda;
+
+/**
+ * Get reaching definitions of module @a m computed with config @a c and flag
+ * register tracking @a trackFlagRegs. Results are recomputed only for the
+ * functions that changed since the last request.
+ * @return Up to date reaching definitions, or @c nullptr if @a m is not set.
+ */
+ReachingDefinitionsAnalysis* AnalysesProvider::getReachingDefinitions(
+		llvm::Module* m,
+		Config* c,
+		bool trackFlagRegs)
+{
+	if (m == nullptr)
+	{
+		return nullptr;
+	}
+
+	auto& cached = _module2rda[RdaKey(m, trackFlagRegs)];
+	if (!cached.rda.wasRun())
+	{
+		cached.rda.runOnModule(*m, c, trackFlagRegs);
+		for (auto& f : *m)
+		{
+			cached.fingerprints[&f] = getReachingDefinitionsFingerprint(f);
+		}
+		return &cached.rda;
+	}
+
+	std::unordered_map<const Function*, Fingerprint> fingerprints;
+	std::vector<Function*> dirty;
+	for (auto& f : *m)
+	{
+		auto& fp = fingerprints[&f];
+		fp = getReachingDefinitionsFingerprint(f);
+
+		auto fIt = cached.fingerprints.find(&f);
+		if (fIt == cached.fingerprints.end() || fIt->second != fp)
+		{
+			dirty.push_back(&f);
+		}
+	}
+
+	// Results of all the removed and dirty functions are removed before any
+	// are recomputed. Recomputed function may reuse memory of instructions
+	// that were removed from some other function. Dirty functions are
+	// cleared by runOnFunctions() before it analyses them in parallel.
+	//
+	for (auto& p : cached.fingerprints)
+	{
+		if (fingerprints.find(p.first) == fingerprints.end())
+		{
+			cached.rda.clearFunction(p.first);
+		}
+	}
+	cached.rda.runOnFunctions(*m, dirty, c, trackFlagRegs);
+
+	cached.fingerprints = std::move(fingerprints);
+	return &cached.rda;
+}
+
+void AnalysesProvider::clear()
+{
+	_module2rda.clear();
+}
+
+/**
+ * Fingerprint of function @a f made of everything its reaching definitions
+ * depend on: basic blocks and their successors, and loads, stores, allocas,
+ * and calls together with their operands.
+ *
+ * It is the exact sequence of these parts rather than their hash, so a changed
+ * function cannot keep results referring to erased instructions because of
+ * a collision. Numbers of operands and successors, and a zero after the last
+ * instruction of a block, keep the sequence unambiguous.
+ */
+AnalysesProvider::Fingerprint AnalysesProvider::getReachingDefinitionsFingerprint(
+		const llvm::Function& f)
+{
+	auto ptr = [](const void* p) { return reinterpret_cast<std::uintptr_t>(p); };
+
+	Fingerprint fp;
+	for (auto& b : f)
+	{
+		fp.push_back(ptr(&b));
+		for (auto& i : b)
+		{
+			if (!isa<LoadInst>(&i)
+					&& !isa<StoreInst>(&i)
+					&& !isa<AllocaInst>(&i)
+					&& !isa<CallInst>(&i))
+			{
+				continue;
+			}
+
+			fp.push_back(ptr(&i));
+			fp.push_back(i.getOpcode());
+			if (auto* l = dyn_cast<LoadInst>(&i))
+			{
+				fp.push_back(1);
+				fp.push_back(ptr(l->getPointerOperand()));
+			}
+			else if (auto* s = dyn_cast<StoreInst>(&i))
+			{
+				fp.push_back(1);
+				fp.push_back(ptr(s->getPointerOperand()));
+			}
+			else if (auto* call = dyn_cast<CallInst>(&i))
+			{
+				fp.push_back(call->getNumArgOperands());
+				for (auto& a : call->arg_operands())
+				{
+					fp.push_back(ptr(a.get()));
+				}
+			}
+			else
+			{
+				fp.push_back(0);
+			}
+		}
+		fp.push_back(0);
+
+		auto* t = b.getTerminator();
+		unsigned succs = t ? t->getNumSuccessors() : 0;
+		fp.push_back(succs);
+		for (unsigned i = 0; i < succs; ++i)
+		{
+			fp.push_back(ptr(t->getSuccessor(i)));
+		}
+	}
+	return fp;
+}
+
+} // namespace bin2llvmir
+} // namespace retdec
@@ -4,6 +4,9 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
+#include <set>
+
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/InstIterator.h>
 
@@ -11,6 +14,7 @@
 #include "retdec/utils/container.h"
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
 #include "retdec/bin2llvmir/providers/config.h"
+#include "retdec/bin2llvmir/utils/instruction.h"
 #include "retdec/bin2llvmir/utils/type.h"
 
 using namespace retdec::llvm_support;
@@ -19,7 +23,16 @@ using namespace llvm;
 namespace retdec {
 namespace bin2llvmir {
 
+namespace {
+
+/// Maximal number of addresses without instructions inside one range of
+/// the instruction table. More distant addresses start a new range.
+const uint64_t MAX_RANGE_GAP = 0x1000;
+
+} // anonymous namespace
+
 std::vector<std::pair<const llvm::Module*, const llvm::GlobalVariable*>> AsmInstruction::_cache;
+std::vector<AsmInstruction::InstructionTable> AsmInstruction::_tables;
 
 AsmInstruction::AsmInstruction()
 {
@@ -33,6 +46,9 @@ AsmInstruction::AsmInstruction(llvm::Instruction* inst)
 		return;
 	}
 
+	// The mapping instruction is the closest one before @a inst. This depends
+	// on the order of instructions, which the address-indexed table does not
+	// keep, but the walk ends after a few instructions.
 	auto* bb = inst->getParent();
 	while (inst && !isLlvmToAsmInstructionPrivate(inst))
 	{
@@ -93,23 +109,7 @@ AsmInstruction::AsmInstruction(llvm::Module* m, retdec::utils::Address addr)
 		return;
 	}
 
-	ConstantInt* ci = ConstantInt::get(
-			Type::getInt64Ty(m->getContext()),
-			addr,
-			false);
-	if (ci == nullptr)
-	{
-		return;
-	}
-
-	for (auto* u : ci->users())
-	{
-		if (isLlvmToAsmInstructionPrivate(u))
-		{
-			_llvmToAsmInstr = dyn_cast_or_null<StoreInst>(u);
-			return;
-		}
-	}
+	_llvmToAsmInstr = findInInstructionTable(m, addr);
 }
 
 bool AsmInstruction::operator<(const AsmInstruction& o) const
@@ -247,9 +247,192 @@ bool AsmInstruction::isLlvmToAsmInstruction(const llvm::Value* inst)
 	return s->getPointerOperand() == getLlvmToAsmGlobalVariable(m);
 }
 
+/**
+ * Add special LLVM to ASM mapping instruction @a s to the address-indexed table
+ * of its module, so that @c AsmInstruction(llvm::Module*, retdec::utils::Address)
+ * finds it without scanning the module.
+ *
+ * Everyone creating these instructions (i.e. the decoder) must register them,
+ * unregistered instructions created after the table was built are not found.
+ * Erased instructions drop out of the table on their own, moved instructions
+ * stay in it.
+ */
+void AsmInstruction::registerLlvmToAsmInstruction(llvm::StoreInst* s)
+{
+	if (!isLlvmToAsmInstruction(s))
+	{
+		return;
+	}
+	auto* ci = dyn_cast<ConstantInt>(s->getValueOperand());
+	auto* t = getInstructionTable(s->getModule());
+	if (ci == nullptr || t == nullptr)
+	{
+		return;
+	}
+	addToInstructionTable(*t, s, ci->getZExtValue());
+}
+
 void AsmInstruction::clear()
 {
 	_cache.clear();
+	_tables.clear();
+}
+
+/**
+ * Get the address-indexed table of special LLVM to ASM mapping instructions
+ * of module @a m. The table is built by a single pass over users of the
+ * mapping global when it is requested for the first time.
+ * @return Table, or @c nullptr if the module has no mapping global.
+ */
+AsmInstruction::InstructionTable* AsmInstruction::getInstructionTable(
+		const llvm::Module* m)
+{
+	if (m == nullptr)
+	{
+		return nullptr;
+	}
+	for (auto& t : _tables)
+	{
+		if (t.module == m)
+		{
+			return &t;
+		}
+	}
+
+	auto* gv = getLlvmToAsmGlobalVariable(m);
+	if (gv == nullptr)
+	{
+		return nullptr;
+	}
+
+	_tables.emplace_back();
+	auto& t = _tables.back();
+	t.module = m;
+	for (auto* u : gv->users())
+	{
+		auto* s = const_cast<StoreInst*>(dyn_cast<StoreInst>(u));
+		if (s == nullptr
+				|| s->getPointerOperand() != gv
+				|| s->getParent() == nullptr)
+		{
+			continue;
+		}
+		if (auto* ci = dyn_cast<ConstantInt>(s->getValueOperand()))
+		{
+			addToInstructionTable(t, s, ci->getZExtValue());
+		}
+	}
+	return &t;
+}
+
+/**
+ * @return Special LLVM to ASM mapping instruction for address @a addr in
+ * module @a m, or @c nullptr if there is no such instruction in the table.
+ */
+llvm::StoreInst* AsmInstruction::findInInstructionTable(
+		const llvm::Module* m,
+		retdec::utils::Address addr)
+{
+	auto* t = getInstructionTable(m);
+	if (t == nullptr || addr.isUndefined())
+	{
+		return nullptr;
+	}
+	auto* slot = getInstructionTableSlot(*t, addr, false);
+	if (slot == nullptr || *slot == 0)
+	{
+		return nullptr;
+	}
+
+	Value* v = t->markers[*slot - 1];
+	auto* s = dyn_cast_or_null<StoreInst>(v);
+	if (s == nullptr || s->getParent() == nullptr)
+	{
+		return nullptr;
+	}
+	auto* ci = dyn_cast<ConstantInt>(s->getValueOperand());
+	return ci && ci->getZExtValue() == addr ? s : nullptr;
+}
+
+void AsmInstruction::addToInstructionTable(
+		InstructionTable& t,
+		llvm::StoreInst* s,
+		retdec::utils::Address addr)
+{
+	if (addr.isUndefined())
+	{
+		return;
+	}
+	auto* slot = getInstructionTableSlot(t, addr, true);
+	if (*slot && t.markers[*slot - 1] == s)
+	{
+		return;
+	}
+
+	t.markers.emplace_back(s);
+	*slot = t.markers.size();
+}
+
+/**
+ * Get slot for address @a addr in table @a t. If there is no such slot and
+ * @a create is set, the closest range is extended to @a addr (and merged with
+ * its successor if they get close enough), or a new range is started.
+ * @return Slot, or @c nullptr if it does not exist and @a create is not set.
+ */
+unsigned* AsmInstruction::getInstructionTableSlot(
+		InstructionTable& t,
+		retdec::utils::Address addr,
+		bool create)
+{
+	uint64_t a = addr;
+	auto next = std::upper_bound(t.ranges.begin(), t.ranges.end(), a,
+			[](uint64_t a, const InstructionTable::Range& r)
+			{
+				return a < r.start;
+			});
+
+	if (next != t.ranges.begin())
+	{
+		auto prev = next - 1;
+		uint64_t end = prev->start + prev->slots.size();
+		if (a < end)
+		{
+			return &prev->slots[a - prev->start];
+		}
+		if (create && a - end < MAX_RANGE_GAP)
+		{
+			prev->slots.resize(a - prev->start + 1, 0);
+			if (next != t.ranges.end() && next->start - a <= MAX_RANGE_GAP)
+			{
+				prev->slots.resize(next->start - prev->start, 0);
+				prev->slots.insert(
+						prev->slots.end(),
+						next->slots.begin(),
+						next->slots.end());
+				t.ranges.erase(next);
+			}
+			return &prev->slots[a - prev->start];
+		}
+	}
+
+	if (!create)
+	{
+		return nullptr;
+	}
+
+	if (next != t.ranges.end() && next->start - a < MAX_RANGE_GAP)
+	{
+		std::vector<unsigned> slots(next->start - a, 0);
+		slots.insert(slots.end(), next->slots.begin(), next->slots.end());
+		next->slots = std::move(slots);
+		next->start = a;
+		return &next->slots.front();
+	}
+
+	auto r = t.ranges.insert(
+			next,
+			InstructionTable::Range{a, std::vector<unsigned>(1, 0)});
+	return &r->slots.front();
 }
 
 bool AsmInstruction::isValid() const
@@ -440,15 +623,35 @@ AsmInstruction AsmInstruction::getPrev() const
  * @return @c True if instruction can be erase, @c false otherwise.
  */
 bool AsmInstruction::instructionsCanBeErased()
+{
+	return instructionsCanBeErased(std::set<LoadInst*>());
+}
+
+/**
+ * Same as @c instructionsCanBeErased(), but users of loads in @a reloadable
+ * which are outside of this ASM instruction are not taken into account,
+ * because they get their own loads (see @c reloadGlobalsUsedByOthers()).
+ */
+bool AsmInstruction::instructionsCanBeErased(
+		const std::set<llvm::LoadInst*>& reloadable)
 {
 	auto bbs = getBasicBlocks();
+	auto insts = getInstructions();
+	std::set<Instruction*> own(insts.begin(), insts.end());
 
 	retdec::utils::NonIterableSet<const Value*> seen;
 	for (auto it = rbegin(), e = rend(); it != e; ++it)
 	{
 		auto* i = &(*it);
+		auto* l = dyn_cast<LoadInst>(i);
+		bool reload = l && reloadable.count(l);
 		for (auto* u : i->users())
 		{
+			auto* ui = dyn_cast<Instruction>(u);
+			if (reload && ui && own.count(ui) == 0)
+			{
+				continue;
+			}
 			if (seen.hasNot(u) && i != u)
 			{
 				return false;
@@ -472,19 +675,131 @@ bool AsmInstruction::instructionsCanBeErased()
 	return true;
 }
 
+/**
+ * The translator may reuse a register load in the following ASM instructions
+ * of the same basic block (see
+ * @c Capstone2LlvmIrTranslator::setRegisterLoadCaching()). Find loads of
+ * global variables whose users outside of this ASM instruction can be given
+ * their own load -- all such users are in the same basic block and the global
+ * variable is not stored (and no call is made) before the first of them.
+ * Loads used in other basic blocks are not returned.
+ */
+std::set<llvm::LoadInst*> AsmInstruction::getReloadableLoads()
+{
+	std::set<LoadInst*> ret;
+
+	auto insts = getInstructions();
+	std::set<Instruction*> own(insts.begin(), insts.end());
+
+	for (auto* i : insts)
+	{
+		auto* l = dyn_cast<LoadInst>(i);
+		if (l == nullptr || !isa<GlobalVariable>(l->getPointerOperand()))
+		{
+			continue;
+		}
+
+		std::set<Instruction*> users;
+		bool sameBb = true;
+		for (User* u : l->users())
+		{
+			auto* user = dyn_cast<Instruction>(u);
+			if (user == nullptr)
+			{
+				sameBb = false;
+				break;
+			}
+			if (own.count(user))
+			{
+				continue;
+			}
+			if (user->getParent() != l->getParent())
+			{
+				sameBb = false;
+				break;
+			}
+			users.insert(user);
+		}
+		if (!sameBb || users.empty())
+		{
+			continue;
+		}
+
+		Instruction* pos = l->getNextNode();
+		while (users.count(pos) == 0)
+		{
+			pos = pos->getNextNode();
+		}
+
+		if (!isStoredBetween(
+				l->getPointerOperand(),
+				std::next(l->getIterator()),
+				pos->getIterator()))
+		{
+			ret.insert(l);
+		}
+	}
+
+	return ret;
+}
+
+/**
+ * Give users of loads in @a reloadable (see @c getReloadableLoads()) which
+ * are outside of this ASM instruction their own load of the global variable,
+ * placed right before the first of them, so that this ASM instruction does not
+ * have to be kept because of them.
+ */
+void AsmInstruction::reloadGlobalsUsedByOthers(
+		const std::set<llvm::LoadInst*>& reloadable)
+{
+	auto insts = getInstructions();
+	std::set<Instruction*> own(insts.begin(), insts.end());
+
+	for (auto* l : reloadable)
+	{
+		std::vector<Use*> uses;
+		std::set<Instruction*> users;
+		for (Use& u : l->uses())
+		{
+			auto* user = cast<Instruction>(u.getUser());
+			if (own.count(user) == 0)
+			{
+				uses.push_back(&u);
+				users.insert(user);
+			}
+		}
+
+		Instruction* pos = l->getNextNode();
+		while (users.count(pos) == 0)
+		{
+			pos = pos->getNextNode();
+		}
+
+		auto* nl = new LoadInst(l->getPointerOperand(), "", pos);
+		for (Use* u : uses)
+		{
+			u->set(nl);
+		}
+	}
+}
+
 /**
  * If possible (see @c instructionsCanBeErased()), erase LLVM instructions
- * belonging to this ASM instruction.
+ * belonging to this ASM instruction. Loads of global variables used by the
+ * following ASM instructions do not prevent this, their users are given their
+ * own loads (see @c getReloadableLoads()).
  * If instructions can not be erased, they are not changed at all.
  * @return @c True if all instructions were successfully erased,
  *         @c false otherwise.
  */
 bool AsmInstruction::eraseInstructions()
 {
-	if (!instructionsCanBeErased())
+	auto reloadable = getReloadableLoads();
+	if (!instructionsCanBeErased(reloadable))
 	{
 		return false;
 	}
+	reloadGlobalsUsedByOthers(reloadable);
 
 	Function* genRet = nullptr;
 	BasicBlock* nextBb = nullptr;
@@ -561,9 +876,10 @@ llvm::TerminatorInst* AsmInstruction::makeTerminal()
 
 		if (bb == next.getBasicBlock())
 		{
-			next.getBasicBlock()->splitBasicBlock(
+			auto* newBb = next.getBasicBlock()->splitBasicBlock(
 					next.getLlvmToAsmInstruction(),
 					next.getBasicBlockLableName());
+			reloadGlobalsAfterSplit(bb, newBb);
 			auto* b = dyn_cast_or_null<TerminatorInst>(back());
 			assert(b);
 			return b;
@@ -601,9 +917,12 @@ llvm::BasicBlock* AsmInstruction::makeStart()
 		return getBasicBlock();
 	}
 
-	return getBasicBlock()->splitBasicBlock(
+	auto* oldBb = getBasicBlock();
+	auto* newBb = oldBb->splitBasicBlock(
 			_llvmToAsmInstr,
 			getBasicBlockLableName());
+	reloadGlobalsAfterSplit(oldBb, newBb);
+	return newBb;
 }
 
 /**
@@ -86,6 +86,15 @@ retdec::config::Config& Config::getConfig()
 	return _configDB;
 }
 
+/**
+ * @return Path to the config file the config was loaded from and into which
+ * it is saved in @c doFinalization(). Empty if there is no such file.
+ */
+const std::string& Config::getConfigPath() const
+{
+	return _configPath;
+}
+
 llvm::Function* Config::getLlvmFunction(Address startAddr)
 {
 	auto fnc = getConfigFunction(startAddr);
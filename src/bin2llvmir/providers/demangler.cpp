@@ -11,7 +11,10 @@ using namespace llvm;
 namespace retdec {
 namespace bin2llvmir {
 
-std::map<Module*, DemanglerProvider::Demangler> DemanglerProvider::_module2demangler;
+std::map<Module*, retdec::demangler::CDemangler*>
+		DemanglerProvider::_module2demangler;
+std::map<DemanglerProvider::DemanglerKind, DemanglerProvider::Demangler>
+		DemanglerProvider::_demanglers;
 
 /**
  * Create and add to provider a demangler for the given module @a m
@@ -23,28 +26,23 @@ retdec::demangler::CDemangler* DemanglerProvider::addDemangler(
 		llvm::Module* m,
 		const retdec::config::ToolInfoContainer& t)
 {
-	std::unique_ptr<retdec::demangler::CDemangler> d;
-
+	DemanglerKind k = DemanglerKind::GCC;
 	if (t.isGcc())
 	{
-		d = retdec::demangler::CDemangler::createGcc();
+		k = DemanglerKind::GCC;
 	}
 	else if (t.isMsvc())
 	{
-		d = retdec::demangler::CDemangler::createMs();
+		k = DemanglerKind::MS;
 	}
 	else if (t.isBorland())
 	{
-		d = retdec::demangler::CDemangler::createBorland();
-	}
-	else
-	{
-		d = retdec::demangler::CDemangler::createGcc();
+		k = DemanglerKind::BORLAND;
 	}
 
-	auto p = _module2demangler.insert(std::make_pair(m, std::move(d)));
-
-	return p.first->second.get();
+	auto* d = getDemangler(k);
+	_module2demangler[m] = d;
+	return d;
 }
 
 /**
@@ -54,7 +52,7 @@ retdec::demangler::CDemangler* DemanglerProvider::addDemangler(
 retdec::demangler::CDemangler* DemanglerProvider::getDemangler(llvm::Module* m)
 {
 	auto f = _module2demangler.find(m);
-	return f != _module2demangler.end() ? f->second.get() : nullptr;
+	return f != _module2demangler.end() ? f->second : nullptr;
 }
 
 /**
@@ -74,7 +72,45 @@ bool DemanglerProvider::getDemangler(
 }
 
 /**
- * Clear all stored data.
+ * @return Demangler of kind @a k shared by all the modules. It is created when
+ *         it is asked for the first time.
+ */
+retdec::demangler::CDemangler* DemanglerProvider::getDemangler(DemanglerKind k)
+{
+	auto& d = _demanglers[k];
+	if (d == nullptr)
+	{
+		switch (k)
+		{
+			case DemanglerKind::MS:
+				d = retdec::demangler::CDemangler::createMs();
+				break;
+			case DemanglerKind::BORLAND:
+				d = retdec::demangler::CDemangler::createBorland();
+				break;
+			case DemanglerKind::GCC:
+			default:
+				d = retdec::demangler::CDemangler::createGcc();
+				break;
+		}
+	}
+	return d.get();
+}
+
+/**
+ * Create all the shared demanglers in advance, so that the modules processed
+ * later do not have to pay for their instantiation.
+ */
+void DemanglerProvider::preloadDemanglers()
+{
+	getDemangler(DemanglerKind::GCC);
+	getDemangler(DemanglerKind::MS);
+	getDemangler(DemanglerKind::BORLAND);
+}
+
+/**
+ * Clear all stored data. The shared demanglers are kept, they do not hold
+ * any module-specific data.
  */
 void DemanglerProvider::clear()
 {
@@ -226,6 +226,9 @@ Type* ToLlvmTypeVisitor::getLlvmType() const
 //=============================================================================
 //
 
+std::map<Lti::LtiFileKey, std::shared_ptr<retdec::ctypes::Module>>
+		Lti::_ltiFileCache;
+
 Lti::Lti(
 		llvm::Module* m,
 		Config* c,
@@ -235,12 +238,6 @@ Lti::Lti(
 		_config(c),
 		_image(objf)
 {
-	_ltiModule = std::make_unique<retdec::ctypes::Module>(
-			std::make_shared<retdec::ctypes::Context>());
-
-	_ltiParser = ctypesparser::JSONCTypesParser(
-			static_cast<unsigned>(c->getConfig().architecture.getBitSize()));
-
 	for (auto& l : _config->getConfig().parameters.libraryTypeInfoPaths)
 	{
 		if (retdec::utils::startsWith(retdec::utils::stripDirs(l), "cstdlib"))
@@ -288,6 +285,32 @@ Lti::Lti(
 
 void Lti::loadLtiFile(const std::string& filePath)
 {
+	auto bitWidth = static_cast<unsigned>(
+			_config->getConfig().architecture.getBitSize());
+	if (auto m = getLtiFile(filePath, bitWidth))
+	{
+		_ltiModules.push_back(m);
+	}
+}
+
+/**
+ * Get parsed LTI file @a filePath. The file is parsed only once per process,
+ * all the subsequent calls return the cached module.
+ * @param filePath        Path to the LTI JSON file.
+ * @param defaultBitWidth Default bit width of types used by the parser.
+ * @return Parsed LTI module, or @c nullptr if the file can not be read.
+ */
+std::shared_ptr<retdec::ctypes::Module> Lti::getLtiFile(
+		const std::string& filePath,
+		unsigned defaultBitWidth)
+{
+	auto key = std::make_pair(filePath, defaultBitWidth);
+	auto fIt = _ltiFileCache.find(key);
+	if (fIt != _ltiFileCache.end())
+	{
+		return fIt->second;
+	}
+
 	// This could/should be derived from architecture or LLVM module.
 	//
 	static ctypesparser::JSONCTypesParser::TypeWidths typeWidths
@@ -309,6 +332,8 @@ void Lti::loadLtiFile(const std::string& filePath)
 		{"unsigned __int3264", 32} // this has the same size as arch size
 	};
 
+	std::shared_ptr<retdec::ctypes::Module> ret;
+
 	std::ifstream file(filePath);
 	if (file)
 	{
@@ -317,8 +342,24 @@ void Lti::loadLtiFile(const std::string& filePath)
 		{
 			cc = "stdcall";
 		}
-		_ltiParser.parseInto(file, _ltiModule, typeWidths, cc);
+
+		auto m = std::make_unique<retdec::ctypes::Module>(
+				std::make_shared<retdec::ctypes::Context>());
+		ctypesparser::JSONCTypesParser parser(defaultBitWidth);
+		parser.parseInto(file, m, typeWidths, cc);
+		ret = std::move(m);
 	}
+
+	_ltiFileCache.emplace(key, ret);
+	return ret;
+}
+
+/**
+ * Drop all the cached LTI files.
+ */
+void Lti::clearCache()
+{
+	_ltiFileCache.clear();
 }
 
 bool Lti::hasLtiFunction(const std::string& name)
@@ -329,7 +370,16 @@ bool Lti::hasLtiFunction(const std::string& name)
 std::shared_ptr<retdec::ctypes::Function> Lti::getLtiFunction(
 		const std::string& name)
 {
-	return _ltiModule->getFunctionWithName(name);
+	// The first loaded definition wins, the same as if all the files were
+	// parsed into a single module.
+	for (auto& m : _ltiModules)
+	{
+		if (auto f = m->getFunctionWithName(name))
+		{
+			return f;
+		}
+	}
+	return nullptr;
 }
 
 /**
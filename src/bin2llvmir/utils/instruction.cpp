@@ -784,6 +784,100 @@ void insertAtBegin(llvm::Instruction* i, llvm::BasicBlock* bb)
 	}
 }
 
+/**
+ * @return @c True if there is a store to @a ptr or a call in between @a first
+ * (including) and @a last (excluding) instructions of the same basic block.
+ */
+bool isStoredBetween(
+		const llvm::Value* ptr,
+		llvm::BasicBlock::iterator first,
+		llvm::BasicBlock::iterator last)
+{
+	for (auto it = first; it != last; ++it)
+	{
+		if (isa<CallInst>(*it))
+		{
+			return true;
+		}
+		auto* s = dyn_cast<StoreInst>(&*it);
+		if (s && s->getPointerOperand() == ptr)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Reload global variables loaded in @a oldBb whose loaded values are used in
+ * other basic blocks. This is needed when @a oldBb was split into @a oldBb
+ * and @a newBb, because the translator may reuse a register load in the
+ * following instructions of the same block (see
+ * @c Capstone2LlvmIrTranslator::setRegisterLoadCaching()), and such a load
+ * no longer dominates its users once other blocks jump to @a newBb.
+ *
+ * Each new load is placed right before the first of the users in @a newBb, or
+ * before its terminator if there is no such user. A global variable is
+ * reloaded only if it is not stored (and no call is made) between the
+ * original load and the new one, so the loaded value stays the same. Loads
+ * that do not satisfy this are kept as they are.
+ */
+void reloadGlobalsAfterSplit(llvm::BasicBlock* oldBb, llvm::BasicBlock* newBb)
+{
+	for (Instruction& i : *oldBb)
+	{
+		auto* l = dyn_cast<LoadInst>(&i);
+		if (l == nullptr || !isa<GlobalVariable>(l->getPointerOperand()))
+		{
+			continue;
+		}
+
+		std::vector<Use*> uses;
+		std::set<Instruction*> users;
+		for (Use& u : l->uses())
+		{
+			auto* user = dyn_cast<Instruction>(u.getUser());
+			if (user && user->getParent() != oldBb)
+			{
+				uses.push_back(&u);
+				users.insert(user);
+			}
+		}
+		if (uses.empty())
+		{
+			continue;
+		}
+
+		Instruction* pos = newBb->getTerminator();
+		for (Instruction& ni : *newBb)
+		{
+			if (users.count(&ni))
+			{
+				pos = &ni;
+				break;
+			}
+		}
+
+		if (isStoredBetween(
+						l->getPointerOperand(),
+						std::next(l->getIterator()),
+						oldBb->end())
+				|| isStoredBetween(
+						l->getPointerOperand(),
+						newBb->begin(),
+						pos->getIterator()))
+		{
+			continue;
+		}
+
+		auto* nl = new LoadInst(l->getPointerOperand(), "", pos);
+		for (Use* u : uses)
+		{
+			u->set(nl);
+		}
+	}
+}
+
 /**
  * Split the function into two functions at the specified instruction.
  * The original function stays valid -- pointer to it can be used.
@@ -802,6 +896,7 @@ llvm::Function* splitFunctionOn(
 	BasicBlock* newBb = inst->getParent();
 	BasicBlock* oldBb = inst->getParent();
 	newBb = inst->getParent()->splitBasicBlock(inst);
+	reloadGlobalsAfterSplit(oldBb, newBb);
 
 	BasicBlock* prevBb = newBb->getPrevNode();
 	assert(prevBb);
@@ -0,0 +1,103 @@
+/**
+* @file src/bin2llvmir/utils/parallel.cpp
+* @brief Running independent tasks on several threads.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "retdec/bin2llvmir/utils/parallel.h"
+
+namespace retdec {
+namespace bin2llvmir {
+
+/**
+ * Call @a task for all indexes from @c 0 to @a n - 1 using @a threads threads
+ * (the calling thread is one of them). If @a threads is zero, the number of
+ * hardware threads is used. Indexes are taken in increasing order, but tasks
+ * may finish in any order.
+ *
+ * If a task throws, no more tasks are started, all the threads are joined and
+ * the first exception is rethrown in the calling thread.
+ *
+ * Tasks must not modify anything shared with other tasks. In particular, they
+ * must not create LLVM constants or types, or otherwise modify the module or
+ * its context, because LLVM context is not thread-safe.
+ */
+void runInParallel(
+		std::size_t n,
+		const std::function<void(std::size_t)>& task,
+		std::size_t threads)
+{
+	if (threads == 0)
+	{
+		threads = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	threads = std::min(threads, n);
+
+	if (threads <= 1)
+	{
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			task(i);
+		}
+		return;
+	}
+
+	std::atomic<std::size_t> next(0);
+	std::exception_ptr error;
+	std::mutex errorMutex;
+	auto worker = [n, &task, &next, &error, &errorMutex]()
+	{
+		for (auto i = next++; i < n; i = next++)
+		{
+			try
+			{
+				task(i);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(errorMutex);
+				if (!error)
+				{
+					error = std::current_exception();
+				}
+				next = n;
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(threads - 1);
+	for (std::size_t i = 1; i < threads; ++i)
+	{
+		try
+		{
+			workers.emplace_back(worker);
+		}
+		catch (const std::system_error&)
+		{
+			// Run the tasks on the threads that were started.
+			break;
+		}
+	}
+	worker();
+	for (auto& w : workers)
+	{
+		w.join();
+	}
+
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
+} // namespace bin2llvmir
+} // namespace retdec
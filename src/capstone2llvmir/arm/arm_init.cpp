@@ -67,9 +67,9 @@ void Capstone2LlvmIrTranslatorArm::initializeArchSpecific()
 	// Nothing.
 }
 
-std::map<
-	std::size_t,
-	void (Capstone2LlvmIrTranslatorArm::*)(cs_insn* i, cs_arm*, llvm::IRBuilder<>&)>
+const DispatchTable<
+	Capstone2LlvmIrTranslatorArm::TranslationFunction,
+	ARM_INS_ENDING>
 Capstone2LlvmIrTranslatorArm::_i2fm =
 {
 		{ARM_INS_INVALID, nullptr},
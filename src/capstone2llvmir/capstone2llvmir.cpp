@@ -8,6 +8,8 @@
 #include <iomanip>
 #include <iostream>
 
+#include <llvm/IR/IntrinsicInst.h>
+
 #include "retdec/capstone2llvmir/arm/arm.h"
 #include "retdec/capstone2llvmir/capstone2llvmir.h"
 #include "retdec/capstone2llvmir/mips/mips.h"
@@ -821,9 +823,10 @@ Capstone2LlvmIrTranslator::TranslationResult Capstone2LlvmIrTranslator::translat
 
 	_branchGenerated = nullptr;
 	_inCondition = false;
+	_registerLoads.clear();
 
 // TODO: hack, solve better.
-	bool disasmRes = cs_disasm_iter(_handle, &code, &size, &address, insn);
+	bool disasmRes = disasmIter(&code, &size, &address, insn);
 	if (!disasmRes && _arch == CS_ARCH_MIPS && _basicMode == CS_MODE_MIPS32)
 	{
 		modifyBasicMode(CS_MODE_MIPS64);
@@ -842,6 +845,10 @@ Capstone2LlvmIrTranslator::TranslationResult Capstone2LlvmIrTranslator::translat
 		res.size = (insn->address + insn->size) - a;
 
 		translateInstruction(insn, irb);
+		if (_registerLoadCaching)
+		{
+			reuseRegisterLoads(a2l->getParent(), a2l, irb);
+		}
 
 		// TODO: Optimize -- to make generation easier and nicer, some things
 		// can be generated suboptimally. We should inspect every generated
@@ -881,7 +888,7 @@ Capstone2LlvmIrTranslator::TranslationResult Capstone2LlvmIrTranslator::translat
 		insn = cs_malloc(_handle);
 
 // TODO: hack, solve better.
-		disasmRes = cs_disasm_iter(_handle, &code, &size, &address, insn);
+		disasmRes = disasmIter(&code, &size, &address, insn);
 		if (!disasmRes && _arch == CS_ARCH_MIPS && _basicMode == CS_MODE_MIPS32)
 		{
 			modifyBasicMode(CS_MODE_MIPS64);
@@ -898,6 +905,67 @@ Capstone2LlvmIrTranslator::TranslationResult Capstone2LlvmIrTranslator::translat
 	return res;
 }
 
+/**
+ * If @p b is @c true, registers loaded by an instruction are not loaded again
+ * by the following instructions of the same basic block until they are stored
+ * or a call is generated -- the first load is used instead. Register stores
+ * are generated as usual, so all the values stay in registers at instruction
+ * boundaries. However, values loaded by one instruction may be used by other
+ * instructions, which must be taken into account when the block is split or
+ * instructions are erased.
+ */
+void Capstone2LlvmIrTranslator::setRegisterLoadCaching(bool b)
+{
+	_registerLoadCaching = b;
+}
+
+bool Capstone2LlvmIrTranslator::isRegisterLoadCaching() const
+{
+	return _registerLoadCaching;
+}
+
+/**
+ * Use instructions from cache @p cache in translation and in @c disasmIter().
+ * The cache is used only while its modes are the same as the translator's
+ * modes. Pass @c nullptr to stop using the cache. The cache must outlive its
+ * use by the translator.
+ */
+void Capstone2LlvmIrTranslator::setDecodedInstructionCache(
+		const DecodedInstructionCache* cache)
+{
+	_decodedInsns = cache;
+}
+
+/**
+ * Disassemble one instruction in the same way as @c cs_disasm_iter() on the
+ * translator's Capstone handle. If the instruction is in the decoded
+ * instruction cache, it is taken from there.
+ * @param code    Pointer to bytes to disassemble, moved behind the
+ *                instruction on success.
+ * @param size    Size of @p code, decreased on success.
+ * @param address Address of @p code, moved behind the instruction on success.
+ * @param insn    Instruction allocated by @c cs_malloc() on the translator's
+ *                Capstone handle.
+ * @return @c True if the instruction was disassembled, @c false otherwise.
+ */
+bool Capstone2LlvmIrTranslator::disasmIter(
+		const uint8_t** code,
+		size_t* size,
+		uint64_t* address,
+		cs_insn* insn)
+{
+	if (_decodedInsns
+			&& _decodedInsns->getArchitecture() == _arch
+			&& _decodedInsns->getBasicMode() == _basicMode
+			&& _decodedInsns->getExtraMode() == _extraMode
+			&& _decodedInsns->disasmIter(code, size, address, insn))
+	{
+		return true;
+	}
+
+	return cs_disasm_iter(_handle, code, size, address, insn);
+}
+
 llvm::GlobalVariable* Capstone2LlvmIrTranslator::createRegister(
 		uint32_t r,
 		llvm::GlobalValue::LinkageTypes lt,
@@ -1218,6 +1286,71 @@ llvm::Value* Capstone2LlvmIrTranslator::genValueNegate(llvm::IRBuilder<>& irb, l
 	return irb.CreateXor(val, llvm::ConstantInt::getSigned(val->getType(), -1));
 }
 
+/**
+ * Go through instructions generated into @p bb after @p prev (or from the
+ * block start if @p prev is @c nullptr) up to the current insert point of
+ * @p irb, and replace loads of registers by their previous loads, if there
+ * were no stores to the registers in between. See
+ * @c setRegisterLoadCaching().
+ *
+ * Only straight-line code is considered: a call, which may change registers,
+ * ends reuse of all the loads. If the translation left @p bb, nothing is
+ * reused and the next instruction starts in a new block from scratch.
+ */
+void Capstone2LlvmIrTranslator::reuseRegisterLoads(
+		llvm::BasicBlock* bb,
+		llvm::Instruction* prev,
+		llvm::IRBuilder<>& irb)
+{
+	if (irb.GetInsertBlock() != bb)
+	{
+		_registerLoads.clear();
+		return;
+	}
+
+	auto it = prev ? std::next(prev->getIterator()) : bb->begin();
+	auto end = irb.GetInsertPoint();
+	while (it != end)
+	{
+		llvm::Instruction* insn = &*it;
+		++it;
+
+		if (auto* l = llvm::dyn_cast<llvm::LoadInst>(insn))
+		{
+			auto* gv = isRegister(l->getPointerOperand());
+			if (gv == nullptr)
+			{
+				continue;
+			}
+
+			auto& cached = _registerLoads[gv];
+			llvm::Value* v = cached;
+			auto* c = llvm::dyn_cast_or_null<llvm::LoadInst>(v);
+			if (c && c->getParent() == bb && c->getType() == l->getType())
+			{
+				l->replaceAllUsesWith(c);
+				l->eraseFromParent();
+			}
+			else
+			{
+				cached = l;
+			}
+		}
+		else if (auto* s = llvm::dyn_cast<llvm::StoreInst>(insn))
+		{
+			if (auto* gv = isRegister(s->getPointerOperand()))
+			{
+				_registerLoads.erase(gv);
+			}
+		}
+		else if (llvm::isa<llvm::CallInst>(insn)
+				&& !llvm::isa<llvm::IntrinsicInst>(insn))
+		{
+			_registerLoads.clear();
+		}
+	}
+}
+
 llvm::Type* Capstone2LlvmIrTranslator::getIntegerTypeFromByteSize(unsigned sz)
 {
 	auto& ctx = _module->getContext();
@@ -0,0 +1,361 @@
+/**
+ * @file src/capstone2llvmir/decoded_instruction_cache.cpp
+ * @brief Instructions disassembled in advance by several threads.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+
+#include "retdec/capstone2llvmir/decoded_instruction_cache.h"
+
+namespace retdec {
+namespace capstone2llvmir {
+
+namespace {
+
+/// Number of bytes disassembled by a worker at once.
+const std::size_t CHUNK_SIZE = 0x10000;
+
+/**
+ * Fixed-size part of a serialized instruction. It is followed by the
+ * mnemonic, operand string, and used part of the instruction's detail.
+ */
+struct RecordHeader
+{
+	unsigned int id;
+	uint16_t size;
+	uint16_t mnemonicSize;
+	uint16_t opStrSize;
+	uint16_t detailSize;
+	uint8_t bytes[sizeof(cs_insn::bytes)];
+};
+
+/**
+ * Size of the used part of architecture specific detail @p d, i.e. without
+ * the unused trailing operands.
+ */
+template<typename T>
+std::size_t usedSize(const T& d)
+{
+	// Members behind the operands would be lost.
+	static_assert(
+			offsetof(T, operands) + sizeof(T::operands) == sizeof(T),
+			"operands must be the last member of the detail");
+	return offsetof(T, operands) + d.op_count * sizeof(d.operands[0]);
+}
+
+} // anonymous namespace
+
+DecodedInstructionCache::DecodedInstructionCache(
+		cs_arch a,
+		cs_mode basic,
+		cs_mode extra)
+		:
+		_arch(a),
+		_basicMode(basic),
+		_extraMode(extra)
+{
+
+}
+
+/**
+ * Add bytes @p bytes starting at address @p start to be disassembled by the
+ * next @c decode().
+ */
+void DecodedInstructionCache::addRange(
+		retdec::utils::Address start,
+		std::vector<uint8_t>&& bytes)
+{
+	if (start.isUndefined() || bytes.empty())
+	{
+		return;
+	}
+
+	_entries.clear();
+	_chunks.clear();
+	_ranges.push_back(Range{start, std::move(bytes)});
+}
+
+/**
+ * Disassemble all the added ranges by @p threads worker threads. If @p threads
+ * is zero, the number of hardware threads is used.
+ *
+ * Chunks of a range are disassembled independently. Instructions that start
+ * in a chunk may continue into the next chunk of the same range.
+ */
+void DecodedInstructionCache::decode(std::size_t threads)
+{
+	_entries.clear();
+	_chunks.clear();
+
+	std::sort(_ranges.begin(), _ranges.end(),
+			[](const Range& a, const Range& b) { return a.start < b.start; });
+
+	for (auto& r : _ranges)
+	{
+		for (std::size_t begin = 0; begin < r.bytes.size(); begin += CHUNK_SIZE)
+		{
+			Chunk chunk;
+			chunk.range = &r;
+			chunk.begin = begin;
+			chunk.end = std::min(begin + CHUNK_SIZE, r.bytes.size());
+			_chunks.push_back(std::move(chunk));
+		}
+	}
+	if (_chunks.empty())
+	{
+		return;
+	}
+
+	if (threads == 0)
+	{
+		threads = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	threads = std::min(threads, _chunks.size());
+
+	std::atomic<std::size_t> next(0);
+	auto worker = [this, &next]()
+	{
+		csh handle = 0;
+		if (cs_open(_arch, static_cast<cs_mode>(_basicMode + _extraMode), &handle)
+				!= CS_ERR_OK)
+		{
+			return;
+		}
+		if (cs_option(handle, CS_OPT_DETAIL, CS_OPT_ON) != CS_ERR_OK)
+		{
+			cs_close(&handle);
+			return;
+		}
+
+		cs_insn* insn = cs_malloc(handle);
+		for (auto i = next++; i < _chunks.size(); i = next++)
+		{
+			decodeChunk(handle, insn, _chunks[i]);
+		}
+		cs_free(insn, 1);
+		cs_close(&handle);
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(threads - 1);
+	for (std::size_t i = 1; i < threads; ++i)
+	{
+		workers.emplace_back(worker);
+	}
+	worker();
+	for (auto& w : workers)
+	{
+		w.join();
+	}
+
+	// Chunks are sorted and so are instructions in each of them.
+	//
+	for (auto& chunk : _chunks)
+	{
+		for (auto& p : chunk.offsets)
+		{
+			_entries.push_back(Entry{p.first, &chunk, p.second});
+		}
+		chunk.offsets.clear();
+		chunk.offsets.shrink_to_fit();
+	}
+}
+
+/**
+ * Linear disassembly of chunk @p chunk using Capstone handle @p handle and
+ * instruction @p insn allocated for it. Bytes that cannot be disassembled are
+ * skipped.
+ */
+void DecodedInstructionCache::decodeChunk(
+		csh handle,
+		cs_insn* insn,
+		Chunk& chunk) const
+{
+	const auto& bytes = chunk.range->bytes;
+	const uint64_t rangeStart = chunk.range->start;
+	const uint64_t chunkEnd = rangeStart + chunk.end;
+	const auto step = getMinInstructionSize();
+
+	const uint8_t* code = bytes.data() + chunk.begin;
+	size_t size = bytes.size() - chunk.begin;
+	uint64_t address = rangeStart + chunk.begin;
+	while (address < chunkEnd)
+	{
+		if (cs_disasm_iter(handle, &code, &size, &address, insn))
+		{
+			storeInstruction(insn, chunk);
+		}
+		else
+		{
+			auto skip = std::min<size_t>(step, size);
+			if (skip == 0)
+			{
+				break;
+			}
+			code += skip;
+			size -= skip;
+			address += skip;
+		}
+	}
+}
+
+/**
+ * Append serialized instruction @p insn to records of chunk @p chunk.
+ */
+void DecodedInstructionCache::storeInstruction(
+		const cs_insn* insn,
+		Chunk& chunk) const
+{
+	RecordHeader h;
+	h.id = insn->id;
+	h.size = insn->size;
+	h.mnemonicSize = std::strlen(insn->mnemonic);
+	h.opStrSize = std::strlen(insn->op_str);
+	h.detailSize = insn->detail ? getUsedDetailSize(insn->detail) : 0;
+	std::memcpy(h.bytes, insn->bytes, sizeof(h.bytes));
+
+	auto& r = chunk.records;
+	auto offset = r.size();
+	r.resize(offset + sizeof(h) + h.mnemonicSize + h.opStrSize + h.detailSize);
+
+	auto* p = r.data() + offset;
+	std::memcpy(p, &h, sizeof(h));
+	p += sizeof(h);
+	std::memcpy(p, insn->mnemonic, h.mnemonicSize);
+	p += h.mnemonicSize;
+	std::memcpy(p, insn->op_str, h.opStrSize);
+	p += h.opStrSize;
+	if (h.detailSize)
+	{
+		std::memcpy(p, insn->detail, h.detailSize);
+	}
+
+	chunk.offsets.emplace_back(insn->address, offset);
+}
+
+/**
+ * Fill instruction @p insn, which must be allocated by @c cs_malloc() on
+ * a handle with details turned on, from the record of entry @p entry.
+ */
+void DecodedInstructionCache::loadInstruction(
+		const Entry& entry,
+		cs_insn* insn) const
+{
+	RecordHeader h;
+	const auto* p = entry.chunk->records.data() + entry.offset;
+	std::memcpy(&h, p, sizeof(h));
+	p += sizeof(h);
+
+	insn->id = h.id;
+	insn->address = entry.address;
+	insn->size = h.size;
+	std::memcpy(insn->bytes, h.bytes, sizeof(h.bytes));
+	std::memcpy(insn->mnemonic, p, h.mnemonicSize);
+	insn->mnemonic[h.mnemonicSize] = '\0';
+	p += h.mnemonicSize;
+	std::memcpy(insn->op_str, p, h.opStrSize);
+	insn->op_str[h.opStrSize] = '\0';
+	p += h.opStrSize;
+	if (insn->detail)
+	{
+		std::memset(insn->detail, 0, sizeof(cs_detail));
+		std::memcpy(insn->detail, p, h.detailSize);
+	}
+}
+
+cs_arch DecodedInstructionCache::getArchitecture() const
+{
+	return _arch;
+}
+
+cs_mode DecodedInstructionCache::getBasicMode() const
+{
+	return _basicMode;
+}
+
+cs_mode DecodedInstructionCache::getExtraMode() const
+{
+	return _extraMode;
+}
+
+/**
+ * @return Number of instructions in the cache.
+ */
+std::size_t DecodedInstructionCache::size() const
+{
+	return _entries.size();
+}
+
+/**
+ * Get instruction at @p address from the cache. Parameters and their
+ * modification are the same as in @c cs_disasm_iter(). The instruction is
+ * returned only if it fits into @p size bytes of @p code and its bytes are
+ * the same as those in @p code.
+ * @return @c True if the instruction was found, @c false otherwise (nothing
+ * is modified in such a case).
+ */
+bool DecodedInstructionCache::disasmIter(
+		const uint8_t** code,
+		size_t* size,
+		uint64_t* address,
+		cs_insn* insn) const
+{
+	auto it = std::lower_bound(_entries.begin(), _entries.end(), *address,
+			[](const Entry& e, uint64_t a) { return e.address < a; });
+	if (it == _entries.end() || it->address != *address)
+	{
+		return false;
+	}
+
+	RecordHeader h;
+	std::memcpy(&h, it->chunk->records.data() + it->offset, sizeof(h));
+	if (h.size > *size || std::memcmp(*code, h.bytes, h.size) != 0)
+	{
+		return false;
+	}
+
+	loadInstruction(*it, insn);
+	*code += h.size;
+	*size -= h.size;
+	*address += h.size;
+	return true;
+}
+
+/**
+ * @return Number of bytes skipped when the disassembly fails.
+ */
+std::size_t DecodedInstructionCache::getMinInstructionSize() const
+{
+	switch (_arch)
+	{
+		case CS_ARCH_X86: return 1;
+		case CS_ARCH_ARM: return _basicMode == CS_MODE_THUMB ? 2 : 4;
+		default: return 4;
+	}
+}
+
+/**
+ * @return Size of the used part of instruction detail @p detail.
+ */
+std::size_t DecodedInstructionCache::getUsedDetailSize(
+		const cs_detail* detail) const
+{
+	const auto base = offsetof(cs_detail, x86);
+	switch (_arch)
+	{
+		case CS_ARCH_X86: return base + usedSize(detail->x86);
+		case CS_ARCH_ARM: return base + usedSize(detail->arm);
+		case CS_ARCH_ARM64: return base + usedSize(detail->arm64);
+		case CS_ARCH_MIPS: return base + usedSize(detail->mips);
+		case CS_ARCH_PPC: return base + usedSize(detail->ppc);
+		default: return sizeof(cs_detail);
+	}
+}
+
+} // namespace capstone2llvmir
+} // namespace retdec
@@ -370,10 +370,8 @@ void Capstone2LlvmIrTranslatorMips::translateInstruction(
 
 //std::cout << std::hex << i->address << " @ " << i->mnemonic << " " << i->op_str << std::endl;
 
-	auto fIt = _i2fm.find(i->id);
-	if (fIt != _i2fm.end() && fIt->second != nullptr)
+	if (auto f = _i2fm[i->id])
 	{
-		auto f = fIt->second;
 		(this->*f)(i, mi, irb);
 	}
 	else
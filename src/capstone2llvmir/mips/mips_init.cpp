@@ -241,9 +241,9 @@ void Capstone2LlvmIrTranslatorMips::initializeArchSpecific()
 	// Nothing.
 }
 
-std::map<
-	std::size_t,
-	void (Capstone2LlvmIrTranslatorMips::*)(cs_insn* i, cs_mips*, llvm::IRBuilder<>&)>
+const DispatchTable<
+	Capstone2LlvmIrTranslatorMips::TranslationFunction,
+	MIPS_INS_ENDING>
 Capstone2LlvmIrTranslatorMips::_i2fm =
 {
 		{MIPS_INS_INVALID, nullptr},
@@ -265,10 +265,8 @@ void Capstone2LlvmIrTranslatorPowerpc::translateInstruction(
 
 //std::cout << std::hex << i->address << " @ " << i->mnemonic << " " << i->op_str << std::endl;
 
-	auto fIt = _i2fm.find(i->id);
-	if (fIt != _i2fm.end() && fIt->second != nullptr)
+	if (auto f = _i2fm[i->id])
 	{
-		auto f = fIt->second;
 		(this->*f)(i, pi, irb);
 	}
 	else
@@ -370,9 +370,9 @@ void Capstone2LlvmIrTranslatorPowerpc::initializeRegTypeMap()
 	_reg2type = std::move(r2t);
 }
 
-std::map<
-	std::size_t,
-	void (Capstone2LlvmIrTranslatorPowerpc::*)(cs_insn* i, cs_ppc*, llvm::IRBuilder<>&)>
+const DispatchTable<
+	Capstone2LlvmIrTranslatorPowerpc::TranslationFunction,
+	PPC_INS_ENDING>
 Capstone2LlvmIrTranslatorPowerpc::_i2fm =
 {
 		{PPC_INS_INVALID, nullptr},
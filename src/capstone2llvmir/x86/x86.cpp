@@ -7,6 +7,9 @@
 #include <iomanip>
 #include <iostream>
 
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/Transforms/Utils/Local.h>
+
 #include "retdec/capstone2llvmir/x86/x86.h"
 
 namespace retdec {
@@ -264,6 +267,86 @@ llvm::Value* Capstone2LlvmIrTranslatorX86::getCurrentPc(cs_insn* i)
 			i->address + i->size);
 }
 
+/**
+ * @return @c True if @p r is one of the status flags set by arithmetic
+ * instructions (CF, PF, AF, ZF, SF, OF), @c false otherwise.
+ */
+bool Capstone2LlvmIrTranslatorX86::isStatusFlagRegister(uint32_t r) const
+{
+	return r == X86_REG_CF
+			|| r == X86_REG_PF
+			|| r == X86_REG_AF
+			|| r == X86_REG_ZF
+			|| r == X86_REG_SF
+			|| r == X86_REG_OF;
+}
+
+/**
+ * Most instructions set all the status flags, but only a few of them are ever
+ * read before the next instruction overwrites them. Go through instructions
+ * generated into @p bb after @p prev (or from the block start if @p prev is
+ * @c nullptr) up to the current insert point of @p irb, and remove flag
+ * stores overwritten before they could be read, together with the flag
+ * computations that become unused.
+ *
+ * Only straight-line code is considered: a call, which may read the flags
+ * (e.g. a pseudo call or branch), or a new basic block ends the tracking.
+ * Removed stores are dead on the only path that goes through them, so the
+ * result stays correct even if the block is later split at some instruction.
+ */
+void Capstone2LlvmIrTranslatorX86::removeOverwrittenFlagStores(
+		llvm::BasicBlock* bb,
+		llvm::Instruction* prev,
+		llvm::IRBuilder<>& irb)
+{
+	if (irb.GetInsertBlock() != bb)
+	{
+		_unreadFlagStores.clear();
+		return;
+	}
+
+	auto it = prev ? std::next(prev->getIterator()) : bb->begin();
+	auto end = irb.GetInsertPoint();
+	while (it != end)
+	{
+		llvm::Instruction* insn = &*it;
+		++it;
+
+		if (auto* l = llvm::dyn_cast<llvm::LoadInst>(insn))
+		{
+			auto* gv = llvm::dyn_cast<llvm::GlobalVariable>(l->getPointerOperand());
+			auto r = gv ? getCapstoneRegister(gv) : 0;
+			if (isStatusFlagRegister(r))
+			{
+				_unreadFlagStores.erase(r);
+			}
+		}
+		else if (auto* s = llvm::dyn_cast<llvm::StoreInst>(insn))
+		{
+			auto* gv = llvm::dyn_cast<llvm::GlobalVariable>(s->getPointerOperand());
+			auto r = gv ? getCapstoneRegister(gv) : 0;
+			if (!isStatusFlagRegister(r))
+			{
+				continue;
+			}
+
+			auto& unread = _unreadFlagStores[r];
+			if (unread)
+			{
+				auto* val = unread->getValueOperand();
+				unread->eraseFromParent();
+				llvm::RecursivelyDeleteTriviallyDeadInstructions(val);
+			}
+			unread = s;
+		}
+		else if (llvm::isa<llvm::CallInst>(insn)
+				&& !llvm::isa<llvm::IntrinsicInst>(insn))
+		{
+			_unreadFlagStores.clear();
+		}
+	}
+}
+
 uint32_t Capstone2LlvmIrTranslatorX86::getArchByteSize()
 {
 	switch (_origBasicMode)
@@ -284,6 +367,18 @@ uint32_t Capstone2LlvmIrTranslatorX86::getArchBitSize()
 	return getArchByteSize() * 8;
 }
 
+Capstone2LlvmIrTranslator::TranslationResult Capstone2LlvmIrTranslatorX86::translate(
+		const std::vector<uint8_t>& bytes,
+		retdec::utils::Address a,
+		llvm::IRBuilder<>& irb,
+		bool stopOnBranch)
+{
+	// Flags stored by previous translations may be read by code we do not
+	// know about.
+	_unreadFlagStores.clear();
+	return Capstone2LlvmIrTranslator::translate(bytes, a, irb, stopOnBranch);
+}
+
 void Capstone2LlvmIrTranslatorX86::generateRegisters()
 {
 	generateRegistersCommon();
@@ -579,12 +674,14 @@ void Capstone2LlvmIrTranslatorX86::translateInstruction(
 //	assert(!xi->avx_sae);
 //	assert(!xi->avx_rm);
 
-	auto fIt = _i2fm.find(i->id);
-	if (fIt != _i2fm.end() && fIt->second != nullptr)
+	if (auto f = _i2fm[i->id])
 	{
-		auto f = fIt->second;
+		auto* bb = irb.GetInsertBlock();
+		auto ip = irb.GetInsertPoint();
+		llvm::Instruction* prev = ip != bb->begin() ? &*std::prev(ip) : nullptr;
 //std::cout << std::hex << i->address << " @ " << i->mnemonic << " " << i->op_str << std::endl;
 		(this->*f)(i, xi, irb);
+		removeOverwrittenFlagStores(bb, prev, irb);
 	}
 	else
 	{
@@ -432,9 +432,9 @@ void Capstone2LlvmIrTranslatorX86::initializeRegTypeMap()
 	_reg2type = std::move(r2t);
 }
 
-std::map<
-	std::size_t,
-	void (Capstone2LlvmIrTranslatorX86::*)(cs_insn* i, cs_x86*, llvm::IRBuilder<>&)>
+const DispatchTable<
+	Capstone2LlvmIrTranslatorX86::TranslationFunction,
+	X86_INS_ENDING>
 Capstone2LlvmIrTranslatorX86::_i2fm =
 {
 		{X86_INS_INVALID, nullptr},
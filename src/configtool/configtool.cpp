@@ -71,6 +71,7 @@ void printHelp()
 	std::cout << "\t--output-file path" << std::endl;
 	std::cout << "\t--frontend-output-file path" << std::endl;
 	std::cout << "\t--decode-only-selected true/false" << std::endl;
+	std::cout << "\t--skip-static-code true/false" << std::endl;
 	std::cout << "\t--selected-func name" << std::endl;
 	std::cout << "\t--selected-range range" << std::endl;
 	std::cout << "\t--set-fnc-fixed fncName" << std::endl;
@@ -346,6 +347,10 @@ int handleArguments(std::vector<std::string> &args)
 			{
 				config.parameters.setIsSelectedDecodeOnly( (val == "true") ? (true) : (false) );
 			}
+			else if (opt == "--skip-static-code")
+			{
+				config.parameters.setIsSkipStaticCode( (val == "true") ? (true) : (false) );
+			}
 			else if (opt == "--selected-func")
 			{
 				config.parameters.selectedFunctions.insert(val);
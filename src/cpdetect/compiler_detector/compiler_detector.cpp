@@ -9,6 +9,7 @@
 #include "retdec/utils/equality.h"
 #include "retdec/utils/filesystem_path.h"
 #include "retdec/utils/string.h"
+#include "retdec/yara-cache/yara_cache.h"
 #include "retdec/cpdetect/compiler_detector/compiler_detector.h"
 #include "retdec/cpdetect/settings.h"
 #include "retdec/cpdetect/utils/version_solver.h"
@@ -320,7 +321,7 @@ ReturnCode CompilerDetector::getAllSignatures()
 	{
 		for (const auto &item : externalDatabase)
 		{
-			yara.addRuleFile(item);
+			yara.addRuleFile(retdec::yara_cache::getCompiledRuleFile(item));
 		}
 	}
 
@@ -247,11 +247,30 @@ Heuristics::Heuristics(
 			auto secName = fsec->getName();
 			if (!secName.empty()) {
 				sectionNameMap[secName]++;
+				firstSectionMap.emplace(secName, fsec);
 			}
 		}
 	}
 
 	noOfSections = sections.size();
+
+	if (const auto *importTable = fileParser.getImportTable())
+	{
+		for (std::size_t i = 0, e = importTable->getNumberOfLibraries(); i < e; ++i)
+		{
+			const auto library = importTable->getLibrary(i);
+			importedLibraries.insert(library);
+			importedLibrariesLower.insert(toLower(library));
+		}
+	}
+
+	if (const auto *exportTable = fileParser.getExportTable())
+	{
+		for (const auto &exp : *exportTable)
+		{
+			exportNames.insert(exp.getName());
+		}
+	}
 }
 
 /**
@@ -412,18 +431,55 @@ std::size_t Heuristics::findSectionName(const std::string &sectionName) const
 std::size_t Heuristics::findSectionNameStart(const std::string &sectionName) const
 {
 	std::size_t result = 0;
-	for (const Section* section : sections)
+	for (auto it = sectionNameMap.lower_bound(sectionName), e = sectionNameMap.end();
+			it != e && startsWith(it->first, sectionName); ++it)
 	{
-		std::string name = section->getName();
-		if (startsWith(name, sectionName))
-		{
-			result++;
-		}
+		result += it->second;
 	}
 
 	return result;
 }
 
+/**
+ * Get first section which has name equal to @a sectionName
+ * @param sectionName Required section name
+ * @return Pointer to section or @c nullptr if there is no such section
+ */
+const Section* Heuristics::getSectionByName(const std::string &sectionName) const
+{
+	return mapGetValueOrDefault(firstSectionMap, sectionName, nullptr);
+}
+
+/**
+ * Check if file imports library @a libraryName
+ * @param libraryName Name of library
+ * @return @c true if library is imported, @c false otherwise
+ */
+bool Heuristics::hasImportedLibrary(const std::string &libraryName) const
+{
+	return importedLibraries.count(libraryName);
+}
+
+/**
+ * Check if file imports library @a libraryName (case-insensitive)
+ * @param libraryName Name of library
+ * @return @c true if library is imported, @c false otherwise
+ */
+bool Heuristics::hasImportedLibraryCaseInsensitive(const std::string &libraryName) const
+{
+	return importedLibrariesLower.count(toLower(libraryName));
+}
+
+/**
+ * Check if file exports symbol @a exportName
+ * @param exportName Name of exported symbol
+ * @return @c true if symbol is exported, @c false otherwise
+ */
+bool Heuristics::hasExport(const std::string &exportName) const
+{
+	return exportNames.count(exportName);
+}
+
 /**
  * Try to detect tools by section names
  */
@@ -778,7 +834,7 @@ std::string Heuristics::getEmbarcaderoVersion()
 	auto sectionName = commentSectionNameByFormat(fileParser.getFileFormat());
 
 	std::string content;
-	const Section* section = fileParser.getSection(sectionName);
+	const Section* section = getSectionByName(sectionName);
 	if (section && section->getString(content, 0, 0))
 	{
 		// Get offset to version in compiler ID string
@@ -825,7 +881,7 @@ void Heuristics::getEmbarcaderoHeuristics()
 	auto extra = embarcaderoVersionToExtra(version);
 
 	// Special function often exported by Delphi XE5 and higher
-	if (fileParser.getExport("TMethodImplementationIntercept"))
+	if (hasExport("TMethodImplementationIntercept"))
 	{
 		if (!version.empty())
 		{
@@ -942,12 +998,12 @@ std::string Heuristics::getUpxVersion()
 	{
 		// format: $Id: UPX x.xx
 		const std::string pattern = "$Id: UPX ";
-		const auto &content = search.getPlainString();
-		const auto pos = content.find(pattern);
+		const auto content = search.getPlainString();
+		const auto pos = search.findString(pattern);
 		const std::size_t versionLen = 4;
-		if (pos <= content.length() - pattern.length() - versionLen)
+		if (pos <= content.size() - pattern.length() - versionLen)
 		{
-			return content.substr(pos + pattern.length(), versionLen);
+			return content.substr(pos + pattern.length(), versionLen).str();
 		}
 	}
 
@@ -54,7 +54,7 @@ void MachOHeuristics::getGoHeuristic()
 	auto source = DetectionMethod::STRING_SEARCH_H;
 	auto strength = DetectionStrength::MEDIUM;
 
-	const Section* section = fileParser.getSection("__debug_info");
+	const Section* section = getSectionByName("__debug_info");
 	if (!section)
 	{
 		return;
@@ -114,13 +114,7 @@ void MachOHeuristics::getImportTableHeuristic()
 	auto source = DetectionMethod::IMPORT_TABLE_H;
 	auto strength = DetectionStrength::MEDIUM;
 
-	const auto* imports = fileParser.getImportTable();
-	if (!imports)
-	{
-		return;
-	}
-
-	if (imports->hasLibraryCaseInsensitive("libswiftCore"))
+	if (hasImportedLibraryCaseInsensitive("libswiftCore"))
 	{
 		addCompiler(source, strength, "swiftc");
 		addLanguage("Swift");
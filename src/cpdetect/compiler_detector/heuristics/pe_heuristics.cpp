@@ -75,6 +75,27 @@ const std::vector<Signature> x86SlashedSignatures =
 	{"yoda's Protector", "1.03.3", "E803000000/BB55000000E803000000/E88E000000E803000000EB01--E881000000E803000000EB01--E8B7000000E803000000EB01--E8AA000000E803000000EB01--83FB55E803000000EB01--75;", "Ashkbiz Danehkar", 0, 0}
 };
 
+/**
+ * Compile patterns of signatures
+ * @param signatures Signatures
+ * @return Compiled patterns in the same order as @a signatures
+ */
+std::vector<Search::SignaturePattern> compileSignatures(
+		const std::vector<Signature> &signatures)
+{
+	std::vector<Search::SignaturePattern> result;
+	result.reserve(signatures.size());
+	for (const auto &sig : signatures)
+	{
+		result.emplace_back(sig.pattern);
+	}
+
+	return result;
+}
+
+const std::vector<Search::SignaturePattern> x86SlashedPatterns =
+		compileSignatures(x86SlashedSignatures);
+
 const std::vector<std::string> enigmaPatterns =
 {
 	"60E8000000005D81ED--------81ED--------E9;",
@@ -106,12 +127,12 @@ const std::vector<std::string> msvcRuntimeStrings =
  * @param content Content of file
  * @return @c true if string is found, @c false otherwise
  */
-bool findAutoIt(const std::string &content)
+bool findAutoIt(llvm::StringRef content)
 {
 	const std::string prefix = "AU3!EA";
 	const std::regex regExp(prefix + "[0-9]{2}");
 	const auto offset = content.find(prefix);
-	return offset != std::string::npos && regex_match(content.substr(offset, 8), regExp);
+	return offset != llvm::StringRef::npos && regex_match(content.substr(offset, 8).str(), regExp);
 }
 
 
@@ -179,8 +200,7 @@ std::string PeHeuristics::getEnigmaVersion()
 	}
 
 	const std::string pattern = "\0\0\0ENIGMA"s;
-	const auto &content = search.getPlainString();
-	const auto pos = content.find(pattern, sec->getOffset());
+	const auto pos = search.findString(pattern, sec->getOffset());
 	if (pos < sec->getOffset() + sec->getLoadedSize())
 	{
 		std::uint64_t result1, result2;
@@ -202,10 +222,10 @@ std::string PeHeuristics::getEnigmaVersion()
  */
 std::string PeHeuristics::getUpxAdditionalInfo(std::size_t metadataPos)
 {
-	const auto& content = search.getPlainString();
+	const auto content = search.getPlainString();
 
 	std::string info;
-	if (content.length() > metadataPos + 6)
+	if (content.size() > metadataPos + 6)
 	{
 		switch (content[metadataPos + 6])
 		{
@@ -235,7 +255,7 @@ std::string PeHeuristics::getUpxAdditionalInfo(std::size_t metadataPos)
 				break;
 		}
 
-		if (content.length() > metadataPos + 29)
+		if (content.size() > metadataPos + 29)
 		{
 			info += info.empty() ? "" : " ";
 
@@ -256,7 +276,7 @@ void PeHeuristics::getGoHeuristics()
 {
 	auto source = DetectionMethod::STRING_SEARCH_H;
 
-	const Section* section = fileParser.getSection(".text");
+	const Section* section = getSectionByName(".text");
 	if (!section)
 	{
 		return;
@@ -291,9 +311,9 @@ void PeHeuristics::getAutoItHeuristics()
 		addPriorityLanguage("AutoIt", "", true);
 	}
 
-	const auto &content = search.getPlainString();
-	const auto *rsrc = fileParser.getSection(".rsrc");
-	if (rsrc && rsrc->getOffset() < content.length()
+	const auto content = search.getPlainString();
+	const auto *rsrc = getSectionByName(".rsrc");
+	if (rsrc && rsrc->getOffset() < content.size()
 			&& findAutoIt(content.substr(rsrc->getOffset())))
 	{
 		addCompiler(source, strength, "Aut2Exe");
@@ -339,8 +359,9 @@ void PeHeuristics::getSlashedSignatures()
 	}
 
 	const auto stopOffset = toolInfo.epOffset + LIGHTWEIGHT_FILE_SCAN_AREA;
-	for (const auto &sig : x86SlashedSignatures)
+	for (std::size_t i = 0, e = x86SlashedSignatures.size(); i < e; ++i)
 	{
+		const auto &sig = x86SlashedSignatures[i];
 		auto start = toolInfo.epOffset;
 		if (sig.startOffset != std::numeric_limits<unsigned>::max())
 		{
@@ -355,7 +376,7 @@ void PeHeuristics::getSlashedSignatures()
 					+ fileParser.bytesFromNibblesRounded(sig.pattern.length() - 1) - 1);
 		}
 
-		const auto nibbles = search.findSlashedSignature(sig.pattern, start, end);
+		const auto nibbles = search.findSlashedSignature(x86SlashedPatterns[i], start, end);
 		if (nibbles)
 		{
 			addPacker(nibbles, nibbles, sig.name, sig.version, sig.additional);
@@ -424,7 +445,7 @@ void PeHeuristics::getEzirizReactorHeuristics()
 
 	std::string version;
 	if (noOfSections > 3
-			&& fileParser.getSection("reacto")
+			&& getSectionByName("reacto")
 			&& !sections[1]->getSizeInFile()
 			&& !sections[2]->getSizeInFile()
 			&& !sections[3]->getSizeInFile())
@@ -494,9 +515,9 @@ void PeHeuristics::getUpxHeuristics()
 	// UPX 1.00 - UPX 1.07
 	// format: UPX 1.0x
 	const std::string upxVer = "UPX 1.0";
-	const auto &content = search.getPlainString();
-	auto pos = content.find(upxVer);
-	if (pos < 0x500 && pos < content.length() - upxVer.length())
+	const auto content = search.getPlainString();
+	auto pos = search.findString(upxVer);
+	if (pos < 0x500 && pos < content.size() - upxVer.length())
 	{
 		// we must decide between UPX and UPX$HiT
 		source = DetectionMethod::COMBINED;
@@ -519,15 +540,15 @@ void PeHeuristics::getUpxHeuristics()
 	// UPX 1.08 and later
 	// format: x.xx'\0'UPX!
 	const std::size_t minPos = 5, verLen = 4;
-	pos = content.find("UPX!");
+	pos = search.findString("UPX!");
 	if (pos >= minPos && pos < 0x500)
 	{
 		std::string version;
 		std::size_t num;
-		if (strToNum(content.substr(pos - minPos, 1), num)
-				&& strToNum(content.substr(pos - minPos + 2, 2), num))
+		if (strToNum(content.substr(pos - minPos, 1).str(), num)
+				&& strToNum(content.substr(pos - minPos + 2, 2).str(), num))
 		{
-			version = content.substr(pos - minPos, verLen);
+			version = content.substr(pos - minPos, verLen).str();
 		}
 		std::string additionalInfo = getUpxAdditionalInfo(pos);
 		if (!additionalInfo.empty())
@@ -568,11 +589,11 @@ void PeHeuristics::getPeCompactHeuristics()
 	const std::string pattern = "PEC2";
 	const auto patLen = pattern.length();
 
-	const auto &content = search.getPlainString();
-	const auto pos = content.find(pattern);
+	const auto content = search.getPlainString();
+	const auto pos = search.findString(pattern);
 
 	if (pos < 0x500
-			&& pos + patLen + 2 <= content.length()
+			&& pos + patLen + 2 <= content.size()
 			&& content[pos + patLen + 1] == 'O')
 	{
 		for (const auto &item : peCompactMap)
@@ -622,15 +643,15 @@ void PeHeuristics::getEnigmaHeuristics()
 	if (canSearch && toolInfo.entryPointOffset
 			&& search.exactComparison("60E8000000005D83----81ED;", toolInfo.epOffset))
 	{
-		const auto *sec = fileParser.getSection(".data");
+		const auto *sec = getSectionByName(".data");
 		if (sec)
 		{
 			const std::string pattern = "Enigma protector v";
-			const auto &content = search.getPlainString();
-			const auto pos = content.find(pattern, sec->getOffset());
-			if (pos < sec->getOffset() + sec->getSizeInFile() && pos <= content.length() - 4)
+			const auto content = search.getPlainString();
+			const auto pos = search.findString(pattern, sec->getOffset());
+			if (pos < sec->getOffset() + sec->getSizeInFile() && pos <= content.size() - 4)
 			{
-				addPacker(source, strength, "Enigma", content.substr(pos + pattern.length(), 4));
+				addPacker(source, strength, "Enigma", content.substr(pos + pattern.length(), 4).str());
 				return;
 			}
 		}
@@ -682,8 +703,7 @@ void PeHeuristics::getVBoxHeuristics()
 			&& search.exactComparison(sig, toolInfo.epOffset))
 	{
 		std::string version;
-		const auto *table = fileParser.getImportTable();
-		if (table && table->hasLibrary("vboxp410.dll"))
+		if (hasImportedLibrary("vboxp410.dll"))
 		{
 			source = DetectionMethod::LINKED_LIBRARIES_H;
 			strength = DetectionStrength::HIGH;
@@ -705,7 +725,7 @@ void PeHeuristics::getActiveDeliveryHeuristics()
 	const std::string sig =
 		"64A1--------558BEC6A--68--------68--------50648925--------83EC605356578965--FF15;";
 	if (canSearch && toolInfo.entryPointOffset
-			&& fileParser.getSection("actdlvry")
+			&& getSectionByName("actdlvry")
 			&& search.exactComparison(sig, toolInfo.epOffset))
 	{
 		addPacker(source, strength, "Active Delivery");
@@ -740,8 +760,7 @@ void PeHeuristics::getCodeLockHeuristics()
 	auto source = DetectionMethod::LINKED_LIBRARIES_H;
 	auto strength = DetectionStrength::MEDIUM;
 
-	const auto *table = fileParser.getImportTable();
-	if (table && table->hasLibrary("CODE-LOCK.OCX"))
+	if (hasImportedLibrary("CODE-LOCK.OCX"))
 	{
 		addPacker(source, strength, "Code-Lock");
 	}
@@ -860,7 +879,7 @@ void PeHeuristics::getVmProtectHeuristics()
 			addPacker(source, strength, "VMProtect", "2.06");
 			return;
 		}
-		else if (fileParser.getSection(".vmp0")
+		else if (getSectionByName(".vmp0")
 				&& (search.exactComparison("68--------E9;", toolInfo.epOffset)
 					|| search.exactComparison("68--------E8;", toolInfo.epOffset)))
 		{
@@ -871,7 +890,7 @@ void PeHeuristics::getVmProtectHeuristics()
 
 	for (const std::string secName : {".vmp0", ".vmp1", ".vmp2"})
 	{
-		if (fileParser.getSection(secName))
+		if (getSectionByName(secName))
 		{
 			addPacker(source, strength, "VMProtect");
 			return;
@@ -1003,8 +1022,7 @@ void PeHeuristics::getStarforceHeuristic()
 	}
 
 	// Check import table for protect.dll library
-	const auto importTab = peParser.getImportTable();
-	if (importTab && importTab->hasLibraryCaseInsensitive("protect.dll"))
+	if (hasImportedLibraryCaseInsensitive("protect.dll"))
 	{
 		strength = DetectionStrength::HIGH;
 
@@ -1159,7 +1177,7 @@ void PeHeuristics::getRdataHeuristic()
 	auto strength = DetectionStrength::MEDIUM;
 
 	std::string content;
-	const Section* section = fileParser.getSection(".rdata");
+	const Section* section = getSectionByName(".rdata");
 	if (!section || !section->getString(content))
 	{
 		return;
@@ -1203,7 +1221,7 @@ void PeHeuristics::getNullsoftHeuristic()
 	auto source = DetectionMethod::SECTION_TABLE_H;
 	auto strength = DetectionStrength::MEDIUM;
 
-	const Section* section = peParser.getSection(".ndata");
+	const Section* section = getSectionByName(".ndata");
 	if (section && section->getAddress() && !section->getOffset())
 	{
 		unsigned long long address;
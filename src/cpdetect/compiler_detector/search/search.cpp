@@ -5,6 +5,7 @@
  */
 
 #include <algorithm>
+#include <cstring>
 #include <map>
 
 #include "retdec/utils/container.h"
@@ -31,19 +32,107 @@ const std::map<Architecture, std::vector<Search::RelativeJump>> jumpMap =
 	{Architecture::X86_64, {Search::RelativeJump("EB", 1), Search::RelativeJump("E9", 4)}}
 };
 
+const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+/// Minimal size of searched area for which index of 3-byte sequences is used
+const std::size_t TRIGRAM_INDEX_MIN_AREA = 0x100000;
+
+/**
+ * Get index of 3-byte sequence starting at @a data
+ */
+std::size_t getTrigram(const char *data)
+{
+	return static_cast<std::uint8_t>(data[0]) << 16
+		| static_cast<std::uint8_t>(data[1]) << 8
+		| static_cast<std::uint8_t>(data[2]);
+}
+
+/**
+ * Get value of hexadecimal digit
+ * @param c Uppercase hexadecimal digit
+ * @return Value of @a c or -1 if @a c is not a hexadecimal digit
+ */
+int hexDigitValue(char c)
+{
+	if(c >= '0' && c <= '9')
+	{
+		return c - '0';
+	}
+	else if(c >= 'A' && c <= 'F')
+	{
+		return c - 'A' + 10;
+	}
+
+	return -1;
+}
+
+/**
+ * Compile part of signature pattern without slashes
+ * @param nibbles Nibbles of part
+ * @param part Into this parameter is stored compiled part
+ * @return @c false if part contains unsupported character, @c true otherwise
+ */
+bool compilePart(const std::string &nibbles, Search::SignaturePattern::Part &part)
+{
+	part.nibbles = nibbles.size();
+
+	for(std::size_t shift = 0; shift < 2; ++shift)
+	{
+		auto &values = part.values[shift];
+		auto &masks = part.masks[shift];
+		const auto size = (shift + nibbles.size() + 1) / 2;
+		values.assign(size, 0);
+		masks.assign(size, 0);
+
+		for(std::size_t i = 0, e = nibbles.size(); i < e; ++i)
+		{
+			if(nibbles[i] == '-' || nibbles[i] == '?')
+			{
+				continue;
+			}
+
+			const auto value = hexDigitValue(nibbles[i]);
+			if(value < 0)
+			{
+				return false;
+			}
+
+			const auto index = (shift + i) / 2;
+			const auto isHigh = !((shift + i) % 2);
+			values[index] |= isHigh ? value << 4 : value;
+			masks[index] |= isHigh ? 0xF0 : 0x0F;
+		}
+
+		for(std::size_t i = 0, runStart = 0; i < size; ++i)
+		{
+			if(masks[i] != 0xFF)
+			{
+				runStart = i + 1;
+			}
+			else if(i + 1 - runStart > part.anchorSize[shift])
+			{
+				part.anchorStart[shift] = runStart;
+				part.anchorSize[shift] = i + 1 - runStart;
+			}
+		}
+	}
+
+	return true;
+}
+
 } // anonymous namespace
 
 /**
  * Constructor
  * @param fileParser Parser of input file
  */
-Search::Search(retdec::fileformat::FileFormat &fileParser) : parser(fileParser), averageSlashLen(0)
+Search::Search(retdec::fileformat::FileFormat &fileParser) : parser(fileParser), trigramsBuilt(false), averageSlashLen(0)
 {
-	const auto &bytes = parser.getLoadedBytes();
-	bytesToHexString(bytes, nibbles);
-	bytesToString(bytes, plain);
+	const auto bytes = parser.getLoadedBytes();
+	content = bytes;
+	plain = llvm::StringRef(reinterpret_cast<const char*>(bytes.data()), bytes.size());
 	fileLoaded = !bytes.empty();
-	fileSupported = parser.hexToLittle(nibbles) && parser.getNumberOfNibblesInByte();
+	fileSupported = loadLittleEndianContent() && parser.getNumberOfNibblesInByte();
 	jumps = mapGetValueOrDefault(jumpMap, parser.getTargetArchitecture(), std::vector<RelativeJump>());
 
 	for(std::size_t i = 0, e = jumps.size(); i < e; ++i)
@@ -114,6 +203,124 @@ std::size_t Search::RelativeJump::getBytesAfter() const
 	return bytesAfter;
 }
 
+/**
+ * Constructor of SignaturePattern
+ * @param pattern Signature pattern
+ *
+ * Pattern is compiled up to the first semicolon.
+ */
+Search::SignaturePattern::SignaturePattern(const std::string &pattern) : length(0), fixedNibbles(0), valid(true)
+{
+	const auto body = pattern.substr(0, pattern.find(';'));
+	length = body.size();
+
+	std::size_t partStart = 0;
+	do
+	{
+		auto partEnd = body.find('/', partStart);
+		if(partEnd == std::string::npos)
+		{
+			partEnd = body.size();
+		}
+
+		parts.emplace_back();
+		valid &= compilePart(body.substr(partStart, partEnd - partStart), parts.back());
+		partStart = partEnd + 1;
+	} while(partStart <= body.size());
+
+	fixedNibbles = length + 1 - parts.size() - std::count(body.begin(), body.end(), '-') - std::count(body.begin(), body.end(), '?');
+}
+
+/**
+ * Destructor of SignaturePattern
+ */
+Search::SignaturePattern::~SignaturePattern()
+{
+
+}
+
+/**
+ * Get parts of pattern separated by slashes
+ * @return Parts of pattern
+ */
+const std::vector<Search::SignaturePattern::Part>& Search::SignaturePattern::getParts() const
+{
+	return parts;
+}
+
+/**
+ * Get length of pattern in nibbles
+ * @return Length of pattern (each slash is counted as one nibble)
+ */
+std::size_t Search::SignaturePattern::getLength() const
+{
+	return length;
+}
+
+/**
+ * Get number of slashes in pattern
+ * @return Number of slashes in pattern
+ */
+std::size_t Search::SignaturePattern::getNumberOfSlashes() const
+{
+	return parts.size() - 1;
+}
+
+/**
+ * Get number of nibbles which are not wildcards
+ * @return Number of fixed nibbles
+ */
+std::size_t Search::SignaturePattern::getNumberOfFixedNibbles() const
+{
+	return fixedNibbles;
+}
+
+/**
+ * Check if pattern contains only supported characters
+ * @return @c true if pattern is valid, @c false otherwise
+ *
+ * Invalid pattern never matches.
+ */
+bool Search::SignaturePattern::isValid() const
+{
+	return valid;
+}
+
+/**
+ * Make content of file available in little endian
+ * @return @c true if content is available in little endian, @c false otherwise
+ *
+ * Content of little endian file is used directly, content of big endian file
+ * is converted by words into a separate buffer.
+ */
+bool Search::loadLittleEndianContent()
+{
+	if(parser.isUnknownEndian())
+	{
+		return false;
+	}
+	else if(parser.isLittleEndian())
+	{
+		return true;
+	}
+
+	std::string nibbles;
+	bytesToHexString(content.data(), content.size(), nibbles);
+	if(!parser.hexToLittle(nibbles))
+	{
+		return false;
+	}
+
+	swappedContent.resize(nibbles.size() / 2);
+	for(std::size_t i = 0, e = swappedContent.size(); i < e; ++i)
+	{
+		swappedContent[i] = hexDigitValue(nibbles[2 * i]) << 4 | hexDigitValue(nibbles[2 * i + 1]);
+	}
+
+	content = swappedContent;
+	return true;
+}
+
 /**
  * Check is some slashes are defined for target architecture of input file
  * @return @c true if at least one slash pattern is defined for target architecture
@@ -144,6 +351,227 @@ std::size_t Search::bytesFromNibbles(std::size_t nNibbles) const
 	return parser.bytesFromNibbles(nNibbles);
 }
 
+/**
+ * Get number of nibbles in content of file
+ * @return Number of nibbles in content of file
+ */
+std::size_t Search::getNumberOfNibbles() const
+{
+	return content.size() * 2;
+}
+
+/**
+ * Get nibble of content of file
+ * @param nibbleOffset Offset of nibble in content of file
+ * @return Nibble as hexadecimal digit
+ */
+char Search::getNibble(std::size_t nibbleOffset) const
+{
+	const auto byte = content[nibbleOffset / 2];
+	return HEX_DIGITS[nibbleOffset % 2 ? byte & 0x0F : byte >> 4];
+}
+
+/**
+ * Check if part of signature matches content of file on specified offset
+ * @param part Part of signature
+ * @param nibbleOffset Offset of nibble in content of file
+ * @return @c true if part matches, @c false otherwise
+ */
+bool Search::matchesPart(const SignaturePattern::Part &part, std::size_t nibbleOffset) const
+{
+	const auto shift = nibbleOffset % 2;
+	const auto byteOffset = nibbleOffset / 2;
+	const auto &values = part.values[shift];
+	const auto &masks = part.masks[shift];
+	if(byteOffset > content.size() || content.size() - byteOffset < values.size())
+	{
+		return false;
+	}
+
+	const auto *data = content.data() + byteOffset;
+	for(std::size_t i = 0, e = values.size(); i < e; ++i)
+	{
+		if((data[i] & masks[i]) != values[i])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Check if signature matches content of file on specified offset
+ * @param signature Signature pattern
+ * @param nibbleOffset Offset of nibble in content of file
+ * @return @c true if signature matches, @c false otherwise
+ */
+bool Search::matchesSignature(const SignaturePattern &signature, std::size_t nibbleOffset) const
+{
+	if(!signature.isValid())
+	{
+		return false;
+	}
+
+	const auto &parts = signature.getParts();
+	for(std::size_t i = 0, e = parts.size(); i < e; ++i)
+	{
+		if(i)
+		{
+			std::int64_t moveSize = 0;
+			const auto actShift = (parser.getNumberOfNibblesInByte() ? nibbleOffset % parser.getNumberOfNibblesInByte() : 0);
+			const auto *jump = nibbleOffset < getNumberOfNibbles()
+				? getRelativeJump(bytesFromNibbles(nibbleOffset), actShift, moveSize)
+				: nullptr;
+			if(jump)
+			{
+				const auto next = static_cast<std::int64_t>(nibbleOffset + jump->getSlashNibbleSize() +
+					nibblesFromBytes(jump->getBytesAfter())) + moveSize;
+				if(next < 0)
+				{
+					return false;
+				}
+				nibbleOffset = next;
+			}
+			else if(haveSlashes())
+			{
+				return false;
+			}
+		}
+
+		if(!matchesPart(parts[i], nibbleOffset))
+		{
+			return false;
+		}
+		nibbleOffset += parts[i].nibbles;
+	}
+
+	return true;
+}
+
+/**
+ * Find signature in content of file
+ * @param signature Signature pattern
+ * @param firstNibble First nibble offset on which signature may start
+ * @param lastNibble Last nibble offset on which signature may start
+ * @return @c true if signature starts on some offset from selected range, @c false otherwise
+ *
+ * Candidate offsets are found by searching for the longest run of fixed bytes
+ * of the first part of signature, the whole signature is compared only on them.
+ */
+bool Search::findSignature(const SignaturePattern &signature, std::size_t firstNibble, std::size_t lastNibble) const
+{
+	if(!signature.isValid() || firstNibble > lastNibble || firstNibble >= getNumberOfNibbles())
+	{
+		return false;
+	}
+	lastNibble = std::min(lastNibble, getNumberOfNibbles() - 1);
+
+	const auto &head = signature.getParts().front();
+	for(std::size_t shift = 0; shift < 2; ++shift)
+	{
+		if(lastNibble < shift)
+		{
+			continue;
+		}
+
+		const auto firstByte = firstNibble > shift ? (firstNibble - shift + 1) / 2 : 0;
+		const auto lastByte = (lastNibble - shift) / 2;
+		const auto anchorStart = head.anchorStart[shift];
+		const auto anchorSize = head.anchorSize[shift];
+		if(firstByte > lastByte ||
+			firstByte + anchorStart + anchorSize > content.size())
+		{
+			continue;
+		}
+
+		if(!anchorSize)
+		{
+			for(auto byte = firstByte; byte <= lastByte; ++byte)
+			{
+				if(matchesSignature(signature, 2 * byte + shift))
+				{
+					return true;
+				}
+			}
+			continue;
+		}
+
+		const auto *anchor = head.values[shift].data() + anchorStart;
+		const auto *data = content.data();
+		const auto *it = data + firstByte + anchorStart;
+		const auto *end = data + std::min(content.size(), lastByte + anchorStart + anchorSize);
+		while(static_cast<std::size_t>(end - it) >= anchorSize)
+		{
+			it = static_cast<const std::uint8_t*>(std::memchr(it, anchor[0], end - it - anchorSize + 1));
+			if(!it)
+			{
+				break;
+			}
+
+			if(!std::memcmp(it, anchor, anchorSize) &&
+				matchesSignature(signature, 2 * (it - data - anchorStart) + shift))
+			{
+				return true;
+			}
+			++it;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Build index of all 3-byte sequences which are present in file
+ *
+ * Index is built only once, on the first search in a big area of file.
+ */
+void Search::buildTrigramIndex() const
+{
+	if(trigramsBuilt)
+	{
+		return;
+	}
+
+	trigrams.assign((1 << 24) / 64, 0);
+	for(std::size_t i = 0, e = plain.size() < 3 ? 0 : plain.size() - 2; i < e; ++i)
+	{
+		const auto trigram = getTrigram(plain.data() + i);
+		trigrams[trigram / 64] |= std::uint64_t(1) << (trigram % 64);
+	}
+
+	trigramsBuilt = true;
+}
+
+/**
+ * Check if string may be present in file
+ * @param str Coveted string
+ * @param areaSize Size of searched area (in bytes)
+ * @return @c false if @a str is surely not present in file, @c true otherwise
+ *
+ * Search in small areas is fast enough, so the index is consulted only
+ * for big areas.
+ */
+bool Search::mayContainString(const std::string &str, std::size_t areaSize) const
+{
+	if(str.size() < 3 || areaSize < TRIGRAM_INDEX_MIN_AREA)
+	{
+		return true;
+	}
+
+	buildTrigramIndex();
+	for(std::size_t i = 0, e = str.size() - 2; i < e; ++i)
+	{
+		const auto trigram = getTrigram(str.data() + i);
+		if(!(trigrams[trigram / 64] & (std::uint64_t(1) << (trigram % 64))))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 /**
  * Check if input file was successfully loaded
  * @return @c true if file was successfully loaded, @c false otherwise
@@ -162,20 +590,11 @@ bool Search::isFileSupported() const
 	return fileSupported;
 }
 
-/**
- * Get content of file in hexadecimal string representation
- * @return Content of file in hexadecimal string representation
- */
-const std::string& Search::getNibbles() const
-{
-	return nibbles;
-}
-
 /**
  * Get content of file as plain string
  * @return Content of file as plain string
  */
-const std::string& Search::getPlainString() const
+llvm::StringRef Search::getPlainString() const
 {
 	return plain;
 }
@@ -196,8 +615,18 @@ const Search::RelativeJump* Search::getRelativeJump(std::size_t fileOffset, std:
 	for(const auto &jump : jumps)
 	{
 		const auto nibblesAfter = nibblesFromBytes(jump.getBytesAfter());
-		if(!hasSubstringOnPosition(nibbles, jump.getSlash(), nibbleOffset) ||
-			(nibbleOffset + jump.getSlashNibbleSize() + nibblesAfter - 1 >= nibbles.length()))
+		const auto slash = jump.getSlash();
+		if(nibbleOffset + jump.getSlashNibbleSize() + nibblesAfter - 1 >= getNumberOfNibbles())
+		{
+			continue;
+		}
+
+		bool hasSlash = true;
+		for(std::size_t i = 0, e = slash.size(); i < e && hasSlash; ++i)
+		{
+			hasSlash = getNibble(nibbleOffset + i) == slash[i];
+		}
+		if(!hasSlash)
 		{
 			continue;
 		}
@@ -258,6 +687,16 @@ unsigned long long Search::countImpNibbles(const std::string &signPattern) const
 	return count;
 }
 
+/**
+ * Count number of significant nibbles in compiled signature pattern
+ * @param signature Signature pattern
+ * @return Number of significant nibbles in signature pattern
+ */
+unsigned long long Search::countImpNibbles(const SignaturePattern &signature) const
+{
+	return signature.getNumberOfFixedNibbles() + signature.getNumberOfSlashes() * averageSlashLen;
+}
+
 /**
  * Method tells if there is the pattern in selected area of file. Unable for slashed signatures
  * @param signPattern Signature pattern
@@ -267,22 +706,33 @@ unsigned long long Search::countImpNibbles(const std::string &signPattern) const
  */
 unsigned long long Search::findUnslashedSignature(const std::string &signPattern, std::size_t startOffset, std::size_t stopOffset) const
 {
-	if(startOffset > stopOffset)
+	return findUnslashedSignature(SignaturePattern(signPattern), startOffset, stopOffset);
+}
+
+/**
+ * Method tells if there is the pattern in selected area of file. Unable for slashed signatures
+ * @param signature Signature pattern
+ * @param startOffset Start offset in file (in bytes)
+ * @param stopOffset Stop offset in file (in bytes)
+ * @return If pattern is present in area return number of patterns significant nibbles, else return 0
+ *
+ * Whole pattern has to be in selected area.
+ */
+unsigned long long Search::findUnslashedSignature(const SignaturePattern &signature, std::size_t startOffset, std::size_t stopOffset) const
+{
+	if(startOffset > stopOffset || signature.getNumberOfSlashes())
 	{
 		return 0;
 	}
 
-	const auto startIterator = nibbles.begin() + nibblesFromBytes(startOffset);
-	const auto stopIndex = nibblesFromBytes(stopOffset) + 1;
-	const auto stopIterator = stopIndex < nibbles.size() ? nibbles.begin() + stopIndex : nibbles.end();
-	const auto it = std::search(startIterator, stopIterator, signPattern.begin(), signPattern.end(),
-		[] (const char fileNibble, const char signatureNibble)
-		{
-			return fileNibble == signatureNibble || signatureNibble == '-' || signatureNibble == '?' || signatureNibble == ';';
-		}
-	);
+	const auto firstNibble = nibblesFromBytes(startOffset);
+	const auto stopNibble = std::min(nibblesFromBytes(stopOffset + 1), getNumberOfNibbles());
+	if(stopNibble < firstNibble + signature.getLength())
+	{
+		return 0;
+	}
 
-	return (it != stopIterator) ? countImpNibbles(signPattern) : 0;
+	return findSignature(signature, firstNibble, stopNibble - signature.getLength()) ? countImpNibbles(signature) : 0;
 }
 
 /**
@@ -293,6 +743,20 @@ unsigned long long Search::findUnslashedSignature(const std::string &signPattern
  * @return If pattern is not present in area return 0, else return number of patterns significant nibbles
  */
 unsigned long long Search::findSlashedSignature(const std::string &signPattern, std::size_t startOffset, std::size_t stopOffset) const
+{
+	return findSlashedSignature(SignaturePattern(signPattern), startOffset, stopOffset);
+}
+
+/**
+ * Search if there is a slash(es) containing pattern in selected area
+ * @param signature Signature pattern
+ * @param startOffset Start offset in file (in bytes)
+ * @param stopOffset Stop offset in file (in bytes)
+ * @return If pattern is not present in area return 0, else return number of patterns significant nibbles
+ *
+ * Pattern has to start in selected area, but it may continue behind it.
+ */
+unsigned long long Search::findSlashedSignature(const SignaturePattern &signature, std::size_t startOffset, std::size_t stopOffset) const
 {
 	if(startOffset > stopOffset)
 	{
@@ -300,23 +764,15 @@ unsigned long long Search::findSlashedSignature(const std::string &signPattern,
 	}
 
 	const auto areaSize = nibblesFromBytes(stopOffset - startOffset + 1);
-	const auto signSize = signPattern.length() - std::count(signPattern.begin(), signPattern.end(), ';');
+	const auto signSize = signature.getLength();
 	if(areaSize < signSize)
 	{
-		return false;
+		return 0;
 	}
 	const auto iters = (startOffset == stopOffset) ? 1 : areaSize - signSize + 1;
+	const auto firstNibble = nibblesFromBytes(startOffset);
 
-	for(std::size_t i = 0; i < iters; ++i)
-	{
-		const auto result = exactComparison(signPattern, startOffset, i);
-		if(result)
-		{
-			return result;
-		}
-	}
-
-	return 0;
+	return findSignature(signature, firstNibble, firstNibble + iters - 1) ? countImpNibbles(signature) : 0;
 }
 
 /**
@@ -328,39 +784,19 @@ unsigned long long Search::findSlashedSignature(const std::string &signPattern,
  */
 unsigned long long Search::exactComparison(const std::string &signPattern, std::size_t fileOffset, std::size_t shift) const
 {
-	for(std::size_t sigIndex = 0, fileIndex = nibblesFromBytes(fileOffset) + shift, fileLen = nibbles.length();
-		fileIndex < fileLen; ++sigIndex, ++fileIndex)
-	{
-		if(sigIndex == signPattern.length() || signPattern[sigIndex] == ';')
-		{
-			return countImpNibbles(signPattern);
-		}
-		else if(signPattern[sigIndex] == '/')
-		{
-			std::int64_t moveSize = 0;
-			const auto actShift = (parser.getNumberOfNibblesInByte() ? fileIndex % parser.getNumberOfNibblesInByte() : 0);
-			const auto *jump = getRelativeJump(bytesFromNibbles(fileIndex), actShift, moveSize);
-			if(!jump)
-			{
-				if(!haveSlashes())
-				{
-					--fileIndex;
-					continue;
-				}
-
-				return 0;
-			}
-
-			// move after one nibble is in header of cycle
-			fileIndex += jump->getSlashNibbleSize() + nibblesFromBytes(jump->getBytesAfter()) + moveSize - 1;
-		}
-		else if(signPattern[sigIndex] != nibbles[fileIndex] && signPattern[sigIndex] != '-' && signPattern[sigIndex] != '?')
-		{
-			return 0;
-		}
-	}
+	return exactComparison(SignaturePattern(signPattern), fileOffset, shift);
+}
 
-	return 0;
+/**
+ * Try find signature @a signature at specified offset
+ * @param signature Signature pattern
+ * @param fileOffset Offset in file
+ * @param shift Relative shift in nibbles from @a fileOffset
+ * @return Number of significant nibbles of signature or 0 if content of file and signature are different
+ */
+unsigned long long Search::exactComparison(const SignaturePattern &signature, std::size_t fileOffset, std::size_t shift) const
+{
+	return matchesSignature(signature, nibblesFromBytes(fileOffset) + shift) ? countImpNibbles(signature) : 0;
 }
 
 /**
@@ -377,7 +813,7 @@ bool Search::countSimilarity(const std::string &signPattern, Similarity &sim, st
 {
 	Similarity result;
 
-	for(std::size_t sigIndex = 0, fileIndex = nibblesFromBytes(fileOffset) + shift, fileLen = nibbles.length(); fileIndex < fileLen; ++sigIndex, ++fileIndex)
+	for(std::size_t sigIndex = 0, fileIndex = nibblesFromBytes(fileOffset) + shift, fileLen = getNumberOfNibbles(); fileIndex < fileLen; ++sigIndex, ++fileIndex)
 	{
 		if(sigIndex == signPattern.length() || signPattern[sigIndex] == ';')
 		{
@@ -413,7 +849,7 @@ bool Search::countSimilarity(const std::string &signPattern, Similarity &sim, st
 			}
 			continue;
 		}
-		else if(signPattern[sigIndex] == nibbles[fileIndex])
+		else if(signPattern[sigIndex] == getNibble(fileIndex))
 		{
 			++result.same;
 		}
@@ -473,6 +909,23 @@ bool Search::areaSimilarity(const std::string &signPattern, Similarity &sim, std
 	return result;
 }
 
+/**
+ * Find first occurrence of string in file
+ * @param str Coveted string
+ * @param startOffset Offset in file from which search starts
+ * @return Offset of @a str in file or @c std::string::npos if file does
+ *    not contain @a str behind @a startOffset
+ */
+std::size_t Search::findString(const std::string &str, std::size_t startOffset) const
+{
+	if(startOffset >= plain.size() || !mayContainString(str, plain.size() - startOffset))
+	{
+		return std::string::npos;
+	}
+
+	return plain.find(str, startOffset);
+}
+
 /**
  * Check if file contains specified substring
  * @param str Coveted substring
@@ -480,7 +933,7 @@ bool Search::areaSimilarity(const std::string &signPattern, Similarity &sim, std
  */
 bool Search::hasString(const std::string &str) const
 {
-	return contains(plain, str);
+	return findString(str) != std::string::npos;
 }
 
 /**
@@ -491,7 +944,7 @@ bool Search::hasString(const std::string &str) const
  */
 bool Search::hasString(const std::string &str, std::size_t fileOffset) const
 {
-	return hasSubstringOnPosition(plain, str, fileOffset);
+	return fileOffset < plain.size() && plain.substr(fileOffset).startswith(str);
 }
 
 /**
@@ -503,7 +956,13 @@ bool Search::hasString(const std::string &str, std::size_t fileOffset) const
  */
 bool Search::hasString(const std::string &str, std::size_t startOffset, std::size_t stopOffset) const
 {
-	return hasSubstringInArea(plain, str, startOffset, stopOffset);
+	if(startOffset > stopOffset || startOffset >= plain.size())
+	{
+		return false;
+	}
+
+	const auto area = plain.slice(startOffset, stopOffset + 1);
+	return mayContainString(str, area.size()) && area.find(str) != llvm::StringRef::npos;
 }
 
 /**
@@ -551,7 +1010,7 @@ bool Search::createSignature(std::string &pattern, std::size_t fileOffset, std::
 {
 	pattern.clear();
 
-	for(std::size_t i = 0, fileIndex = nibblesFromBytes(fileOffset), fileLen = nibbles.length(), nibbleSize = nibblesFromBytes(size);
+	for(std::size_t i = 0, fileIndex = nibblesFromBytes(fileOffset), fileLen = getNumberOfNibbles(), nibbleSize = nibblesFromBytes(size);
 		fileIndex < fileLen && i < nibbleSize; ++i, ++fileIndex)
 	{
 		std::int64_t moveSize = 0;
@@ -564,7 +1023,7 @@ bool Search::createSignature(std::string &pattern, std::size_t fileOffset, std::
 		}
 		else
 		{
-			pattern += nibbles[fileIndex];
+			pattern += getNibble(fileIndex);
 		}
 	}
 
@@ -4,6 +4,7 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <algorithm>
 #include <climits>
 #include <cmath>
 #include <vector>
@@ -22,6 +23,10 @@ namespace {
 
 constexpr auto CRC16_POLY = 0x8408U;
 
+/// Size of blocks of data fed to digests by getCrc32Md5Sha256(). It has to
+/// fit into the L1/L2 cache together with the states of the digests.
+constexpr std::uint64_t MULTI_HASH_CHUNK_SIZE = 32 * 1024;
+
 } // anonymous namespace
 
 /**
@@ -126,5 +131,46 @@ std::string getSha256(const unsigned char *data, std::uint64_t length)
 	return sha;
 }
 
+/**
+ * @brief Count CRC32, MD5 and SHA256 of @a data in a single pass.
+ * @param[in] data Input data.
+ * @param[in] length Length of input data.
+ * @param[out] crc32 CRC32 of input data.
+ * @param[out] md5 MD5 of input data.
+ * @param[out] sha256 SHA256 of input data.
+ *
+ * The results are the same as the results of getCrc32(), getMd5() and
+ * getSha256(), but the data are fed to all the digests by cache-sized blocks,
+ * so every block is read from memory only once.
+ */
+void getCrc32Md5Sha256(const unsigned char *data, std::uint64_t length,
+		std::string &crc32, std::string &md5, std::string &sha256)
+{
+	CRC32 crcCtx;
+	MD5_CTX md5Ctx;
+	SHA256_CTX sha256Ctx;
+	MD5_Init(&md5Ctx);
+	SHA256_Init(&sha256Ctx);
+
+	for (std::uint64_t offset = 0; offset < length; offset += MULTI_HASH_CHUNK_SIZE)
+	{
+		const auto size = static_cast<std::size_t>(
+				std::min(MULTI_HASH_CHUNK_SIZE, length - offset));
+		crcCtx.add(data + offset, size);
+		MD5_Update(&md5Ctx, data + offset, size);
+		SHA256_Update(&sha256Ctx, data + offset, size);
+	}
+
+	crc32 = crcCtx.getHash();
+
+	std::vector<unsigned char> md5Digest(MD5_DIGEST_LENGTH);
+	MD5_Final(md5Digest.data(), &md5Ctx);
+	retdec::utils::bytesToHexString(md5Digest, md5, 0, 0, false);
+
+	std::vector<unsigned char> sha256Digest(SHA256_DIGEST_LENGTH);
+	SHA256_Final(sha256Digest.data(), &sha256Ctx);
+	retdec::utils::bytesToHexString(sha256Digest, sha256, 0, 0, false);
+}
+
 } // namespace crypto
 } // namespace retdec
@@ -0,0 +1,831 @@
+/**
+ * @file src/decompilertool/decompiler.cpp
+ * @brief Decompiles binary file into the target high-level language.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ *
+ * This tool runs both bin2llvmir and llvmir2hll inside a single process.
+ * The LLVM module, the config and the loaded input file are handed from
+ * bin2llvmir to llvmir2hll directly -- there is no bitcode round-trip and the
+ * config is not re-parsed between the stages.
+ *
+ * The bin2llvmir part accepts the same passes as bin2llvmir (they are run in
+ * the order specified), the llvmir2hll part accepts the same parameters as
+ * llvmir2hll. Both stages share the @c -config-path parameter.
+ *
+ * With @c -server, the tool does not decompile a single file but serves
+ * decompilation jobs read from the standard input (see @c runServer()).
+ */
+
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <llvm/ADT/Triple.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Analysis/ScalarEvolution.h>
+#include <llvm/Analysis/TargetLibraryInfo.h>
+#include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/Bitcode/BitcodeWriterPass.h>
+#include <llvm/IR/IRPrintingPasses.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/LegacyPassNameParser.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/IRReader/IRReader.h>
+#include <llvm/InitializePasses.h>
+#include <llvm/LinkAllIR.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/ManagedStatic.h>
+#include <llvm/Support/PrettyStackTrace.h>
+#include <llvm/Support/Signals.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/ToolOutputFile.h>
+
+#include "retdec/bin2llvmir/providers/config.h"
+#include "retdec/bin2llvmir/providers/demangler.h"
+#include "retdec/bin2llvmir/providers/lti.h"
+#include "retdec/config/config.h"
+#include "retdec/llvm-support/diagnostics.h"
+#include "retdec/llvmir2hll/llvmir2hll.h"
+#include "retdec/utils/memory.h"
+#include "retdec/utils/os.h"
+
+#ifdef OS_POSIX
+	#include <sys/types.h>
+	#include <sys/wait.h>
+	#include <unistd.h>
+#endif
+
+using namespace llvm;
+
+static cl::opt<bool>
+ServerMode("server",
+		cl::desc("Run as a decompilation server: read jobs in the form "
+			"'<config-path> <output-path>' from the standard input, one per "
+			"line, and keep the loaded databases between them (POSIX only)."),
+		cl::init(false));
+
+//
+// bin2llvmir parameters.
+//
+
+// The OptimizationList is automatically populated with registered Passes by the
+// PassNameParser.
+//
+static cl::list<const PassInfo*, bool, PassNameParser>
+PassList(cl::desc("Optimizations available:"));
+
+static cl::opt<std::string>
+OutputFilename("o", cl::desc("Output filename"),
+		cl::value_desc("filename"));
+
+static cl::opt<std::string>
+BitcodeOutputFilename("bitcode-output",
+		cl::desc("If set, the LLVM IR module produced by the bin2llvmir part "
+			"is also written into this file (and into its .ll variant)."),
+		cl::value_desc("filename"),
+		cl::init(""));
+
+// Does not work with std::size_t or std::uint64_t (passing -max-memory=100
+// fails with "Cannot find option named '100'!"), so we have to use unsigned
+// long long, which should be 64b.
+static cl::opt<unsigned long long>
+MaxMemoryLimit("max-memory",
+		cl::desc("Limit maximal memory to the given number of bytes (0 means no limit)."),
+		cl::init(0));
+
+static cl::opt<bool>
+MaxMemoryLimitHalfRAM("max-memory-half-ram",
+		cl::desc("Limit maximal memory to half of system RAM."),
+		cl::init(false));
+
+static cl::opt<bool>
+NoVerify("disable-verify", cl::desc("Do not run the verifier"), cl::Hidden);
+
+static cl::opt<bool>
+VerifyEach("verify-each", cl::desc("Verify after each transform"));
+
+// The following parameters are accepted only to keep the list of passes
+// interchangeable with bin2llvmir.
+static cl::opt<bool>
+DisableInline("disable-inlining", cl::desc("Do not run the inliner pass"));
+
+static cl::opt<bool>
+DisableSimplifyLibCalls("disable-simplify-libcalls",
+		cl::desc("Disable simplify-libcalls"));
+
+//
+// llvmir2hll parameters.
+//
+
+static cl::opt<std::string>
+TargetHLL("target-hll",
+		cl::desc("Name of the target HLL (set to 'help' to list all the supported HLLs)."),
+		cl::init("!bad!"));
+
+// We cannot use just -debug because it has been already registered :(.
+static cl::opt<bool>
+Debug("enable-debug",
+		cl::desc("Enables the emission of debugging messages, like information about the current phase."),
+		cl::init(false));
+
+static cl::opt<std::string>
+Semantics("semantics",
+		cl::desc("The used semantics in the form 'sem1,sem2,...'."
+			" When not given, the semantics is created based on the data in the input LLVM IR."
+			" If you want to use no semantics, set this to 'none'."),
+		cl::init(""));
+
+static cl::opt<bool>
+EmitDebugComments("emit-debug-comments",
+		cl::desc("Emits debugging comments in the generated code."),
+		cl::init(false));
+
+static cl::opt<std::string>
+EnabledOpts("enabled-opts",
+		cl::desc("A comma separated list of optimizations to be enabled, i.e. only they will run."),
+		cl::init(""));
+
+static cl::opt<std::string>
+DisabledOpts("disabled-opts",
+		cl::desc("A comma separated list of optimizations to be disabled, i.e. they will not run."),
+		cl::init(""));
+
+static cl::opt<bool>
+NoOpts("no-opts",
+		cl::desc("Disables all optimizations."),
+		cl::init(false));
+
+static cl::opt<bool>
+AggressiveOpts("aggressive-opts",
+		cl::desc("Enables aggressive optimizations."),
+		cl::init(false));
+
+static cl::opt<bool>
+NoVarRenaming("no-var-renaming",
+		cl::desc("Disables renaming of variables."),
+		cl::init(false));
+
+static cl::opt<bool>
+NoSymbolicNames("no-symbolic-names",
+		cl::desc("Disables conversion of constants into symbolic names."),
+		cl::init(false));
+
+static cl::opt<bool>
+KeepAllBrackets("keep-all-brackets",
+		cl::desc("All brackets in the generated code will be kept."),
+		cl::init(false));
+
+static cl::opt<bool>
+KeepUnreachableFuncs("keep-unreachable-funcs",
+		cl::desc("Functions that are unreachable from the main function will be kept, not removed."),
+		cl::init(false));
+
+static cl::opt<bool>
+KeepLibraryFunctions("keep-library-funcs",
+		cl::desc("Functions from standard libraries will be kept, not turned into declarations."),
+		cl::init(false));
+
+static cl::opt<bool>
+NoTimeVaryingInfo("no-time-varying-info",
+		cl::desc("Do not emit time-varying information, like dates."),
+		cl::init(false));
+
+static cl::opt<bool>
+NoCompoundOperators("no-compound-operators",
+		cl::desc("Do not emit compound operators (like +=) instead of assignments."),
+		cl::init(false));
+
+static cl::opt<bool>
+ValidateModule("validate-module",
+		cl::desc("Validates the resulting module before generating the target code."),
+		cl::init(false));
+
+static cl::opt<std::string>
+FindPatterns("find-patterns",
+		cl::desc("If set, runs the selected comma-separated pattern finders "
+			"(set to 'all' to run all of them)."),
+		cl::init(""));
+
+static cl::opt<std::string>
+AliasAnalysis("alias-analysis",
+		cl::desc("Name of the used alias analysis "
+			"(the default is 'simple'; set to 'help' to list all the supported analyses)."),
+		cl::init("simple"));
+
+static cl::opt<std::string>
+VarNameGen("var-name-gen",
+		cl::desc("Name of the used generator of variable names "
+			"(the default is 'fruit'; set to 'help' to list all the supported generators)."),
+		cl::init("fruit"));
+
+static cl::opt<std::string>
+VarNameGenPrefix("var-name-gen-prefix",
+		cl::desc("Prefix for all variable names returned by the used generator of variable names "
+			"(the default is '')."),
+		cl::init(""));
+
+static cl::opt<std::string>
+VarRenamer("var-renamer",
+		cl::desc("Name of the used renamer of variable names "
+			"(the default is 'readable'; set to 'help' to list all the supported renamers)."),
+		cl::init("readable"));
+
+static cl::opt<std::string>
+LLVMIR2BIRConverter("llvmir2bir-converter",
+		cl::desc("Name of the used convereter of LLVM IR to BIR "
+			"(the default is 'orig'; set to 'help' to list all the supported renamers)."),
+		cl::init("orig"));
+
+static cl::opt<bool>
+EmitCFGs("emit-cfgs",
+		cl::desc("Enables the emission of control-flow graphs (CFGs) for each "
+			"function (creates a separate file for each function in the resulting module)."),
+		cl::init(false));
+
+static cl::opt<std::string>
+CFGWriter("cfg-writer",
+		cl::desc("Name of the used CFG writer (set to 'help' to list all "
+			"the supported writers, the default is 'dot')."),
+		cl::init("dot"));
+
+static cl::opt<bool>
+EmitCG("emit-cg",
+		cl::desc("Emits a call graph (CG) for the decompiled module."),
+		cl::init(false));
+
+static cl::opt<std::string>
+CGWriter("cg-writer",
+		cl::desc("Name of the used CG writer (set to 'help' to list all "
+			"the supported writers, the default is 'dot')."),
+		cl::init("dot"));
+
+static cl::opt<std::string>
+CallInfoObtainer("call-info-obtainer",
+		cl::desc("Name of the used obtainer of information about function calls (set to "
+			"'help' to list all the supported obtainers, the default is 'optim')."),
+		cl::init("optim"));
+
+static cl::opt<std::string>
+ArithmExprEvaluator("arithm-expr-evaluator",
+		cl::desc("Name of the used evaluator of arithmetical expressions (set to "
+			"'help' to list all the supported evaluators, the default is 'c')."),
+		cl::init("c"));
+
+static cl::opt<std::string>
+ForcedModuleName("force-module-name",
+		cl::desc("If nonempty, overwrites the module name that was detected/generated by the front-end. "
+			"This includes the identifier of the input LLVM IR module as well as module names in debug information."),
+		cl::init(""));
+
+static cl::opt<bool>
+StrictFPUSemantics("strict-fpu-semantics",
+		cl::desc("Forces strict FPU semantics to be used. "
+			"This option may result into more correct code, although slightly less readable."),
+		cl::init(false));
+
+/**
+ * This pass just prints phase information about other, subsequent passes.
+ * In pass manager, it should be placed right before the pass which phase info
+ * it is printing.
+ */
+class ModulePassPrinter : public ModulePass
+{
+	public:
+		static char ID;
+		std::string PhaseName;
+		std::string PassName;
+
+	public:
+		ModulePassPrinter(const std::string phaseName) :
+				ModulePass(ID),
+				PhaseName(phaseName),
+				PassName("ModulePass Printer: " + PhaseName)
+		{
+
+		}
+
+		bool runOnModule(Module &M) override
+		{
+			retdec::llvm_support::printPhase(PhaseName);
+			return false;
+		}
+
+		const char *getPassName() const override
+		{
+			return PassName.c_str();
+		}
+
+		void getAnalysisUsage(AnalysisUsage &AU) const override
+		{
+			AU.setPreservesAll();
+		}
+};
+char ModulePassPrinter::ID = 0;
+
+/**
+ * Add the pass to the pass manager + possible verification.
+ */
+static inline void addPassWithPossibleVerification(
+		legacy::PassManagerBase &PM,
+		Pass *P,
+		const std::string& phaseName = std::string())
+{
+	std::string pn = phaseName.empty() ? P->getPassName() : phaseName;
+
+	PM.add(new ModulePassPrinter(pn));
+	PM.add(P);
+
+	// If we are verifying all of the intermediate steps, add the verifier...
+	if (VerifyEach)
+	{
+		PM.add(createVerifierPass());
+	}
+}
+
+/**
+* Limits the maximal memory of the tool based on the command-line parameters.
+*/
+void limitMaximalMemoryIfRequested()
+{
+	if (MaxMemoryLimitHalfRAM)
+	{
+		auto limitationSucceeded = retdec::utils::limitSystemMemoryToHalfOfTotalSystemMemory();
+		if (!limitationSucceeded)
+		{
+			throw std::runtime_error("failed to limit maximal memory to half of system RAM");
+		}
+	}
+	else if (MaxMemoryLimit > 0)
+	{
+		auto limitationSucceeded = retdec::utils::limitSystemMemory(MaxMemoryLimit);
+		if (!limitationSucceeded)
+		{
+			throw std::runtime_error(
+				"failed to limit maximal memory to " + std::to_string(MaxMemoryLimit)
+			);
+		}
+	}
+}
+
+/**
+ * Call a bunch of LLVM initialization functions, same as the original opt.
+ */
+void initializeLlvmPasses()
+{
+	// Initialize passes
+	PassRegistry &Registry = *PassRegistry::getPassRegistry();
+	initializeCore(Registry);
+	initializeScalarOpts(Registry);
+	initializeIPO(Registry);
+	initializeAnalysis(Registry);
+	initializeTransformUtils(Registry);
+	initializeInstCombine(Registry);
+	initializeTarget(Registry);
+}
+
+/**
+ * Create an empty input module.
+ */
+std::unique_ptr<Module> createLlvmModule(LLVMContext& Context)
+{
+	SMDiagnostic Err;
+
+	std::string c = "; ModuleID = 'test'\nsource_filename = \"test\"\n";
+	auto mb = llvm::MemoryBuffer::getMemBuffer(c);
+	if (mb == nullptr)
+	{
+		throw std::runtime_error("failed to create llvm::MemoryBuffer");
+	}
+	std::unique_ptr<Module> M = parseIR(mb->getMemBufferRef(), Err, Context);
+	if (M == nullptr)
+	{
+		throw std::runtime_error("failed to create llvm::Module");
+	}
+
+	if (!NoVerify && verifyModule(*M, &errs()))
+	{
+		throw std::runtime_error("created llvm::Module is broken");
+	}
+
+	return M;
+}
+
+/**
+ * Create output file object.
+ */
+std::unique_ptr<tool_output_file> createOutputFile(const std::string& path)
+{
+	std::error_code EC;
+	std::unique_ptr<tool_output_file> Out(
+			new tool_output_file(path, EC, sys::fs::F_None));
+	if (EC)
+	{
+		throw std::runtime_error(
+			"failed to create llvm::tool_output_file for " + path + ": "
+			+ EC.message()
+		);
+	}
+
+	return Out;
+}
+
+/**
+ * Returns the options of llvmir2hll based on the command-line parameters.
+ */
+retdec::llvmir2hll::LlvmIr2HllOptions getLlvmIr2HllOptions()
+{
+	retdec::llvmir2hll::LlvmIr2HllOptions options;
+	options.targetHll = TargetHLL;
+	options.debug = Debug;
+	options.semantics = Semantics;
+	options.emitDebugComments = EmitDebugComments;
+	options.enabledOpts = EnabledOpts;
+	options.disabledOpts = DisabledOpts;
+	options.noOpts = NoOpts;
+	options.aggressiveOpts = AggressiveOpts;
+	options.noVarRenaming = NoVarRenaming;
+	options.noSymbolicNames = NoSymbolicNames;
+	options.keepAllBrackets = KeepAllBrackets;
+	options.keepUnreachableFuncs = KeepUnreachableFuncs;
+	options.keepLibraryFunctions = KeepLibraryFunctions;
+	options.noTimeVaryingInfo = NoTimeVaryingInfo;
+	options.noCompoundOperators = NoCompoundOperators;
+	options.validateModule = ValidateModule;
+	options.findPatterns = FindPatterns;
+	options.aliasAnalysis = AliasAnalysis;
+	options.varNameGen = VarNameGen;
+	options.varNameGenPrefix = VarNameGenPrefix;
+	options.varRenamer = VarRenamer;
+	options.llvmir2BirConverter = LLVMIR2BIRConverter;
+	options.emitCfgs = EmitCFGs;
+	options.cfgWriter = CFGWriter;
+	options.emitCg = EmitCG;
+	options.cgWriter = CGWriter;
+	options.callInfoObtainer = CallInfoObtainer;
+	options.arithmExprEvaluator = ArithmExprEvaluator;
+	options.forcedModuleName = ForcedModuleName;
+	options.strictFpuSemantics = StrictFPUSemantics;
+	options.outputFilename = OutputFilename;
+	return options;
+}
+
+/**
+ * Run the bin2llvmir part -- passes given on the command line -- on the
+ * module.
+ */
+void runBin2Llvmir(Module& M)
+{
+	// Add an appropriate TargetLibraryInfo pass for the module's triple.
+	Triple ModuleTriple(M.getTargetTriple());
+	TargetLibraryInfoImpl TLII(ModuleTriple);
+
+	legacy::PassManager Passes;
+
+	// The -disable-simplify-libcalls flag actually disables all builtin optzns.
+	if (DisableSimplifyLibCalls)
+	{
+		TLII.disableAllFunctions();
+	}
+	Passes.add(new TargetLibraryInfoWrapperPass(TLII));
+
+	// Add internal analysis passes from the target machine.
+	Passes.add(createTargetTransformInfoWrapperPass(TargetIRAnalysis()));
+
+	// Create a new optimization pass for each one specified on the command line
+	for (unsigned i = 0; i < PassList.size(); ++i)
+	{
+		const PassInfo *PassInf = PassList[i];
+		Pass *P = nullptr;
+		if (PassInf->getTargetMachineCtor())
+		{
+			P = PassInf->getTargetMachineCtor()(nullptr);
+		}
+		else if (PassInf->getNormalCtor())
+		{
+			P = PassInf->getNormalCtor()();
+		}
+		else
+		{
+			throw std::runtime_error(std::string("cannot create pass: ")
+					+ PassInf->getPassName());
+		}
+
+		if (P)
+		{
+			addPassWithPossibleVerification(Passes, P);
+		}
+	}
+
+	// Check that the module is well formed on completion of optimization
+	if (!NoVerify && !VerifyEach)
+	{
+		Passes.add(createVerifierPass());
+	}
+
+	// The module is kept in memory, it is written only on request.
+	std::unique_ptr<tool_output_file> bcOut;
+	std::unique_ptr<tool_output_file> llOut;
+	if (!BitcodeOutputFilename.empty())
+	{
+		std::string out = BitcodeOutputFilename;
+		std::string llOutName = out + ".ll";
+		if (out.find_last_of('.') != std::string::npos)
+		{
+			llOutName = out.substr(0, out.find_last_of('.')) + ".ll";
+		}
+
+		bcOut = createOutputFile(out);
+		llOut = createOutputFile(llOutName);
+		Passes.add(createBitcodeWriterPass(bcOut->os(), true));
+		Passes.add(createPrintModulePass(llOut->os(), "", true));
+	}
+
+	Passes.run(M);
+
+	if (bcOut)
+	{
+		bcOut->keep();
+	}
+	if (llOut)
+	{
+		llOut->keep();
+	}
+}
+
+/**
+ * Run the llvmir2hll part on the module produced by @c runBin2Llvmir().
+ */
+void runLlvmIr2Hll(Module& M)
+{
+	auto options = getLlvmIr2HllOptions();
+
+	// Hand over the config used by bin2llvmir. It was saved at the end of the
+	// bin2llvmir part, llvmir2hll saves its changes into the same file.
+	if (auto* c = retdec::bin2llvmir::ConfigProvider::getConfig(&M))
+	{
+		options.config = &c->getConfig();
+		options.configPath = c->getConfigPath();
+	}
+
+	auto out = createOutputFile(OutputFilename);
+
+	legacy::PassManager pm;
+
+	// Add an appropriate TargetLibraryInfo pass for the module's triple.
+	TargetLibraryInfoImpl tlii(Triple(M.getTargetTriple()));
+	pm.add(new TargetLibraryInfoWrapperPass(tlii));
+
+	pm.add(new LoopInfoWrapperPass());
+	pm.add(new ScalarEvolutionWrapperPass());
+	pm.add(new retdec::llvmir2hll::LlvmIr2Hll(out->os(), options));
+
+	pm.run(M);
+
+	out->keep();
+}
+
+/**
+ * Decompile a single input -- run both parts on a fresh module.
+ */
+void decompile()
+{
+	LLVMContext Context;
+	std::unique_ptr<Module> M = createLlvmModule(Context);
+
+	runBin2Llvmir(*M);
+	runLlvmIr2Hll(*M);
+}
+
+#ifdef OS_POSIX
+
+/**
+ * Set the config path used by the provider initialization of bin2llvmir.
+ * The parameter is registered in the bin2llvmir library, so it has to be
+ * looked up by its name.
+ */
+void setConfigPath(const std::string& path)
+{
+	auto& opts = cl::getRegisteredOptions();
+	auto it = opts.find("config-path");
+	if (it == opts.end())
+	{
+		throw std::runtime_error("parameter -config-path is not registered");
+	}
+	static_cast<cl::opt<std::string>*>(it->second)->setValue(path);
+}
+
+/**
+ * Load all the immutable databases the job with the given config needs into
+ * this process, so that the job does not have to do it on its own.
+ */
+void preloadJobData(const std::string& configPath)
+{
+	try
+	{
+		auto config = retdec::config::Config::fromFile(configPath);
+		auto bitSize = static_cast<unsigned>(
+				config.architecture.getBitSize());
+		for (auto& l : config.parameters.libraryTypeInfoPaths)
+		{
+			retdec::bin2llvmir::Lti::getLtiFile(l, bitSize);
+		}
+	}
+	catch (const std::exception&)
+	{
+		// Let the job itself report the broken config.
+	}
+}
+
+/**
+ * Run a single job of the server in a child process.
+ * @return Exit code of the job.
+ */
+int runServerJob(const std::string& configPath, const std::string& outputPath)
+{
+	pid_t pid = fork();
+	if (pid < 0)
+	{
+		throw std::runtime_error("fork() failed");
+	}
+	else if (pid == 0)
+	{
+		int ret = EXIT_SUCCESS;
+		try
+		{
+			setConfigPath(configPath);
+			OutputFilename = outputPath;
+			decompile();
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "Error: " << e.what() << std::endl;
+			ret = EXIT_FAILURE;
+		}
+
+		std::cout.flush();
+		std::cerr.flush();
+		outs().flush();
+		errs().flush();
+		_exit(ret);
+	}
+
+	int status = 0;
+	if (waitpid(pid, &status, 0) < 0)
+	{
+		throw std::runtime_error("waitpid() failed");
+	}
+	if (WIFEXITED(status))
+	{
+		return WEXITSTATUS(status);
+	}
+	return 128 + (WIFSIGNALED(status) ? WTERMSIG(status) : 0);
+}
+
+/**
+ * Serve decompilation jobs read from the standard input.
+ *
+ * Each line of the input is one job in the form
+ * @code
+ * <config-path> <output-path>
+ * @endcode
+ * where the config is the one prepared for bin2llvmir. For each job, exactly
+ * one line is written into the standard output: either
+ * <tt>OK <output-path></tt> or <tt>ERROR <exit-code> <output-path></tt>.
+ * The progress of the jobs is written into the standard error.
+ *
+ * The databases that do not depend on the decompiled file (demanglers,
+ * semantics, library type information) are loaded only once, in the server
+ * process. Every job then runs in a forked child that inherits them, so that
+ * no per-file state can leak from one job into another.
+ */
+void runServer()
+{
+	// The standard output is reserved for the responses. Everything else the
+	// server and its jobs print goes into the standard error.
+	outs().flush();
+	std::cout.flush();
+	int responseFd = dup(STDOUT_FILENO);
+	std::FILE* responses = responseFd < 0 ? nullptr : fdopen(responseFd, "w");
+	if (responses == nullptr || dup2(STDERR_FILENO, STDOUT_FILENO) < 0)
+	{
+		throw std::runtime_error("failed to redirect the standard output");
+	}
+	auto respond = [responses](const std::string& response)
+	{
+		std::fprintf(responses, "%s\n", response.c_str());
+		std::fflush(responses);
+	};
+
+	retdec::bin2llvmir::DemanglerProvider::preloadDemanglers();
+	retdec::llvmir2hll::LlvmIr2Hll::preloadSemantics(Semantics);
+
+	std::string line;
+	while (std::getline(std::cin, line))
+	{
+		std::istringstream job(line);
+		std::string configPath;
+		std::string outputPath;
+		if (!(job >> configPath))
+		{
+			continue;
+		}
+		if (!(job >> outputPath))
+		{
+			respond("ERROR invalid job: " + line);
+			continue;
+		}
+
+		preloadJobData(configPath);
+
+		int ret = runServerJob(configPath, outputPath);
+		if (ret == EXIT_SUCCESS)
+		{
+			respond("OK " + outputPath);
+		}
+		else
+		{
+			respond("ERROR " + std::to_string(ret) + " " + outputPath);
+		}
+	}
+
+	std::fclose(responses);
+}
+
+#else
+
+void runServer()
+{
+	throw std::runtime_error("server mode is supported only on POSIX systems");
+}
+
+#endif
+
+/**
+ * Real main -- it does all the work.
+ */
+int _main(int argc, char **argv)
+{
+	initializeLlvmPasses();
+
+	cl::ParseCommandLineOptions(
+			argc,
+			argv,
+			// Program overview.
+			"binary -> high-level language in-process decompiler\n");
+
+	// In the server mode, the standard output is reserved for the responses.
+	retdec::llvm_support::printPhase(
+			"Initialization",
+			ServerMode ? errs() : outs());
+
+	if (OutputFilename.empty() && !ServerMode)
+	{
+		throw std::runtime_error("output file was not specified");
+	}
+
+	limitMaximalMemoryIfRequested();
+
+	// Before executing passes, print the final values of the LLVM options.
+	cl::PrintOptionValues();
+
+	if (ServerMode)
+	{
+		runServer();
+	}
+	else
+	{
+		decompile();
+	}
+
+	// Declare success.
+	retdec::llvm_support::printPhase("Cleanup");
+	return EXIT_SUCCESS;
+}
+
+/**
+ * Main function -- calls real main and handles exceptions.
+ */
+int main(int argc, char **argv)
+{
+	sys::PrintStackTraceOnErrorSignal(argv[0]);
+	PrettyStackTraceProgram X(argc, argv);
+	llvm_shutdown_obj Y; // Call llvm_shutdown() on exit.
+
+	int ret = EXIT_SUCCESS;
+
+	try
+	{
+		ret = _main(argc, argv);
+	}
+	catch (const std::runtime_error& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return ret;
+}
@@ -251,6 +251,7 @@ void CoffFormat::initStructures()
 		loadSections();
 		loadSymbols();
 		loadRelocations();
+		computeSecSegHashes();
 		computeSectionTableHashes();
 		loadStrings();
 	}
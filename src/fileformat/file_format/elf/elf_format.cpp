@@ -1130,10 +1130,10 @@ void ElfFormat::initStructures()
 		writer.set_machine(reader.get_machine());
 		loadInfoFromDynamicSegment();
 	}
+	computeSecSegHashes();
 	computeSectionTableHashes();
 	loadStrings();
-	loadNotes(); // must be done after sections and segments
-	loadCoreInfo(); // must be done after notes
+	loadOrDeferComponent(COMPONENT_NOTES); // must be done after sections and segments
 }
 
 std::size_t ElfFormat::initSectionTableHashOffsets()
@@ -1154,6 +1154,15 @@ std::size_t ElfFormat::initSectionTableHashOffsets()
 	return secHashInfo.size();
 }
 
+void ElfFormat::loadComponent(Component component)
+{
+	if(component == COMPONENT_NOTES)
+	{
+		loadNotes();
+		loadCoreInfo(); // must be done after notes
+	}
+}
+
 /**
  * Load ELF string table to @a writer member of this class
  * @param dynamicSection Section from @a writer which represents ELF dynamic segment
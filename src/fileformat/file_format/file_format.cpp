@@ -5,12 +5,14 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <climits>
 #include <cstring>
 #include <functional>
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 #include <pelib/PeLibInc.h>
 
@@ -116,7 +118,7 @@ bool isAddressFromRegion(const SecSeg *actualRegion, const SecSeg *newRegion, st
  * @param inputStream Stream which represents input file
  * @param loadFlags Load flags
  */
-FileFormat::FileFormat(std::istream &inputStream, LoadFlags loadFlags) : loadedBytes(&bytes),
+FileFormat::FileFormat(std::istream &inputStream, LoadFlags loadFlags) :
 	loadFlags(loadFlags), fileStream(inputStream), _ldrErrInfo()
 {
 	stateIsValid = !inputStream.fail();
@@ -128,7 +130,7 @@ FileFormat::FileFormat(std::istream &inputStream, LoadFlags loadFlags) : loadedB
  * @param pathToFile Path to input file
  * @param loadFlags Load flags
  */
-FileFormat::FileFormat(std::string pathToFile, LoadFlags loadFlags) : loadedBytes(&bytes),
+FileFormat::FileFormat(std::string pathToFile, LoadFlags loadFlags) :
 	loadFlags(loadFlags), filePath(pathToFile), fileStream(auxStream), _ldrErrInfo()
 {
 	auxStream.open(filePath, std::ifstream::binary);
@@ -157,8 +159,9 @@ void FileFormat::init()
 	pdbInfo = nullptr;
 	certificateTable = nullptr;
 	elfCoreInfo = nullptr;
+	deferredComponents = 0;
 	fileFormat = Format::UNDETECTABLE;
-	stateIsValid = readFile(fileStream, bytes) && stateIsValid;
+	stateIsValid = loadBytes() && stateIsValid;
 	if (getLoadFlags() & LoadFlags::NO_FILE_HASHES)
 	{
 		crc32.clear();
@@ -167,13 +170,42 @@ void FileFormat::init()
 	}
 	else
 	{
-		crc32 = retdec::crypto::getCrc32(bytes.data(), bytes.size());
-		md5 = retdec::crypto::getMd5(bytes.data(), bytes.size());
-		sha256 = retdec::crypto::getSha256(bytes.data(), bytes.size());
+		retdec::crypto::getCrc32Md5Sha256(bytes.data(), bytes.size(), crc32, md5, sha256);
 	}
 	initStream();
 }
 
+/**
+ * Load content of input file into member @c bytes
+ * @return @c true if content was successfully loaded, @c false otherwise
+ *
+ * If input file is given by its path, it is memory-mapped (if it is large
+ * enough, small files are simply read) and all the parsers work directly with
+ * the mapped content. No other copy of the whole file is created. Content of
+ * input stream is always read into memory.
+ */
+bool FileFormat::loadBytes()
+{
+	if(!filePath.empty())
+	{
+		auto buffer = llvm::MemoryBuffer::getFile(filePath, -1, false);
+		if(buffer)
+		{
+			fileBuffer = std::move(buffer.get());
+			bytes = llvm::ArrayRef<unsigned char>(
+				reinterpret_cast<const unsigned char*>(fileBuffer->getBufferStart()),
+				fileBuffer->getBufferSize());
+			loadedBytes = bytes;
+			return true;
+		}
+	}
+
+	const auto result = readFile(fileStream, streamBytes);
+	bytes = streamBytes;
+	loadedBytes = bytes;
+	return result;
+}
+
 /**
  * Initialize internal state of member @c fileStream
  */
@@ -280,6 +312,74 @@ void FileFormat::clear()
 	dynamicTables.clear();
 }
 
+/**
+ * Compute hashes of contents of all sections and segments. This method must be
+ * called after sections and segments are loaded.
+ *
+ * Contents of sections and segments do not depend on each other, so they are
+ * hashed in parallel if @c LoadFlags::PARALLEL_HASHES is set. Threads are not
+ * started otherwise, the caller decides whether the library may use them.
+ */
+void FileFormat::computeSecSegHashes()
+{
+	if (getLoadFlags() & LoadFlags::NO_VERBOSE_HASHES)
+	{
+		return;
+	}
+
+	std::vector<const SecSeg*> secSegs;
+	secSegs.reserve(sections.size() + segments.size());
+	for(const auto *sec : sections)
+	{
+		if(sec)
+		{
+			secSegs.push_back(sec);
+		}
+	}
+	for(const auto *seg : segments)
+	{
+		if(seg)
+		{
+			secSegs.push_back(seg);
+		}
+	}
+
+	const std::size_t numOfThreads = (getLoadFlags() & LoadFlags::PARALLEL_HASHES)
+		? std::min<std::size_t>(
+			std::max(std::thread::hardware_concurrency(), 1u),
+			secSegs.size())
+		: 1;
+	if(numOfThreads <= 1)
+	{
+		for(const auto *secSeg : secSegs)
+		{
+			secSeg->computePendingHashes();
+		}
+		return;
+	}
+
+	std::atomic<std::size_t> next(0);
+	auto worker = [&]()
+	{
+		for(auto i = next++; i < secSegs.size(); i = next++)
+		{
+			secSegs[i]->computePendingHashes();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(numOfThreads - 1);
+	for(std::size_t i = 1; i < numOfThreads; ++i)
+	{
+		threads.emplace_back(worker);
+	}
+	worker();
+	for(auto &thread : threads)
+	{
+		thread.join();
+	}
+}
+
 /**
  * Compute hashes of section table. This method must be called after
  * sections are loaded.
@@ -328,12 +428,54 @@ void FileFormat::computeSectionTableHashes()
 
 	if(!data.empty())
 	{
-		sectionCrc32 = retdec::crypto::getCrc32(data.data(), data.size());
-		sectionMd5 = retdec::crypto::getMd5(data.data(), data.size());
-		sectionSha256 = retdec::crypto::getSha256(data.data(), data.size());
+		retdec::crypto::getCrc32Md5Sha256(data.data(), data.size(), sectionCrc32, sectionMd5, sectionSha256);
+	}
+}
+
+/**
+ * Load the given component now, or only on its first use if loading flag
+ * @c LoadFlags::LAZY_LOAD is set
+ * @param component Component to load
+ */
+void FileFormat::loadOrDeferComponent(Component component)
+{
+	if(loadFlags & LoadFlags::LAZY_LOAD)
+	{
+		deferredComponents |= component;
+	}
+	else
+	{
+		loadComponent(component);
+	}
+}
+
+/**
+ * Load the given component if its loading was deferred and it was not
+ * loaded yet. This must be called by all the getters of the component.
+ * @param component Component to load
+ *
+ * Loading of a component modifies the instance, so the first access to
+ * a deferred component must not race with other accesses to the instance.
+ */
+void FileFormat::loadDeferredComponent(Component component) const
+{
+	if(deferredComponents & component)
+	{
+		deferredComponents &= ~static_cast<std::uint32_t>(component);
+		const_cast<FileFormat*>(this)->loadComponent(component);
 	}
 }
 
+/**
+ * Load the given component. Formats with lazily loaded components have to
+ * override this method.
+ * @param component Component to load
+ */
+void FileFormat::loadComponent(Component)
+{
+
+}
+
 /**
  * Set pointer to loaded serialized bytes of input file. In binary file formats
  * (e.g. ELF, PE, COFF) it is not necessary to call this method. In text file
@@ -342,7 +484,7 @@ void FileFormat::computeSectionTableHashes()
  */
 void FileFormat::setLoadedBytes(std::vector<unsigned char> *lBytes)
 {
-	loadedBytes = lBytes;
+	loadedBytes = *lBytes;
 }
 
 /**
@@ -1050,7 +1192,7 @@ std::size_t FileFormat::getFileLength() const
  */
 std::size_t FileFormat::getLoadedFileLength() const
 {
-	return loadedBytes->size();
+	return loadedBytes.size();
 }
 
 /**
@@ -1154,7 +1296,7 @@ bool FileFormat::getBytes(std::vector<std::uint8_t> &result, unsigned long long
 	numberOfBytes = offset + numberOfBytes > getLoadedFileLength() ? getLoadedFileLength() - offset : numberOfBytes;
 	result.clear();
 	result.reserve(numberOfBytes);
-	std::copy(loadedBytes->begin() + offset, loadedBytes->begin() + offset + numberOfBytes, std::back_inserter(result));
+	std::copy(loadedBytes.begin() + offset, loadedBytes.begin() + offset + numberOfBytes, std::back_inserter(result));
 	return true;
 }
 
@@ -1190,7 +1332,7 @@ bool FileFormat::getEpBytes(std::vector<std::uint8_t> &result, unsigned long lon
  */
 bool FileFormat::getHexBytes(std::string &result, unsigned long long offset, unsigned long long numberOfBytes) const
 {
-	bytesToHexString(*loadedBytes, result, offset, numberOfBytes);
+	bytesToHexString(loadedBytes.data(), loadedBytes.size(), result, offset, numberOfBytes);
 	return offset < getLoadedFileLength();
 }
 
@@ -1241,7 +1383,7 @@ bool FileFormat::getHexBytesFromEnd(std::string &result, unsigned long long numb
  */
 bool FileFormat::getString(std::string &result, unsigned long long offset, unsigned long long numberOfBytes) const
 {
-	bytesToString(*loadedBytes, result, offset, numberOfBytes);
+	bytesToString(loadedBytes.data(), loadedBytes.size(), result, offset, numberOfBytes);
 	return offset < getLoadedFileLength();
 }
 
@@ -1481,6 +1623,7 @@ const ExportTable* FileFormat::getExportTable() const
  */
 const ResourceTable* FileFormat::getResourceTable() const
 {
+	loadDeferredComponent(COMPONENT_RESOURCES);
 	return resourceTable;
 }
 
@@ -1490,6 +1633,7 @@ const ResourceTable* FileFormat::getResourceTable() const
  */
 const ResourceTree* FileFormat::getResourceTree() const
 {
+	loadDeferredComponent(COMPONENT_RESOURCES);
 	return resourceTree;
 }
 
@@ -1499,6 +1643,7 @@ const ResourceTree* FileFormat::getResourceTree() const
  */
 const RichHeader* FileFormat::getRichHeader() const
 {
+	loadDeferredComponent(COMPONENT_RICH_HEADER);
 	return richHeader;
 }
 
@@ -1517,6 +1662,7 @@ const PdbInfo* FileFormat::getPdbInfo() const
  */
 const CertificateTable* FileFormat::getCertificateTable() const
 {
+	loadDeferredComponent(COMPONENT_CERTIFICATES);
 	return certificateTable;
 }
 
@@ -1526,6 +1672,7 @@ const CertificateTable* FileFormat::getCertificateTable() const
  */
 const ElfCoreInfo* FileFormat::getElfCoreInfo() const
 {
+	loadDeferredComponent(COMPONENT_NOTES);
 	return elfCoreInfo;
 }
 
@@ -1663,6 +1810,7 @@ const Export* FileFormat::getExport(unsigned long long address) const
  */
 const Resource* FileFormat::getManifestResource() const
 {
+	loadDeferredComponent(COMPONENT_RESOURCES);
 	return resourceTable ? resourceTable->getResourceWithType(PELIB_RT_MANIFEST) : nullptr;
 }
 
@@ -1672,6 +1820,7 @@ const Resource* FileFormat::getManifestResource() const
  */
 const Resource* FileFormat::getVersionResource() const
 {
+	loadDeferredComponent(COMPONENT_RESOURCES);
 	return resourceTable ? resourceTable->getResourceWithType(PELIB_RT_VERSION) : nullptr;
 }
 
@@ -1681,6 +1830,7 @@ const Resource* FileFormat::getVersionResource() const
  */
 bool FileFormat::isSignaturePresent() const
 {
+	loadDeferredComponent(COMPONENT_CERTIFICATES);
 	return signatureVerified.isDefined();
 }
 
@@ -1690,6 +1840,7 @@ bool FileFormat::isSignaturePresent() const
  */
 bool FileFormat::isSignatureVerified() const
 {
+	loadDeferredComponent(COMPONENT_CERTIFICATES);
 	return signatureVerified.isDefined() && signatureVerified.getValue();
 }
 
@@ -1801,7 +1952,7 @@ const std::vector<DynamicTable*>& FileFormat::getDynamicTables() const
  * Get content of input file as bytes
  * @return Content of input file as bytes
  */
-const std::vector<unsigned char>& FileFormat::getBytes() const
+llvm::ArrayRef<unsigned char> FileFormat::getBytes() const
 {
 	return bytes;
 }
@@ -1810,9 +1961,9 @@ const std::vector<unsigned char>& FileFormat::getBytes() const
  * Get serialized loaded content of input file as bytes
  * @return Serialized content of input file as bytes
  */
-const std::vector<unsigned char>& FileFormat::getLoadedBytes() const
+llvm::ArrayRef<unsigned char> FileFormat::getLoadedBytes() const
 {
-	return *loadedBytes;
+	return loadedBytes;
 }
 
 /**
@@ -1830,7 +1981,7 @@ const unsigned char* FileFormat::getBytesData() const
  */
 const unsigned char* FileFormat::getLoadedBytesData() const
 {
-	return loadedBytes->data();
+	return loadedBytes.data();
 }
 
 /**
@@ -1848,6 +1999,7 @@ const std::vector<String>& FileFormat::getStrings() const
  */
 const std::vector<ElfNoteSecSeg>&FileFormat::getElfNoteSecSegs() const
 {
+	loadDeferredComponent(COMPONENT_NOTES);
 	return noteSecSegs;
 }
 
@@ -1880,7 +2032,7 @@ bool FileFormat::getXByte(std::uint64_t address, std::uint64_t x, std::uint64_t
 	const auto secOffset = address - secSeg->getAddress();
 	const auto offset = secSeg->getOffset() + secOffset;
 	return (secOffset + x > secSeg->getLoadedSize() || offset + x > getLoadedFileLength()) ?
-		false : createValueFromBytes(*loadedBytes, res, e, offset, x);
+		false : createValueFromBytes(loadedBytes.data(), loadedBytes.size(), res, e, offset, x);
 }
 
 /**
@@ -2010,7 +2162,7 @@ bool FileFormat::getXByteOffset(std::uint64_t offset, std::uint64_t x, std::uint
 		return true;
 	}
 
-	return createValueFromBytes(*loadedBytes, res, e, offset, x);
+	return createValueFromBytes(loadedBytes.data(), loadedBytes.size(), res, e, offset, x);
 }
 
 /**
@@ -2025,7 +2177,7 @@ bool FileFormat::getXBytesOffset(std::uint64_t offset, std::uint64_t x, std::vec
 	res.clear();
 	if(offset + x <= getLoadedFileLength())
 	{
-		res.assign(loadedBytes->begin() + offset, loadedBytes->begin() + offset + x);
+		res.assign(loadedBytes.begin() + offset, loadedBytes.begin() + offset + x);
 		return res.size() == x;
 	}
 
@@ -2515,6 +2667,7 @@ void FileFormat::dumpResourceTree()
 
 void FileFormat::dumpResourceTree(std::string &dumpStr)
 {
+	loadDeferredComponent(COMPONENT_RESOURCES);
 	if(!resourceTree)
 	{
 		dumpStr.clear();
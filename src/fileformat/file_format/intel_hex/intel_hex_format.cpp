@@ -52,6 +52,7 @@ void IntelHexFormat::initStructures()
 	{
 		fileFormat = Format::INTEL_HEX;
 		initializeSections();
+		computeSecSegHashes();
 		computeSectionTableHashes();
 		loadStrings();
 	}
@@ -122,7 +122,6 @@ bool MachOFormat::chooseArchitecture(const llvm::object::MachOUniversalBinary::o
 
 		chosenArchOffset = itr->getOffset();
 		chosenArchSize = itr->getSize();
-		chosenArchBytes.assign(getLoadedBytes().begin() + chosenArchOffset, getLoadedBytes().begin() + chosenArchOffset + chosenArchSize);
 		return true;
 	}
 
@@ -244,6 +243,7 @@ void MachOFormat::initStructures()
 		}
 		fileFormat = Format::MACHO;
 		loadCommands();
+		computeSecSegHashes();
 		loadStrings();
 		loadImpHash();
 	}
@@ -391,15 +391,16 @@ void PeFormat::initStructures()
 	if(stateIsValid)
 	{
 		fileFormat = Format::PE;
-		loadRichHeader();
+		loadOrDeferComponent(COMPONENT_RICH_HEADER);
 		loadSections();
 		loadSymbols();
 		loadImports();
 		loadExports();
 		loadPdbInfo();
-		loadResources();
-		loadCertificates();
-		loadDotnetHeaders();
+		loadOrDeferComponent(COMPONENT_RESOURCES);
+		loadOrDeferComponent(COMPONENT_CERTIFICATES);
+		loadOrDeferComponent(COMPONENT_DOTNET);
+		computeSecSegHashes();
 		computeSectionTableHashes();
 		loadStrings();
 	}
@@ -413,6 +414,27 @@ std::size_t PeFormat::initSectionTableHashOffsets()
 	return secHashInfo.size();
 }
 
+void PeFormat::loadComponent(Component component)
+{
+	switch(component)
+	{
+		case COMPONENT_RICH_HEADER:
+			loadRichHeader();
+			break;
+		case COMPONENT_RESOURCES:
+			loadResources();
+			break;
+		case COMPONENT_CERTIFICATES:
+			loadCertificates();
+			break;
+		case COMPONENT_DOTNET:
+			loadDotnetHeaders();
+			break;
+		default:
+			break;
+	}
+}
+
 /**
  * Calculate offset of rich header
  * @param plainFile Content of input file from space after MZ header to offset
@@ -512,7 +534,7 @@ void PeFormat::loadRichHeader()
 	}
 
 	std::string plainText;
-	bytesToString(bytes, plainText, getMzHeaderSize(), getPeHeaderOffset() - getMzHeaderSize());
+	bytesToString(bytes.data(), bytes.size(), plainText, getMzHeaderSize(), getPeHeaderOffset() - getMzHeaderSize());
 	auto offset = getRichHeaderOffset(plainText);
 	auto standardOffset = (offset == STANDARD_RICH_HEADER_OFFSET);
 	if(offset >= getPeHeaderOffset())
@@ -2334,6 +2356,7 @@ int PeFormat::getPeClass() const
  */
 bool PeFormat::isDotNet() const
 {
+	loadDeferredComponent(COMPONENT_DOTNET);
 	return clrHeader != nullptr || metadataHeader != nullptr;
 }
 
@@ -2481,56 +2504,67 @@ const PeCoffSection* PeFormat::getPeSection(unsigned long long secIndex) const
 
 const CLRHeader* PeFormat::getCLRHeader() const
 {
+	loadDeferredComponent(COMPONENT_DOTNET);
 	return clrHeader.get();
 }
 
 const MetadataHeader* PeFormat::getMetadataHeader() const
 {
+	loadDeferredComponent(COMPONENT_DOTNET);
 	return metadataHeader.get();
 }
 
 const MetadataStream* PeFormat::getMetadataStream() const
 {
+	loadDeferredComponent(COMPONENT_DOTNET);
 	return metadataStream.get();
 }
 
 const StringStream* PeFormat::getStringStream() const
 {
+	loadDeferredComponent(COMPONENT_DOTNET);
 	return stringStream.get();
 }
 
 const BlobStream* PeFormat::getBlobStream() const
 {
+	loadDeferredComponent(COMPONENT_DOTNET);
 	return blobStream.get();
 }
 
 const GuidStream* PeFormat::getGuidStream() const
 {
+	loadDeferredComponent(COMPONENT_DOTNET);
 	return guidStream.get();
 }
 
 const UserStringStream* PeFormat::getUserStringStream() const
 {
+	loadDeferredComponent(COMPONENT_DOTNET);
 	return userStringStream.get();
 }
 
 const std::string& PeFormat::getModuleVersionId() const
 {
+	loadDeferredComponent(COMPONENT_DOTNET);
 	return moduleVersionId;
 }
 
 const std::string& PeFormat::getTypeLibId() const
 {
+	loadDeferredComponent(COMPONENT_DOTNET);
 	return typeLibId;
 }
 
 const std::vector<std::shared_ptr<DotnetClass>>& PeFormat::getDefinedDotnetClasses() const
 {
+	loadDeferredComponent(COMPONENT_DOTNET);
 	return definedClasses;
 }
 
 const std::vector<std::shared_ptr<DotnetClass>>& PeFormat::getImportedDotnetClasses() const
 {
+	loadDeferredComponent(COMPONENT_DOTNET);
 	return importedClasses;
 }
 
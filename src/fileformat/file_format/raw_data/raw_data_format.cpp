@@ -57,6 +57,7 @@ void RawDataFormat::initStructures()
 	section->setSizeInMemory(bytes.size());
 	section->load(this);
 	sections.push_back(section);
+	computeSecSegHashes();
 	computeSectionTableHashes();
 	loadStrings();
 }
@@ -816,9 +816,7 @@ void ImportTable::computeHashes()
 		}
 	}
 
-	impHashCrc32 = retdec::crypto::getCrc32(impHashBytes.data(), impHashBytes.size());
-	impHashMd5 = retdec::crypto::getMd5(impHashBytes.data(), impHashBytes.size());
-	impHashSha256 = retdec::crypto::getSha256(impHashBytes.data(), impHashBytes.size());
+	retdec::crypto::getCrc32Md5Sha256(impHashBytes.data(), impHashBytes.size(), impHashCrc32, impHashMd5, impHashSha256);
 }
 
 /**
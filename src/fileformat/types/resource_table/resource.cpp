@@ -419,9 +419,7 @@ void Resource::load(const FileFormat *rOwner)
 
 	if (!(rOwner->getLoadFlags() & LoadFlags::NO_VERBOSE_HASHES))
 	{
-		crc32 = retdec::crypto::getCrc32(origBytes, bytes.size());
-		md5 = retdec::crypto::getMd5(origBytes, bytes.size());
-		sha256 = retdec::crypto::getSha256(origBytes, bytes.size());
+		retdec::crypto::getCrc32Md5Sha256(origBytes, bytes.size(), crc32, md5, sha256);
 	}
 }
 
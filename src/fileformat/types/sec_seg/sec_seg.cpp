@@ -26,7 +26,8 @@ namespace fileformat {
  */
 SecSeg::SecSeg() : type(Type::UNDEFINED_SEC_SEG), index(0), offset(0), fileSize(0),
 	address(0), memorySize(0), entrySize(0), memorySizeIsValid(false),
-	entrySizeIsValid(false), isInMemory(false), loaded(false)
+	entrySizeIsValid(false), isInMemory(false), loaded(false),
+	hashesPending(false)
 {
 
 }
@@ -42,12 +43,11 @@ SecSeg::~SecSeg()
 /**
  * Compute all supported hashes
  */
-void SecSeg::computeHashes()
+void SecSeg::computeHashes() const
 {
 	const auto *hashData = reinterpret_cast<const unsigned char*>(bytes.data());
-	crc32 = retdec::crypto::getCrc32(hashData, bytes.size());
-	md5 = retdec::crypto::getMd5(hashData, bytes.size());
-	sha256 = retdec::crypto::getSha256(hashData, bytes.size());
+	retdec::crypto::getCrc32Md5Sha256(hashData, bytes.size(), crc32, md5, sha256);
+	hashesPending = false;
 }
 
 /**
@@ -183,6 +183,7 @@ bool SecSeg::isValid(const FileFormat *sOwner) const
  */
 std::string SecSeg::getCrc32() const
 {
+	computePendingHashes();
 	return crc32;
 }
 
@@ -192,6 +193,7 @@ std::string SecSeg::getCrc32() const
  */
 std::string SecSeg::getMd5() const
 {
+	computePendingHashes();
 	return md5;
 }
 
@@ -201,6 +203,7 @@ std::string SecSeg::getMd5() const
  */
 std::string SecSeg::getSha256() const
 {
+	computePendingHashes();
 	return sha256;
 }
 
@@ -558,13 +561,26 @@ void SecSeg::load(const FileFormat *sOwner)
 	{
 		bytes = "";
 		loaded = sOwner && offset < sOwner->getLoadedFileLength();
+		hashesPending = false;
 		return;
 	}
 
 	bytes = StringRef(reinterpret_cast<const char*>(sOwner->getLoadedBytesData() + offset), std::min(fileSize, sOwner->getLoadedFileLength() - offset));
 	loaded = true;
 
-	if (!(sOwner->getLoadFlags() & LoadFlags::NO_VERBOSE_HASHES))
+	// Hashes are only scheduled here. They are computed either together with
+	// hashes of other sections and segments (FileFormat::computeSecSegHashes())
+	// or on the first query.
+	hashesPending = !(sOwner->getLoadFlags() & LoadFlags::NO_VERBOSE_HASHES);
+}
+
+/**
+ * Compute hashes of content if they were scheduled by @a load() and were not
+ * computed yet
+ */
+void SecSeg::computePendingHashes() const
+{
+	if(hashesPending)
 	{
 		computeHashes();
 	}
@@ -648,6 +664,7 @@ void SecSeg::dump(std::string &sDump) const
  */
 bool SecSeg::hasCrc32() const
 {
+	computePendingHashes();
 	return !crc32.empty();
 }
 
@@ -657,6 +674,7 @@ bool SecSeg::hasCrc32() const
  */
 bool SecSeg::hasMd5() const
 {
+	computePendingHashes();
 	return !md5.empty();
 }
 
@@ -666,6 +684,7 @@ bool SecSeg::hasMd5() const
  */
 bool SecSeg::hasSha256() const
 {
+	computePendingHashes();
 	return !sha256.empty();
 }
 
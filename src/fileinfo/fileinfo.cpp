@@ -65,7 +65,7 @@ struct ProgParams
 					maxMemory(0),
 					maxMemoryHalfRAM(false),
 					epBytesCount(EP_BYTES_SIZE),
-					loadFlags(LoadFlags::NONE) {}
+					loadFlags(LoadFlags::PARALLEL_HASHES) {}
 };
 
 /**
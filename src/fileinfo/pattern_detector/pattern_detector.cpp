@@ -9,10 +9,11 @@
 #include "retdec/utils/conversion.h"
 #include "retdec/utils/filesystem_path.h"
 #include "retdec/utils/string.h"
+#include "retdec/yara-cache/yara_scanner.h"
 #include "fileinfo/pattern_detector/pattern_detector.h"
 
 using namespace retdec::utils;
-using namespace yaracpp;
+using namespace retdec::yara_cache;
 
 namespace fileinfo {
 
@@ -340,18 +341,21 @@ void PatternDetector::addFilePaths(const std::string &category, const std::set<s
  */
 void PatternDetector::analyze()
 {
+	// rules of each category get their own namespace so the file is scanned only once
+	YaraScanner yara;
 	for(const auto &category : categories)
 	{
-		YaraDetector yara;
-
 		for(const auto &item : category.second)
 		{
-			yara.addRuleFile(item);
+			yara.addRuleFile(item, category.first);
 		}
+	}
 
-		yara.analyze(fileinfo.getPathToFile());
+	yara.analyze(fileinfo.getPathToFile());
 
-		for(const auto &rule : yara.getDetectedRules())
+	for(const auto &category : categories)
+	{
+		for(const auto &rule : yara.getDetectedRules(category.first))
 		{
 			if(category.first == "crypto")
 			{
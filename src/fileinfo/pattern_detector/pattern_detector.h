@@ -11,7 +11,7 @@
 #include <string>
 #include <vector>
 
-#include "yaracpp/yara_detector/yara_detector.h"
+#include "yaracpp/types/yara_rule.h"
 #include "fileinfo/file_information/file_information.h"
 
 namespace fileinfo {
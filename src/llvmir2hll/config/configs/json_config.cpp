@@ -152,6 +152,19 @@ UPtr<JSONConfig> JSONConfig::fromString(const std::string &str) {
 	return config;
 }
 
+/**
+* @brief Returns a config created from an already loaded config.
+*
+* No parsing takes place, so this is the way to pass a config between tools
+* running in the same process.
+*/
+UPtr<JSONConfig> JSONConfig::fromConfig(const retdec::config::Config &config) {
+	// We cannot use std::make_unique() because JSONConfig() is private.
+	auto result = UPtr<JSONConfig>(new JSONConfig());
+	result->impl->config = config;
+	return result;
+}
+
 /**
 * @brief Returns an empty config.
 */
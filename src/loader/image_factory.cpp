@@ -69,7 +69,7 @@ std::unique_ptr<Image> createImageImpl(const std::shared_ptr<retdec::fileformat:
  */
 std::unique_ptr<Image> createImage(const std::string& filePath, retdec::config::Config *config)
 {
-	std::unique_ptr<retdec::fileformat::FileFormat> fileFormat = retdec::fileformat::createFileFormat(filePath, config);
+	std::unique_ptr<retdec::fileformat::FileFormat> fileFormat = retdec::fileformat::createFileFormat(filePath, config, retdec::fileformat::LoadFlags::LAZY_LOAD);
 	std::shared_ptr<retdec::fileformat::FileFormat> fileFormatShared(std::move(fileFormat)); // Obtain ownership.
 	return createImageImpl(fileFormatShared);
 }
@@ -471,6 +471,8 @@ void ElfImage::fixBssSegments()
 			bssSegment->resize(nextSegment->getAddress() - bssSegment->getAddress());
 		}
 	}
+
+	invalidateSegmentIndex();
 }
 
 void ElfImage::applyRelocations()
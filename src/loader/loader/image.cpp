@@ -4,8 +4,11 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
 #include <climits>
 #include <cstring>
+#include <limits>
+#include <set>
 
 #include "retdec/utils/conversion.h"
 #include "retdec/utils/string.h"
@@ -18,7 +21,8 @@ namespace retdec {
 namespace loader {
 
 Image::Image(const std::shared_ptr<retdec::fileformat::FileFormat>& fileFormat) : _fileFormat(fileFormat), _segments(),
-	_baseAddress(0), _namelessSegNameGen("seg", '0', 4), _statusMessage()
+	_baseAddress(0), _namelessSegNameGen("seg", '0', 4), _statusMessage(), _segmentIndex(),
+	_segmentIndexValid(false), _lastSegmentIndexHit(0)
 {
 }
 
@@ -335,18 +339,19 @@ std::pair<const std::uint8_t*, std::uint64_t> Image::getRawSegmentData(std::uint
 bool Image::getXByte(std::uint64_t address, std::uint64_t x, std::uint64_t& res, Endianness e/* = UNKNOWN*/) const
 {
 	const auto *seg = getSegmentFromAddress(address);
-	if (!seg || x * getByteLength() > sizeof(res) * CHAR_BIT)
+	if (!seg || x == 0 || x * getByteLength() > sizeof(res) * CHAR_BIT)
 	{
 		return false;
 	}
 
-	std::vector<std::uint8_t> data;
-	if (!seg->getBytes(data, address - seg->getAddress(), x) || data.size() != x)
+	// At most 64 bytes are read (one bit per byte), so a buffer on the stack is enough.
+	std::uint8_t data[sizeof(res) * CHAR_BIT];
+	if (!seg->getBytes(data, address - seg->getAddress(), x))
 	{
 		return false;
 	}
 
-	return createValueFromBytes(data, res, e);
+	return createValueFromBytes(data, x, res, e);
 }
 
 /**
@@ -375,6 +380,40 @@ bool Image::getXBytes(std::uint64_t address, std::uint64_t x, std::vector<std::u
 	return true;
 }
 
+/**
+ * Read up to @a size bytes located at provided address into the buffer @a res.
+ * The read range may span more adjacent segments.
+ *
+ * @param address Address to read bytes from
+ * @param res Buffer for at least @a size bytes
+ * @param size Number of bytes to read
+ *
+ * @return Number of bytes that were read
+ */
+std::size_t Image::readBytes(std::uint64_t address, std::uint8_t* res, std::size_t size) const
+{
+	std::size_t read = 0;
+	while (read < size)
+	{
+		const auto *seg = getSegmentFromAddress(address + read);
+		if (!seg)
+		{
+			break;
+		}
+
+		auto offset = address + read - seg->getAddress();
+		auto toRead = std::min<std::uint64_t>(size - read, seg->getSize() - offset);
+		if (toRead == 0 || !seg->getBytes(res + read, offset, toRead))
+		{
+			break;
+		}
+
+		read += toRead;
+	}
+
+	return read;
+}
+
 bool Image::setXByte(std::uint64_t address, std::uint64_t x, std::uint64_t val, retdec::utils::Endianness e/* = retdec::utils::Endianness::UNKNOWN*/)
 {
 	const auto *seg = getSegmentFromAddress(address);
@@ -437,6 +476,7 @@ Segment* Image::insertSegment(std::unique_ptr<Segment> segment)
 	// Now give segment name
 	Segment* retSegment = _segments.back().get();
 	nameSegment(retSegment);
+	invalidateSegmentIndex();
 	return retSegment;
 }
 
@@ -447,6 +487,7 @@ void Image::removeSegment(Segment* segment)
 		if (itr->get() == segment)
 		{
 			_segments.erase(itr);
+			invalidateSegmentIndex();
 			return;
 		}
 	}
@@ -466,6 +507,19 @@ void Image::sortSegments()
 			{
 				return seg1->getAddress() < seg2->getAddress();
 			});
+	invalidateSegmentIndex();
+}
+
+/**
+ * Marks the index used for address-to-segment lookups as outdated. It has to be
+ * called whenever a segment changes its address or size, so the index is rebuilt
+ * on the next lookup. Insertion, removal, and sorting of segments call it on their own.
+ */
+void Image::invalidateSegmentIndex()
+{
+	_segmentIndexValid = false;
+	_segmentIndex.clear();
+	_lastSegmentIndexHit = 0;
 }
 
 const Segment* Image::_getSegment(std::size_t index) const
@@ -500,13 +554,88 @@ const Segment* Image::_getSegmentWithIndex(std::size_t index) const
 
 const Segment* Image::_getSegmentFromAddress(std::uint64_t address) const
 {
-	for (const auto& segment : getSegments())
+	if (!_segmentIndexValid)
+		_buildSegmentIndex();
+
+	if (_segmentIndex.empty())
+		return nullptr;
+
+	// Consecutive lookups tend to hit the same segment.
+	const auto& lastHit = _segmentIndex[_lastSegmentIndexHit];
+	if (lastHit.start <= address && address <= lastHit.end)
+		return lastHit.segment;
+
+	auto itr = std::upper_bound(_segmentIndex.begin(), _segmentIndex.end(), address,
+			[](std::uint64_t addr, const SegmentIndexEntry& entry)
+			{
+				return addr < entry.start;
+			});
+	if (itr == _segmentIndex.begin())
+		return nullptr;
+
+	--itr;
+	if (address > itr->end)
+		return nullptr;
+
+	_lastSegmentIndexHit = itr - _segmentIndex.begin();
+	return itr->segment;
+}
+
+/**
+ * Builds the index for address-to-segment lookups. Segments may overlap, so the address
+ * space is split into ranges, each of which is assigned to the first segment (in the order
+ * of getSegments()) containing it. This is the same segment the linear search would find.
+ */
+void Image::_buildSegmentIndex() const
+{
+	_segmentIndex.clear();
+	_lastSegmentIndexHit = 0;
+	_segmentIndexValid = true;
+
+	// Segment with the given position in _segments starts (true) or ends (false) on address.
+	struct Event
 	{
-		if (segment->containsAddress(address))
-			return segment.get();
+		std::uint64_t address;
+		bool starts;
+		std::size_t position;
+	};
+
+	std::vector<Event> events;
+	events.reserve(2 * _segments.size());
+	for (std::size_t i = 0, e = _segments.size(); i < e; ++i)
+	{
+		const auto& segment = _segments[i];
+		events.push_back({segment->getAddress(), true, i});
+		if (segment->getEndAddress() != std::numeric_limits<std::uint64_t>::max())
+			events.push_back({segment->getEndAddress() + 1, false, i});
 	}
+	std::sort(events.begin(), events.end(), [](const Event& e1, const Event& e2)
+			{
+				return e1.address < e2.address;
+			});
 
-	return nullptr;
+	std::set<std::size_t> active;
+	for (std::size_t i = 0, e = events.size(); i < e; )
+	{
+		auto start = events[i].address;
+		for (; i < e && events[i].address == start; ++i)
+		{
+			if (events[i].starts)
+				active.insert(events[i].position);
+			else
+				active.erase(events[i].position);
+		}
+
+		if (active.empty())
+			continue;
+
+		auto end = i < e ? events[i].address - 1 : std::numeric_limits<std::uint64_t>::max();
+		const Segment* segment = _segments[*active.begin()].get();
+		if (!_segmentIndex.empty() && _segmentIndex.back().segment == segment && _segmentIndex.back().end + 1 == start)
+			_segmentIndex.back().end = end;
+		else
+			_segmentIndex.push_back({start, end, segment});
+	}
 }
 
 } // namespace loader
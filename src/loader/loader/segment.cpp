@@ -211,6 +211,31 @@ bool Segment::getBytes(std::vector<unsigned char>& result, std::uint64_t address
 	return true;
 }
 
+/**
+ * Get content of segment as bytes without any memory allocation.
+ *
+ * @param result Buffer for at least @a size bytes.
+ * @param addressOffset First byte of the segment to be read (0 means first byte of segment).
+ * @param size Number of bytes for read.
+ *
+ * @return True if all @a size bytes lie in the segment and were read, otherwise false.
+ */
+bool Segment::getBytes(std::uint8_t* result, std::uint64_t addressOffset, std::uint64_t size) const
+{
+	if (addressOffset >= getSize() || size > getSize() - addressOffset)
+		return false;
+
+	// Data source may contain less data than we are representing with this segment
+	//   so we just fill the rest with zeroes.
+	auto physicalSize = getPhysicalSize();
+	auto loadSize = addressOffset < physicalSize ? std::min(size, physicalSize - addressOffset) : 0;
+	if (loadSize)
+		std::memcpy(result, _dataSource->getData() + addressOffset, loadSize);
+	std::fill(result + loadSize, result + size, 0);
+
+	return true;
+}
+
 /**
  * Get content of segment as bits in string representation.
  *
@@ -5,21 +5,80 @@
  */
 
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <string>
 
 #include "retdec/stacofin/stacofin.h"
-#include "yaracpp/yara_detector/yara_detector.h"
+#include "retdec/yara-cache/yara_scanner.h"
 #include "retdec/loader/loader/image.h"
 
+using namespace retdec::fileformat;
 using namespace retdec::utils;
+using namespace retdec::yara_cache;
 using namespace yaracpp;
 using namespace retdec::loader;
 
 namespace retdec {
 namespace stacofin {
 
+namespace {
+
+/**
+ * Get file offset ranges <start, end) with code of the input file.
+ *
+ * Code sections are used, or code segments if the file has no sections.
+ * Overlapping and adjacent ranges are merged. If the file has no code at all
+ * (e.g. raw data), the whole input is returned.
+ *
+ * @param fileFormat input file format
+ * @return sorted file offset ranges
+ */
+std::vector<std::pair<std::size_t, std::size_t>> getCodeRanges(
+	const FileFormat &fileFormat)
+{
+	const std::size_t loadedSize = fileFormat.getLoadedBytes().size();
+	std::vector<std::pair<std::size_t, std::size_t>> ranges;
+	auto addCode = [&](const SecSeg *secSeg) {
+		if (!secSeg->isSomeCode() || secSeg->getOffset() >= loadedSize) {
+			return;
+		}
+		const std::size_t start = secSeg->getOffset();
+		const std::size_t end = std::min<unsigned long long>(
+			loadedSize, start + secSeg->getLoadedSize());
+		if (start < end) {
+			ranges.emplace_back(start, end);
+		}
+	};
+
+	for (const auto *section : fileFormat.getSections()) {
+		addCode(section);
+	}
+	if (fileFormat.getSections().empty()) {
+		for (const auto *segment : fileFormat.getSegments()) {
+			addCode(segment);
+		}
+	}
+	if (ranges.empty()) {
+		return {{0, loadedSize}};
+	}
+
+	std::sort(ranges.begin(), ranges.end());
+	std::vector<std::pair<std::size_t, std::size_t>> merged;
+	for (const auto &range : ranges) {
+		if (!merged.empty() && range.first <= merged.back().second) {
+			merged.back().second = std::max(merged.back().second, range.second);
+		}
+		else {
+			merged.push_back(range);
+		}
+	}
+	return merged;
+}
+
+} // anonymous namespace
+
 
 /**
  * Parse string with references from meta attribute.
@@ -79,123 +138,146 @@ void Finder::clear()
 void Finder::search(
 	const Image &image,
 	const std::string &yaraFile)
+{
+	search(image, std::set<std::string>{yaraFile});
+}
+
+
+/**
+ * Search for static code from several signature files in input file.
+ *
+ * All signatures are matched in a single pass over code of the input file.
+ *
+ * @param image input file image
+ * @param yaraFiles static code signatures
+ */
+void Finder::search(
+	const Image &image,
+	const std::set<std::string> &yaraFiles)
 {
 	// Get FileFormat instance.
 	const auto* fileFormat = image.getFileFormat();
-	if (!fileFormat) {
+	if (!fileFormat || yaraFiles.empty()) {
 		return;
 	}
 
-	// Start Yara detector.
-	YaraDetector detector;
-	detector.addRuleFile(yaraFile);
-	auto inputBytes = fileFormat->getLoadedBytes();
-	detector.analyze(inputBytes);
-	if (!detector.isInValidState()) {
-		return;
+	// Start Yara scanner, signatures from each file get their own namespace.
+	YaraScanner scanner;
+	for (const auto &yaraFile : yaraFiles) {
+		scanner.addRuleFile(yaraFile, yaraFile);
 	}
 
-	// Iterate over detected rules.
-	isSorted = false;
-	for (const YaraRule &detectedRule : detector.getDetectedRules()) {
-		DetectedFunction detectedFunction;
-		detectedFunction.signaturePath = yaraFile;
+	// Scan only code, static code signatures cannot match anything else.
+	// Loaded bytes are a view of the input file, nothing is copied.
+	const auto loadedBytes = fileFormat->getLoadedBytes();
+	for (const auto &range : getCodeRanges(*fileFormat)) {
+		scanner.analyze(loadedBytes.data() + range.first,
+			range.second - range.first, false, range.first);
 
-		for (const YaraMeta &ruleMeta : detectedRule.getMetas()) {
-			if (ruleMeta.getId() == "name") {
-				detectedFunction.names.push_back(ruleMeta.getStringValue());
+		for (const auto &yaraFile : yaraFiles) {
+			for (const YaraRule &rule : scanner.getDetectedRules(yaraFile)) {
+				addDetectedFunctions(*fileFormat, rule, yaraFile);
 			}
-			if (ruleMeta.getId() == "size") {
-				detectedFunction.size = ruleMeta.getIntValue();
-			}
-			if (ruleMeta.getId() == "refs") {
-				const auto &refs = ruleMeta.getStringValue();
-				detectedFunction.setReferences(refs);
-			}
-			if (ruleMeta.getId() == "altNames") {
-				std::string name;
-				const auto &altNames = ruleMeta.getStringValue();
-				std::istringstream ss(altNames, std::istringstream::in);
-				while(ss >> name) {
-					detectedFunction.names.push_back(name);
-				}
-			}
-		}
-
-		// Iterate over all matches.
-		for (const YaraMatch &ruleMatch : detectedRule.getMatches()) {
-			// This is different for every match.
-			detectedFunction.offset = ruleMatch.getOffset();
-			unsigned long long address = 0;
-			if (!fileFormat->getAddressFromOffset(
-						address, detectedFunction.offset)) {
-				// Cannot get address. Maybe report error?
-				continue;
-			}
-
-			// Store data.
-			detectedFunction.address = address;
-			coveredCode.insert(AddressRange(address,
-				address + detectedFunction.size));
-			detectedFunctions.push_back(detectedFunction);
 		}
 	}
 }
 
 
 /**
- * Return detected code coverage.
+ * Add functions detected by the given rule.
  *
- * @return covered code
+ * @param fileFormat input file format
+ * @param detectedRule detected rule
+ * @param yaraFile signature file the rule comes from
  */
-CoveredCode Finder::getCoveredCode()
+void Finder::addDetectedFunctions(
+	const retdec::fileformat::FileFormat &fileFormat,
+	const yaracpp::YaraRule &detectedRule,
+	const std::string &yaraFile)
 {
-	return coveredCode;
+	DetectedFunction detectedFunction;
+	detectedFunction.signaturePath = yaraFile;
+
+	for (const YaraMeta &ruleMeta : detectedRule.getMetas()) {
+		if (ruleMeta.getId() == "name") {
+			detectedFunction.names.push_back(ruleMeta.getStringValue());
+		}
+		if (ruleMeta.getId() == "size") {
+			detectedFunction.size = ruleMeta.getIntValue();
+		}
+		if (ruleMeta.getId() == "refs") {
+			const auto &refs = ruleMeta.getStringValue();
+			detectedFunction.setReferences(refs);
+		}
+		if (ruleMeta.getId() == "altNames") {
+			std::string name;
+			const auto &altNames = ruleMeta.getStringValue();
+			std::istringstream ss(altNames, std::istringstream::in);
+			while(ss >> name) {
+				detectedFunction.names.push_back(name);
+			}
+		}
+	}
+
+	// Iterate over all matches.
+	for (const YaraMatch &ruleMatch : detectedRule.getMatches()) {
+		// This is different for every match.
+		detectedFunction.offset = ruleMatch.getOffset();
+		unsigned long long address = 0;
+		if (!fileFormat.getAddressFromOffset(
+					address, detectedFunction.offset)) {
+			// Cannot get address. Maybe report error?
+			continue;
+		}
+
+		// Store data.
+		detectedFunction.address = address;
+		coveredCode.insert(AddressRange(address,
+			address + detectedFunction.size));
+		addDetectedFunction(detectedFunction);
+	}
 }
 
 
 /**
- * Return detected functions sorted by their address.
+ * Insert detected function into the table of detected functions.
+ *
+ * The function is placed after all bigger detections at the same address, so
+ * the table never has to be sorted.
  *
- * @return sorted detected functions
+ * @param detectedFunction detected function
  */
-std::vector<DetectedFunction> Finder::getDectedFunctions()
+void Finder::addDetectedFunction(const DetectedFunction &detectedFunction)
 {
-	sort();
-	return detectedFunctions;
+	auto range = detectedFunctions.equal_range(detectedFunction.address);
+	auto hint = std::find_if(range.first, range.second,
+		[&detectedFunction](const DetectedFunctionsMultimap::value_type &p) {
+			return p.second.size < detectedFunction.size;
+		});
+	detectedFunctions.emplace_hint(hint, detectedFunction.address,
+		detectedFunction);
 }
 
 
 /**
- * Return detected functions sorted by their address.
+ * Return detected code coverage.
  *
- * @return sorted detected functions
+ * @return covered code
  */
-const std::vector<DetectedFunction>& Finder::accessDectedFunctions()
+CoveredCode Finder::getCoveredCode()
 {
-	sort();
-	return detectedFunctions;
+	return coveredCode;
 }
 
 
 /**
- * Sort detected functions.
+ * Return detected functions indexed by their address.
  *
- * Functions are sorted by their address, if detection address is same bigger
- * detection is frist.
+ * @return detected functions
  */
-void Finder::sort()
+const DetectedFunctionsMultimap& Finder::accessDetectedFunctions() const
 {
-	if (!isSorted) {
-		std::sort(detectedFunctions.begin(), detectedFunctions.end(),
-			[](DetectedFunction i, DetectedFunction j) {
-				if (i.address == j.address) {
-					return i.size > j.size;
-				}
-				return i.address < j.address;
-			});
-		isSorted = true;
-	}
+	return detectedFunctions;
 }
 
 } // namespace stacofin
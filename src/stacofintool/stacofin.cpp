@@ -6,6 +6,7 @@
 
 #include <iomanip>
 #include <iostream>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -66,10 +67,11 @@ std::string referencesToString(
  * @param detections detected functions
  */
 void printDetectionsDebug(
-	const std::vector<DetectedFunction> &detections)
+	const DetectedFunctionsMultimap &detections)
 {
 	std::uint64_t lastAddress = 0;
-	for (const auto &detected : detections) {
+	for (const auto &p : detections) {
+		const auto &detected = p.second;
 		if (detected.address == lastAddress) {
 			for (const auto &name : detected.names) {
 				std::cout << "or " << name << "\n";
@@ -93,10 +95,11 @@ void printDetectionsDebug(
  * @param detections detected functions
  */
 void printDetections(
-	const std::vector<DetectedFunction> &detections)
+	const DetectedFunctionsMultimap &detections)
 {
 	std::uint64_t lastAddress = 0;
-	for (const auto &detected : detections) {
+	for (const auto &p : detections) {
+		const auto &detected = p.second;
 		if (detected.address == lastAddress) {
 			for (const auto &name : detected.names) {
 				std::cout << "\t\t\t" << name << " "
@@ -127,7 +130,7 @@ int doActions(
 {
 	bool debugOn = false;
 	std::string binaryPath;
-	std::vector<std::string> yaraPaths;
+	std::set<std::string> yaraPaths;
 
 	for (std::size_t i = 0; i < args.size(); ++i) {
 		if (args[i] == "-h" || args[i] == "--help") {
@@ -147,7 +150,7 @@ int doActions(
 			if (!FilesystemPath(args[i]).isFile()) {
 				return printError("invalid yara file '" + args[i] + "'");
 			}
-			yaraPaths.push_back(args[i]);
+			yaraPaths.insert(args[i]);
 		}
 	}
 
@@ -159,16 +162,14 @@ int doActions(
 
 	// Do search.
 	Finder codeFinder;
-	for (const auto &yaraPath : yaraPaths) {
-		codeFinder.search(*image.get(), yaraPath);
-	}
+	codeFinder.search(*image.get(), yaraPaths);
 
 	// Print detections.
 	if (debugOn) {
-		printDetectionsDebug(codeFinder.accessDectedFunctions());
+		printDetectionsDebug(codeFinder.accessDetectedFunctions());
 	}
 	else {
-		printDetections(codeFinder.accessDectedFunctions());
+		printDetections(codeFinder.accessDetectedFunctions());
 	}
 
 	// Print total code coverage information.
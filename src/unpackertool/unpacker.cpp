@@ -51,7 +51,7 @@ bool detectPackers(const std::string& inputFile, std::vector<retdec::cpdetect::D
 			return false;
 		default:
 		{
-			auto fileParser = createFileFormat(inputFile);
+			auto fileParser = createFileFormat(inputFile, nullptr, LoadFlags::LAZY_LOAD);
 			if (!fileParser)
 			{
 				std::cerr << "Error while detecting format of file '" << inputFile << "'! Please, report this." << std::endl;
@@ -336,6 +336,33 @@ bool ByteValueStorage::get10Byte(std::uint64_t address, long double& res) const
 	return true;
 }
 
+/**
+ * Read up to @a size bytes located at provided address into the buffer @a res
+ *
+ * @param address Address to read bytes from
+ * @param res Buffer for at least @a size bytes
+ * @param size Number of bytes to read
+ *
+ * @return Number of bytes that were read. Reading stops at the first byte that
+ *         cannot be read, so it is less than @a size if the requested range is
+ *         not fully available.
+ *
+ * This is the allocation-free counterpart of @c get1ByteArray(). The default
+ * implementation reads the bytes one by one. Storages which can provide the
+ * data directly should override it.
+ */
+std::size_t ByteValueStorage::readBytes(std::uint64_t address, std::uint8_t* res, std::size_t size) const
+{
+	std::uint64_t byte = 0;
+	std::size_t i = 0;
+	for (; i < size && get1Byte(address + i, byte); ++i)
+	{
+		res[i] = static_cast<std::uint8_t>(byte);
+	}
+
+	return i;
+}
+
 /**
  * Get word located at provided address using the specified endian or default file endian
  *
@@ -806,8 +833,27 @@ bool ByteValueStorage::getDoubleArray(std::uint64_t address, std::vector<double>
  */
 bool ByteValueStorage::createValueFromBytes(const std::vector<std::uint8_t>& data, std::uint64_t& value, Endianness endian, std::uint64_t offset/* = 0*/, std::uint64_t size/* = 0*/) const
 {
-	const std::uint64_t realSize = (!size || offset + size > data.size()) ? data.size() - offset : size;
-	if (offset >= data.size() || (size && realSize != size))
+	return createValueFromBytes(data.data(), data.size(), value, endian, offset, size);
+}
+
+/**
+ * Create integer from array of bytes
+ *
+ * @param data Array of bytes
+ * @param dataSize Number of bytes in @a data
+ * @param value Resulted value
+ * @param endian Endian - if specified it is forced, otherwise file's endian is used
+ * @param offset Offset of first byte from @a data which will be converted
+ *    (0 means first offset from @a data)
+ * @param size Number of bytes for conversion (0 means all bytes from @a offset
+ *    to end of @a data)
+ *
+ * @return @c true if conversion went OK, @c false otherwise
+ */
+bool ByteValueStorage::createValueFromBytes(const std::uint8_t* data, std::size_t dataSize, std::uint64_t& value, Endianness endian, std::uint64_t offset/* = 0*/, std::uint64_t size/* = 0*/) const
+{
+	const std::uint64_t realSize = (!size || offset + size > dataSize) ? dataSize - offset : size;
+	if (offset >= dataSize || (size && realSize != size))
 	{
 		return false;
 	}
@@ -0,0 +1,11 @@
+/**
+ * @file src/yara-cache/doxygen.h
+ * @brief Doxygen documentation of the retdec::yara_cache namespace.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+// As there is no better place to comment this namespace, we do this in the
+// present file.
+
+/// @file src/yara-cache/doxygen.h
+/// @namespace retdec::yara_cache Cache of compiled YARA rules.
@@ -0,0 +1,452 @@
+/**
+ * @file src/yara-cache/yara_cache.cpp
+ * @brief Cache of compiled YARA rules.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Process.h>
+#include <yara.h>
+
+#include "retdec/crypto/crypto.h"
+#include "retdec/utils/os.h"
+#include "retdec/yara-cache/yara_cache.h"
+
+#ifdef OS_POSIX
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace retdec {
+namespace yara_cache {
+
+namespace {
+
+/// Magic bytes at the start of files created by @c yr_rules_save().
+const char COMPILED_RULES_MAGIC[] = "YARA";
+
+/// Suffix of files with compiled rules in the cache.
+const std::string COMPILED_RULES_SUFFIX = ".yarac";
+
+/**
+ * Get path of the compiled rules with key @a key in @a cacheDir.
+ */
+std::string getCachePath(const std::string &cacheDir, const std::string &key)
+{
+	llvm::SmallString<256> path(cacheDir);
+	llvm::sys::path::append(path, key + COMPILED_RULES_SUFFIX);
+	return path.str();
+}
+
+/**
+ * Get the directory with compiled rules that may be placed next to
+ *        @a ruleFile during installation.
+ */
+std::string getLocalCacheDir(const std::string &ruleFile)
+{
+	llvm::SmallString<256> path(llvm::sys::path::parent_path(ruleFile));
+	llvm::sys::path::append(path, LOCAL_CACHE_DIR_NAME);
+	return path.str();
+}
+
+/**
+ * Get the value of environment variable @a name if it is an absolute path.
+ */
+std::string getAbsolutePathFromEnv(const char *name)
+{
+	const char *value = std::getenv(name);
+	if (value == nullptr || !llvm::sys::path::is_absolute(value))
+	{
+		return std::string();
+	}
+	return value;
+}
+
+/**
+ * Check if compiled rules @a cachePath in @a cacheDir can be loaded, i.e.
+ *        both of them exist and are trusted.
+ */
+bool isTrustedCacheEntry(const std::string &cacheDir, const std::string &cachePath)
+{
+	return isTrustedCachePath(cacheDir) && isTrustedCachePath(cachePath);
+}
+
+/**
+ * Compile rules from @a ruleFiles and store them under @a key into
+ *        @a cacheDir unless they are already there.
+ *
+ * The directory and the file are created accessible only by their owner, or
+ * readable by everyone if @a shared is @c true. Nothing is stored into
+ * a directory which is not trusted.
+ *
+ * The rules are compiled into a unique temporary file, which is then renamed,
+ * so concurrent processes sharing the cache never see a partially written file.
+ */
+bool storeCompiledRules(
+		const std::vector<NamespacedRuleFile> &ruleFiles,
+		const std::string &cacheDir,
+		const std::string &key,
+		bool shared = false)
+{
+	using namespace llvm::sys::fs;
+
+	const perms dirPerms = shared
+			? owner_all | group_read | group_exe | others_read | others_exe
+			: owner_all;
+	const unsigned filePerms = shared
+			? all_read | owner_write
+			: owner_read | owner_write;
+
+	if (cacheDir.empty()
+			|| create_directories(cacheDir, true, dirPerms)
+			|| !isTrustedCachePath(cacheDir))
+	{
+		return false;
+	}
+
+	const auto cachePath = getCachePath(cacheDir, key);
+	if (exists(cachePath))
+	{
+		return isTrustedCachePath(cachePath);
+	}
+
+	int tmpFd = -1;
+	llvm::SmallString<256> tmpPath;
+	if (createUniqueFile(cachePath + ".%%%%%%.tmp", tmpFd, tmpPath, filePerms))
+	{
+		return false;
+	}
+	llvm::sys::Process::SafelyCloseFileDescriptor(tmpFd);
+
+	if (!compileRuleFiles(ruleFiles, tmpPath.str())
+			|| llvm::sys::fs::rename(tmpPath, cachePath))
+	{
+		llvm::sys::fs::remove(tmpPath);
+		return false;
+	}
+
+	return true;
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Check if @a ruleFile contains rules compiled by @c yr_rules_save()
+ *        (e.g. by @c yarac).
+ */
+bool isCompiledRuleFile(const std::string &ruleFile)
+{
+	auto buffer = llvm::MemoryBuffer::getFile(ruleFile, -1, false);
+	if (!buffer)
+	{
+		return false;
+	}
+
+	auto content = buffer.get()->getBuffer();
+	return content.startswith(COMPILED_RULES_MAGIC);
+}
+
+/**
+ * @brief Get a key under which the compiled @a ruleFile is stored in caches.
+ * @return Key or an empty string if @a ruleFile cannot be read.
+ *
+ * The key is a hash of the content of the file and of the version of YARA.
+ * Rules compiled by a different version of YARA cannot be loaded. Files
+ * included by @a ruleFile are not part of the key.
+ */
+std::string getRuleFileKey(const std::string &ruleFile)
+{
+	auto buffer = llvm::MemoryBuffer::getFile(ruleFile, -1, false);
+	if (!buffer)
+	{
+		return std::string();
+	}
+
+	auto content = buffer.get()->getBuffer();
+	const auto contentHash = retdec::crypto::getSha256(
+			reinterpret_cast<const unsigned char*>(content.data()),
+			content.size());
+	const std::string versionedHash = std::string(YR_VERSION) + ":" + contentHash;
+	return retdec::crypto::getSha256(
+			reinterpret_cast<const unsigned char*>(versionedHash.data()),
+			versionedHash.size());
+}
+
+/**
+ * @brief Get the default directory of the cache, which is private to the
+ *        current user.
+ * @return @c $XDG_CACHE_HOME/retdec/yara-cache, @c $HOME/.cache/retdec/yara-cache
+ *         (@c %LOCALAPPDATA%\retdec\yara-cache on Windows), or an empty
+ *         string if none of the variables is set to an absolute path. Rules
+ *         are not cached in such a case.
+ */
+std::string getDefaultCacheDir()
+{
+	llvm::SmallString<256> path;
+#ifdef OS_WINDOWS
+	path = getAbsolutePathFromEnv("LOCALAPPDATA");
+#else
+	path = getAbsolutePathFromEnv("XDG_CACHE_HOME");
+	if (path.empty())
+	{
+		path = getAbsolutePathFromEnv("HOME");
+		if (!path.empty())
+		{
+			llvm::sys::path::append(path, ".cache");
+		}
+	}
+#endif
+	if (path.empty())
+	{
+		return std::string();
+	}
+
+	llvm::sys::path::append(path, "retdec", "yara-cache");
+	return path.str();
+}
+
+/**
+ * @brief Check if compiled rules may be loaded from @a path (a file or
+ *        a directory of the cache).
+ *
+ * Compiled rules are bytecode, so they are loaded only from paths that cannot
+ * be planted by other users: @a path has to be owned by the current user (or
+ * by root, e.g. installed caches) and must not be writable by group or others.
+ * On Windows, the cache is in the user's profile, so only the existence of
+ * @a path is checked.
+ */
+bool isTrustedCachePath(const std::string &path)
+{
+#ifdef OS_POSIX
+	struct stat st;
+	if (lstat(path.c_str(), &st) != 0)
+	{
+		return false;
+	}
+	if (!S_ISDIR(st.st_mode) && !S_ISREG(st.st_mode))
+	{
+		return false;
+	}
+	if (st.st_uid != geteuid() && st.st_uid != 0)
+	{
+		return false;
+	}
+	return (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+#else
+	return llvm::sys::fs::exists(path);
+#endif
+}
+
+/**
+ * @brief Compile rules from @a ruleFiles, each into its namespace.
+ * @return Compiled rules or @c nullptr if any of the files cannot be compiled.
+ *         The caller has to destroy the rules by @c yr_rules_destroy().
+ *
+ * YARA has to be initialized by @c yr_initialize().
+ */
+YR_RULES* compileRules(const std::vector<NamespacedRuleFile> &ruleFiles)
+{
+	YR_COMPILER *compiler = nullptr;
+	if (yr_compiler_create(&compiler) != ERROR_SUCCESS)
+	{
+		return nullptr;
+	}
+
+	bool ok = true;
+	for (const auto &ruleFile : ruleFiles)
+	{
+		auto *file = std::fopen(ruleFile.first.c_str(), "r");
+		if (!file)
+		{
+			ok = false;
+			break;
+		}
+
+		const char *nameSpace = ruleFile.second.empty() ? nullptr : ruleFile.second.c_str();
+		ok = yr_compiler_add_file(compiler, file, nameSpace, ruleFile.first.c_str()) == 0;
+		std::fclose(file);
+		if (!ok)
+		{
+			break;
+		}
+	}
+
+	YR_RULES *rules = nullptr;
+	if (ok && yr_compiler_get_rules(compiler, &rules) != ERROR_SUCCESS)
+	{
+		rules = nullptr;
+	}
+
+	yr_compiler_destroy(compiler);
+	return rules;
+}
+
+/**
+ * @brief Compile rules from @a ruleFiles, each into its namespace, and save
+ *        them into @a outputFile.
+ * @return @c true if the rules were compiled and saved, @c false otherwise.
+ */
+bool compileRuleFiles(
+		const std::vector<NamespacedRuleFile> &ruleFiles,
+		const std::string &outputFile)
+{
+	if (yr_initialize() != ERROR_SUCCESS)
+	{
+		return false;
+	}
+
+	bool result = false;
+	if (auto *rules = compileRules(ruleFiles))
+	{
+		result = yr_rules_save(rules, outputFile.c_str()) == ERROR_SUCCESS;
+		yr_rules_destroy(rules);
+	}
+
+	yr_finalize();
+	return result;
+}
+
+/**
+ * @brief Compile rules from @a ruleFile and save them into @a outputFile.
+ * @return @c true if the rules were compiled and saved, @c false otherwise.
+ */
+bool compileRuleFile(const std::string &ruleFile, const std::string &outputFile)
+{
+	return compileRuleFiles({{ruleFile, ""}}, outputFile);
+}
+
+/**
+ * @brief Compile rules from @a ruleFile and store them into @a cacheDir.
+ * @param ruleFile File with source rules.
+ * @param cacheDir Directory of the cache.
+ * @param shared Make the stored rules readable by all users (e.g. for caches
+ *        created during installation).
+ * @return @c true if the compiled rules are in the cache, @c false otherwise.
+ */
+bool addToCache(
+		const std::string &ruleFile,
+		const std::string &cacheDir,
+		bool shared)
+{
+	const auto key = getRuleFileKey(ruleFile);
+	return !key.empty()
+			&& storeCompiledRules({{ruleFile, ""}}, cacheDir, key, shared);
+}
+
+/**
+ * @brief Get a file with rules from @a ruleFile compiled into the
+ *        @c LOCAL_CACHE_DIR_NAME directory next to it (e.g. by
+ *        <tt>yara-cache --local</tt> during installation).
+ * @return Path to the compiled rules or an empty string if there are no
+ *         trusted compiled rules for the current content of @a ruleFile.
+ *
+ * The rules are compiled into the default namespace.
+ */
+std::string getLocalCompiledRuleFile(const std::string &ruleFile)
+{
+	const auto key = getRuleFileKey(ruleFile);
+	if (key.empty())
+	{
+		return std::string();
+	}
+
+	const auto dir = getLocalCacheDir(ruleFile);
+	const auto cachePath = getCachePath(dir, key);
+	return isTrustedCacheEntry(dir, cachePath) ? cachePath : std::string();
+}
+
+/**
+ * @brief Get a file with compiled rules from @a ruleFile.
+ * @param ruleFile File with rules (either source or compiled).
+ * @param cacheDir Directory of the cache.
+ * @return Path to the compiled rules or @a ruleFile itself when it is already
+ *         compiled or when the rules cannot be compiled (so the caller reports
+ *         the errors when it compiles them on its own).
+ *
+ * Compiled rules are looked up in the @c LOCAL_CACHE_DIR_NAME directory next
+ * to @a ruleFile, which may be created during installation, and then in
+ * @a cacheDir. Only trusted files in trusted directories are used (see
+ * @c isTrustedCachePath()). If none of them contains the rules, they are
+ * compiled and stored into @a cacheDir.
+ */
+std::string getCompiledRuleFile(
+		const std::string &ruleFile,
+		const std::string &cacheDir)
+{
+	if (isCompiledRuleFile(ruleFile))
+	{
+		return ruleFile;
+	}
+
+	const auto key = getRuleFileKey(ruleFile);
+	if (key.empty())
+	{
+		return ruleFile;
+	}
+
+	const auto localPath = getLocalCompiledRuleFile(ruleFile);
+	if (!localPath.empty())
+	{
+		return localPath;
+	}
+
+	if (cacheDir.empty())
+	{
+		return ruleFile;
+	}
+
+	const auto cachePath = getCachePath(cacheDir, key);
+	if (isTrustedCacheEntry(cacheDir, cachePath))
+	{
+		return cachePath;
+	}
+
+	return storeCompiledRules({{ruleFile, ""}}, cacheDir, key)
+			? getCachePath(cacheDir, key)
+			: ruleFile;
+}
+
+/**
+ * @brief Get a file with rules from all @a ruleFiles compiled together, each
+ *        into its namespace.
+ * @param ruleFiles Source rule files and their namespaces.
+ * @param cacheDir Directory of the cache.
+ * @return Path to the compiled rules or an empty string if the rules cannot be
+ *         compiled or stored into the cache.
+ *
+ * The key of the set is derived from the keys of all the files and their
+ * namespaces, so the set is recompiled whenever any of the files changes.
+ */
+std::string getCompiledRuleFiles(
+		const std::vector<NamespacedRuleFile> &ruleFiles,
+		const std::string &cacheDir)
+{
+	std::string setKeys;
+	for (const auto &ruleFile : ruleFiles)
+	{
+		const auto key = getRuleFileKey(ruleFile.first);
+		if (key.empty())
+		{
+			return std::string();
+		}
+		setKeys += ruleFile.second + ":" + key + "\n";
+	}
+
+	const auto key = retdec::crypto::getSha256(
+			reinterpret_cast<const unsigned char*>(setKeys.data()),
+			setKeys.size());
+	return storeCompiledRules(ruleFiles, cacheDir, key)
+			? getCachePath(cacheDir, key)
+			: std::string();
+}
+
+} // namespace yara_cache
+} // namespace retdec
@@ -0,0 +1,359 @@
+/**
+ * @file src/yara-cache/yara_scanner.cpp
+ * @brief Scanner matching several namespaced sets of YARA rules at once.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include "retdec/yara-cache/yara_scanner.h"
+
+using namespace yaracpp;
+
+namespace retdec {
+namespace yara_cache {
+
+namespace {
+
+/// Namespace of rules added without a namespace (the one used by YARA).
+const std::string DEFAULT_NAMESPACE = "default";
+
+/**
+ * Get the name of @a nameSpace as used by YARA.
+ */
+std::string getNamespaceName(const std::string &nameSpace)
+{
+	return nameSpace.empty() ? DEFAULT_NAMESPACE : nameSpace;
+}
+
+/**
+ * Convert metadata of @a yrRule into metadata of @a rule.
+ */
+void addMetas(YaraRule &rule, YR_RULE *yrRule)
+{
+	YR_META *meta;
+	yr_rule_metas_foreach(yrRule, meta)
+	{
+		YaraMeta yaraMeta;
+		yaraMeta.setId(meta->identifier);
+		if (meta->type == META_TYPE_STRING)
+		{
+			yaraMeta.setType(YaraMeta::Type::String);
+			yaraMeta.setStringValue(meta->string);
+		}
+		else
+		{
+			yaraMeta.setType(YaraMeta::Type::Int);
+			yaraMeta.setIntValue(meta->integer);
+		}
+		rule.addMeta(yaraMeta);
+	}
+}
+
+/**
+ * Convert matches of strings of @a yrRule into matches of @a rule.
+ *
+ * @a baseOffset is added to offsets of all the matches.
+ */
+void addMatches(YaraRule &rule, YR_RULE *yrRule, std::size_t baseOffset)
+{
+	YR_STRING *string;
+	yr_rule_strings_foreach(yrRule, string)
+	{
+		YR_MATCH *match;
+		yr_string_matches_foreach(string, match)
+		{
+			YaraMatch yaraMatch;
+			yaraMatch.setOffset(baseOffset + match->base + match->offset);
+			yaraMatch.addData(match->data, match->data_length);
+			rule.addMatch(yaraMatch);
+		}
+	}
+}
+
+} // anonymous namespace
+
+/**
+ * Constructor
+ * @param cacheDir Directory of the cache of compiled rules. Source rules are
+ *        compiled in memory for every scanner if it is empty.
+ */
+YaraScanner::YaraScanner(const std::string &cacheDir) : cacheDir(cacheDir)
+{
+
+}
+
+/**
+ * Destructor
+ */
+YaraScanner::~YaraScanner()
+{
+	for (auto &ruleSet : ruleSets)
+	{
+		yr_rules_destroy(ruleSet.rules);
+	}
+
+	if (initialized)
+	{
+		yr_finalize();
+	}
+}
+
+/**
+ * @brief Add a file with rules.
+ * @param ruleFile File with source or compiled rules.
+ * @param nameSpace Namespace of the rules from the file. Rules added without
+ *        a namespace are reported in the default namespace.
+ * @return @c true if the file can be read, @c false otherwise.
+ *
+ * The rules are compiled and loaded right before the next scan.
+ */
+bool YaraScanner::addRuleFile(
+		const std::string &ruleFile,
+		const std::string &nameSpace)
+{
+	if (isCompiledRuleFile(ruleFile))
+	{
+		compiledFiles.emplace_back(ruleFile, getNamespaceName(nameSpace));
+	}
+	else if (!getRuleFileKey(ruleFile).empty())
+	{
+		sourceFiles.emplace_back(ruleFile, getNamespaceName(nameSpace));
+	}
+	else
+	{
+		stateIsValid = false;
+		return false;
+	}
+
+	for (auto &ruleSet : ruleSets)
+	{
+		yr_rules_destroy(ruleSet.rules);
+	}
+	ruleSets.clear();
+	prepared = false;
+	return true;
+}
+
+/**
+ * @brief Scan the file @a filePath with all added rules.
+ * @param filePath Path to the scanned file.
+ * @param storeAll If @c true, undetected rules are stored as well.
+ * @return @c true if all rules were used for the scan, @c false otherwise.
+ *
+ * If some rules cannot be used, the scan is done with the remaining ones.
+ */
+bool YaraScanner::analyze(const std::string &filePath, bool storeAll)
+{
+	clearResults();
+	bool result = prepareRules();
+	for (const auto &ruleSet : ruleSets)
+	{
+		ScanContext context{this, &ruleSet.nameSpace, 0, storeAll};
+		result &= yr_rules_scan_file(ruleSet.rules, filePath.c_str(), 0,
+				scanCallback, &context, 0) == ERROR_SUCCESS;
+	}
+	return result;
+}
+
+/**
+ * @brief Scan @a size bytes of @a data with all added rules.
+ * @param data Scanned data.
+ * @param size Size of @a data.
+ * @param storeAll If @c true, undetected rules are stored as well.
+ * @param baseOffset Offset added to offsets of all matches, which allows
+ *        to scan only a part of a file and report offsets in the whole file.
+ * @return @c true if all rules were used for the scan, @c false otherwise.
+ *
+ * If some rules cannot be used, the scan is done with the remaining ones.
+ */
+bool YaraScanner::analyze(
+		const std::uint8_t *data,
+		std::size_t size,
+		bool storeAll,
+		std::size_t baseOffset)
+{
+	clearResults();
+	bool result = prepareRules();
+	for (const auto &ruleSet : ruleSets)
+	{
+		ScanContext context{this, &ruleSet.nameSpace, baseOffset, storeAll};
+		result &= yr_rules_scan_mem(ruleSet.rules, const_cast<std::uint8_t*>(data),
+				size, 0, scanCallback, &context, 0) == ERROR_SUCCESS;
+	}
+	return result;
+}
+
+/**
+ * @brief Get rules detected by the last scan in @a nameSpace.
+ */
+const std::vector<YaraRule>& YaraScanner::getDetectedRules(
+		const std::string &nameSpace) const
+{
+	static const std::vector<YaraRule> noRules;
+	auto it = detected.find(getNamespaceName(nameSpace));
+	return it != detected.end() ? it->second : noRules;
+}
+
+/**
+ * @brief Get rules not detected by the last scan in @a nameSpace.
+ *
+ * The rules are available only if the scan was run with @c storeAll.
+ */
+const std::vector<YaraRule>& YaraScanner::getUndetectedRules(
+		const std::string &nameSpace) const
+{
+	static const std::vector<YaraRule> noRules;
+	auto it = undetected.find(getNamespaceName(nameSpace));
+	return it != undetected.end() ? it->second : noRules;
+}
+
+/**
+ * @brief Check if all added rules can be used.
+ */
+bool YaraScanner::isInValidState() const
+{
+	return stateIsValid;
+}
+
+/**
+ * Compile and load all added rules unless they are already loaded.
+ * @return @c true if all rules are loaded, @c false otherwise.
+ *
+ * If every source file has rules compiled next to it during installation
+ * (see @c getLocalCompiledRuleFile()), they are loaded file by file.
+ * Otherwise, source files are compiled together into one set, which is taken
+ * from the cache of compiled rules if possible. When the set cannot be stored
+ * into the cache, it is compiled in memory.
+ */
+bool YaraScanner::prepareRules()
+{
+	if (prepared)
+	{
+		return stateIsValid;
+	}
+
+	if (!initialized)
+	{
+		if (yr_initialize() != ERROR_SUCCESS)
+		{
+			stateIsValid = false;
+			return false;
+		}
+		initialized = true;
+	}
+
+	if (!sourceFiles.empty() && !loadLocalCompiledRules())
+	{
+		// Only trusted cached rules are returned, see isTrustedCachePath().
+		YR_RULES *rules = nullptr;
+		const auto compiledFile = getCompiledRuleFiles(sourceFiles, cacheDir);
+		if (compiledFile.empty()
+				|| yr_rules_load(compiledFile.c_str(), &rules) != ERROR_SUCCESS)
+		{
+			rules = compileRules(sourceFiles);
+		}
+
+		if (rules)
+		{
+			// Rules keep their namespaces from the compilation.
+			ruleSets.push_back({rules, std::string()});
+		}
+		else
+		{
+			// Do not let a single broken file disable all the other rules.
+			stateIsValid = false;
+			for (const auto &sourceFile : sourceFiles)
+			{
+				if (auto *fileRules = compileRules({sourceFile}))
+				{
+					ruleSets.push_back({fileRules, std::string()});
+				}
+			}
+		}
+	}
+
+	for (const auto &compiledFile : compiledFiles)
+	{
+		YR_RULES *rules = nullptr;
+		if (yr_rules_load(compiledFile.first.c_str(), &rules) == ERROR_SUCCESS)
+		{
+			ruleSets.push_back({rules, compiledFile.second});
+		}
+		else
+		{
+			stateIsValid = false;
+		}
+	}
+
+	prepared = true;
+	return stateIsValid;
+}
+
+/**
+ * Load rules of all source files from their local caches of compiled rules.
+ * @return @c true if the rules of all the files were loaded, @c false
+ *         otherwise (no rules are loaded in such a case).
+ */
+bool YaraScanner::loadLocalCompiledRules()
+{
+	std::vector<RuleSet> localSets;
+	for (const auto &sourceFile : sourceFiles)
+	{
+		YR_RULES *rules = nullptr;
+		const auto compiledFile = getLocalCompiledRuleFile(sourceFile.first);
+		if (compiledFile.empty()
+				|| yr_rules_load(compiledFile.c_str(), &rules) != ERROR_SUCCESS)
+		{
+			for (auto &localSet : localSets)
+			{
+				yr_rules_destroy(localSet.rules);
+			}
+			return false;
+		}
+
+		// Local caches are compiled into the default namespace.
+		localSets.push_back({rules, sourceFile.second});
+	}
+
+	ruleSets.insert(ruleSets.end(), localSets.begin(), localSets.end());
+	return true;
+}
+
+/**
+ * Remove results of the previous scan.
+ */
+void YaraScanner::clearResults()
+{
+	detected.clear();
+	undetected.clear();
+}
+
+/**
+ * Store a rule reported by YARA during a scan.
+ */
+int YaraScanner::scanCallback(int message, void *messageData, void *userData)
+{
+	auto *context = static_cast<ScanContext*>(userData);
+	if (message != CALLBACK_MSG_RULE_MATCHING
+			&& (message != CALLBACK_MSG_RULE_NOT_MATCHING || !context->storeAll))
+	{
+		return CALLBACK_CONTINUE;
+	}
+
+	auto *yrRule = static_cast<YR_RULE*>(messageData);
+	YaraRule rule;
+	rule.setName(yrRule->identifier);
+	addMetas(rule, yrRule);
+	addMatches(rule, yrRule, context->baseOffset);
+
+	const auto nameSpace = context->nameSpace->empty()
+			? std::string(yrRule->ns->name)
+			: *context->nameSpace;
+	auto &results = message == CALLBACK_MSG_RULE_MATCHING
+			? context->scanner->detected
+			: context->scanner->undetected;
+	results[nameSpace].push_back(std::move(rule));
+	return CALLBACK_CONTINUE;
+}
+
+} // namespace yara_cache
+} // namespace retdec
@@ -0,0 +1,139 @@
+/**
+ * @file src/yara-cachetool/yara_cache.cpp
+ * @brief Precompilation of YARA rules into the cache of compiled rules.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "retdec/utils/filesystem_path.h"
+#include "retdec/utils/string.h"
+#include "retdec/yara-cache/yara_cache.h"
+
+using namespace retdec::utils;
+using namespace retdec::yara_cache;
+
+
+/**
+ * Print usage.
+ */
+void printUsage()
+{
+	std::cout << "\nPrecompilation of YARA rules.\n"
+		<< "Usage: yara-cache [--cache-dir DIR | --local] PATH [PATH ...]\n\n"
+		<< "PATH is either a file with rules or a directory, which is searched\n"
+		<< "recursively for .yar and .yara files.\n\n"
+		<< "Options:\n"
+		<< "    --cache-dir DIR  Store compiled rules into DIR (default: "
+		<< getDefaultCacheDir() << ").\n"
+		<< "                     Only rules in directories and files owned by\n"
+		<< "                     the user and not writable by others are used.\n"
+		<< "    --local          Store compiled rules next to the source rules\n"
+		<< "                     (into " << LOCAL_CACHE_DIR_NAME << " directories).\n\n";
+}
+
+
+/**
+ * Print error message and return non-zero value.
+ *
+ * @param errorMessage message to print
+ * @return non-zero value
+ */
+int printError(
+	const std::string &errorMessage)
+{
+	std::cerr << "Error: " << errorMessage << "\n";
+	return 1;
+}
+
+
+/**
+ * Collect all files with rules in path.
+ *
+ * @param path file or directory
+ * @param ruleFiles collected files
+ */
+void collectRuleFiles(
+	const FilesystemPath &path,
+	std::vector<std::string> &ruleFiles)
+{
+	if (path.isFile()) {
+		ruleFiles.push_back(path.getPath());
+		return;
+	}
+
+	for (const auto &subpath : path) {
+		if (subpath->isDirectory()) {
+			collectRuleFiles(*subpath, ruleFiles);
+		}
+		else if (subpath->isFile() && (endsWith(subpath->getPath(), ".yar")
+				|| endsWith(subpath->getPath(), ".yara"))) {
+			ruleFiles.push_back(subpath->getPath());
+		}
+	}
+}
+
+
+/**
+ * Do actions according to command line arguments.
+ *
+ * @param args command line arguments
+ */
+int doActions(
+	const std::vector<std::string> &args)
+{
+	bool local = false;
+	std::string cacheDir = getDefaultCacheDir();
+	std::vector<std::string> ruleFiles;
+
+	for (std::size_t i = 0; i < args.size(); ++i) {
+		if (args[i] == "-h" || args[i] == "--help") {
+			printUsage();
+			return 0;
+		}
+		else if (args[i] == "--local") {
+			local = true;
+		}
+		else if (args[i] == "--cache-dir" && i + 1 < args.size()) {
+			cacheDir = args[++i];
+		}
+		else {
+			FilesystemPath path(args[i]);
+			if (!path.exists()) {
+				return printError("invalid path '" + args[i] + "'");
+			}
+			collectRuleFiles(path, ruleFiles);
+		}
+	}
+
+	if (ruleFiles.empty()) {
+		printUsage();
+		return 1;
+	}
+
+	int result = 0;
+	for (const auto &ruleFile : ruleFiles) {
+		if (isCompiledRuleFile(ruleFile)) {
+			continue;
+		}
+
+		std::string dir = cacheDir;
+		if (local) {
+			FilesystemPath localDir(FilesystemPath(ruleFile).getParentPath());
+			localDir.append(LOCAL_CACHE_DIR_NAME);
+			dir = localDir.getPath();
+		}
+		if (!addToCache(ruleFile, dir, local)) {
+			result = printError("failed to compile '" + ruleFile + "'");
+		}
+	}
+
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	return doActions(std::vector<std::string>(argv + 1, argv + argc));
+}
@@ -16,10 +16,6 @@ namespace tests {
 
 /**
  * Test reaching definition analysis.
- *
- * Richt now, this is just an example, how to create LLVM Module from string,
- * instead of manually constructing it instruction by instruction.
- * => Nowhing useful is tested at the moment.
  */
 class ReachingDefinitionsTests: public LlvmIrTests
 {
@@ -44,6 +40,229 @@ DummyTest)
 	EXPECT_EQ( nullptr, module->getGlobalVariable("glob1") );
 }
 
+TEST_F(ReachingDefinitionsTests,
+useIsReachedByLastDefinitionInTheSameBasicBlock)
+{
+	parseInput(R"(
+		@glob0 = global i32 0
+		define void @func1() {
+			store i32 1, i32* @glob0
+			store i32 2, i32* @glob0
+			%x = load i32, i32* @glob0
+			ret void
+		}
+	)");
+	auto* s1 = getNthInstruction<StoreInst>(0);
+	auto* s2 = getNthInstruction<StoreInst>(1);
+	auto* x = getInstructionByName("x");
+
+	RDA.runOnModule(*module);
+
+	auto& defs = RDA.defsFromUse(x);
+	ASSERT_EQ(1, defs.size());
+	EXPECT_EQ(s2, (*defs.begin())->def);
+	EXPECT_TRUE(RDA.usesFromDef(s1).empty());
+	EXPECT_EQ(1, RDA.usesFromDef(s2).size());
+}
+
+TEST_F(ReachingDefinitionsTests,
+useIsReachedByDefinitionsFromAllPredecessors)
+{
+	parseInput(R"(
+		@glob0 = global i32 0
+		@glob1 = global i32 0
+		define void @func1(i1 %c) {
+			store i32 0, i32* @glob0
+			br i1 %c, label %left, label %right
+		left:
+			store i32 1, i32* @glob0
+			store i32 1, i32* @glob1
+			br label %end
+		right:
+			store i32 2, i32* @glob0
+			br label %end
+		end:
+			%x = load i32, i32* @glob0
+			%y = load i32, i32* @glob1
+			ret void
+		}
+	)");
+	auto* s0 = getNthInstruction<StoreInst>(0);
+	auto* s1 = getNthInstruction<StoreInst>(1);
+	auto* s2 = getNthInstruction<StoreInst>(2);
+	auto* s3 = getNthInstruction<StoreInst>(3);
+	auto* x = getInstructionByName("x");
+	auto* y = getInstructionByName("y");
+
+	RDA.runOnModule(*module);
+
+	auto& xDefs = RDA.defsFromUse(x);
+	EXPECT_EQ(2, xDefs.size());
+	EXPECT_TRUE(xDefs.count(const_cast<Definition*>(RDA.getDef(s1))));
+	EXPECT_TRUE(xDefs.count(const_cast<Definition*>(RDA.getDef(s3))));
+	EXPECT_TRUE(RDA.usesFromDef(s0).empty());
+	auto& yDefs = RDA.defsFromUse(y);
+	ASSERT_EQ(1, yDefs.size());
+	EXPECT_EQ(s2, (*yDefs.begin())->def);
+}
+
+TEST_F(ReachingDefinitionsTests,
+definitionsArePropagatedThroughLoops)
+{
+	parseInput(R"(
+		@glob0 = global i32 0
+		define void @func1(i1 %c) {
+			store i32 0, i32* @glob0
+			br label %loop
+		loop:
+			%x = load i32, i32* @glob0
+			%a = add i32 %x, 1
+			store i32 %a, i32* @glob0
+			br i1 %c, label %loop, label %end
+		end:
+			ret void
+		}
+	)");
+	auto* s0 = getNthInstruction<StoreInst>(0);
+	auto* s1 = getNthInstruction<StoreInst>(1);
+	auto* x = getInstructionByName("x");
+
+	RDA.runOnModule(*module);
+
+	auto& defs = RDA.defsFromUse(x);
+	EXPECT_EQ(2, defs.size());
+	EXPECT_TRUE(defs.count(const_cast<Definition*>(RDA.getDef(s0))));
+	EXPECT_TRUE(defs.count(const_cast<Definition*>(RDA.getDef(s1))));
+}
+
+TEST_F(ReachingDefinitionsTests,
+runOnFunctionKeepsResultsOfOtherFunctions)
+{
+	parseInput(R"(
+		@glob0 = global i32 0
+		define void @func1() {
+			store i32 1, i32* @glob0
+			%x = load i32, i32* @glob0
+			ret void
+		}
+		define void @func2() {
+			store i32 2, i32* @glob0
+			%y = load i32, i32* @glob0
+			ret void
+		}
+	)");
+	auto* x = getInstructionByName("x");
+	auto* y = getInstructionByName("y");
+
+	RDA.runOnFunction(*getFunctionByName("func1"));
+	RDA.runOnFunction(*getFunctionByName("func2"));
+	RDA.runOnFunction(*getFunctionByName("func1"));
+
+	EXPECT_TRUE(RDA.wasRun());
+	EXPECT_EQ(1, RDA.defsFromUse(x).size());
+	EXPECT_EQ(1, RDA.defsFromUse(y).size());
+}
+
+TEST_F(ReachingDefinitionsTests,
+runOnModuleComputesResultsOfAllFunctions)
+{
+	parseInput(R"(
+		@glob0 = global i32 0
+		define void @func1() {
+			store i32 1, i32* @glob0
+			%x = load i32, i32* @glob0
+			ret void
+		}
+		define void @func2() {
+			%y = load i32, i32* @glob0
+			ret void
+		}
+		declare void @func3()
+		define void @func4() {
+			store i32 2, i32* @glob0
+			store i32 3, i32* @glob0
+			%z = load i32, i32* @glob0
+			ret void
+		}
+	)");
+	auto* s0 = getNthInstruction<StoreInst>(0);
+	auto* s2 = getNthInstruction<StoreInst>(2);
+	auto* x = getInstructionByName("x");
+	auto* y = getInstructionByName("y");
+	auto* z = getInstructionByName("z");
+
+	RDA.runOnModule(*module);
+
+	auto& xDefs = RDA.defsFromUse(x);
+	ASSERT_EQ(1, xDefs.size());
+	EXPECT_EQ(s0, (*xDefs.begin())->def);
+	EXPECT_TRUE(RDA.defsFromUse(y).empty());
+	auto& zDefs = RDA.defsFromUse(z);
+	ASSERT_EQ(1, zDefs.size());
+	EXPECT_EQ(s2, (*zDefs.begin())->def);
+	EXPECT_EQ(1, RDA.usesFromDef(s2).size());
+}
+
+TEST_F(ReachingDefinitionsTests,
+runOnModuleComputesResultsOfFunctionsAnalysedInParallel)
+{
+	// Enough functions to be analysed by several threads.
+	std::string input = "@glob0 = global i32 0\n";
+	for (int i = 0; i < 100; ++i)
+	{
+		input += "define void @func" + std::to_string(i) + "() {\n"
+				"	store i32 " + std::to_string(i) + ", i32* @glob0\n"
+				"	%x = load i32, i32* @glob0\n"
+				"	ret void\n"
+				"}\n";
+	}
+	parseInput(input);
+
+	RDA.runOnModule(*module);
+
+	for (auto& f : *module)
+	{
+		auto* s = &f.front().front();
+		auto* x = s->getNextNode();
+		auto& defs = RDA.defsFromUse(x);
+		ASSERT_EQ(1, defs.size());
+		EXPECT_EQ(s, (*defs.begin())->def);
+	}
+}
+
+TEST_F(ReachingDefinitionsTests,
+runOnFunctionsRecomputesOnlyGivenFunctions)
+{
+	parseInput(R"(
+		@glob0 = global i32 0
+		define void @func1() {
+			store i32 1, i32* @glob0
+			%x = load i32, i32* @glob0
+			ret void
+		}
+		define void @func2() {
+			store i32 2, i32* @glob0
+			%y = load i32, i32* @glob0
+			ret void
+		}
+	)");
+	auto* x = getInstructionByName("x");
+	auto* y = getInstructionByName("y");
+	RDA.runOnModule(*module);
+	auto* yUse = RDA.getUse(y);
+	auto* s = new StoreInst(
+			ConstantInt::get(Type::getInt32Ty(context), 3),
+			getGlobalByName("glob0"),
+			x);
+
+	RDA.runOnFunctions(*module, {getFunctionByName("func1")});
+
+	auto& defs = RDA.defsFromUse(x);
+	ASSERT_EQ(1, defs.size());
+	EXPECT_EQ(s, (*defs.begin())->def);
+	EXPECT_EQ(yUse, RDA.getUse(y));
+}
+
 } // namespace tests
 } // namespace bin2llvmir
 } // namespace retdec
@@ -0,0 +1,85 @@
+/**
+* @file tests/bin2llvmir/analyses/symbolic_tree_tests.cpp
+* @brief Tests for the symbolic tree.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include "retdec/bin2llvmir/analyses/symbolic_tree.h"
+#include "bin2llvmir/utils/llvmir_tests.h"
+
+using namespace ::testing;
+using namespace llvm;
+
+namespace retdec {
+namespace bin2llvmir {
+namespace tests {
+
+/**
+ * Test symbolic tree.
+ */
+class SymbolicTreeTests: public LlvmIrTests
+{
+	protected:
+		ReachingDefinitionsAnalysis RDA;
+};
+
+TEST_F(SymbolicTreeTests,
+treeFollowsDefinitionsAndOperands)
+{
+	parseInput(R"(
+		@glob0 = global i32 0
+		define void @func1() {
+			store i32 1, i32* @glob0
+			%x = load i32, i32* @glob0
+			%y = add i32 %x, 2
+			ret void
+		}
+	)");
+	auto* s = getNthInstruction<StoreInst>();
+	auto* x = getInstructionByName("x");
+	auto* y = getInstructionByName("y");
+	RDA.runOnModule(*module);
+
+	SymbolicTree rootY(RDA, y);
+	SymbolicTree rootX(RDA, x);
+
+	ASSERT_TRUE(rootY.isConstructedSuccessfully());
+	ASSERT_EQ(2, rootY.ops.size());
+	EXPECT_EQ(x, rootY.ops[0].value);
+	EXPECT_EQ(y, rootY.ops[0].user);
+	ASSERT_EQ(1, rootY.ops[0].ops.size());
+	EXPECT_EQ(s, rootY.ops[0].ops[0].value);
+	ASSERT_EQ(1, rootY.ops[0].ops[0].ops.size());
+	EXPECT_TRUE(isa<ConstantInt>(rootY.ops[0].ops[0].ops[0].value));
+	EXPECT_TRUE(isa<ConstantInt>(rootY.ops[1].value));
+
+	ASSERT_TRUE(rootX.isConstructedSuccessfully());
+	EXPECT_EQ(x, rootX.value);
+	EXPECT_EQ(nullptr, rootX.user);
+	ASSERT_EQ(1, rootX.ops.size());
+	EXPECT_EQ(s, rootX.ops[0].value);
+}
+
+TEST_F(SymbolicTreeTests,
+allUniqueNodesCountToMaxUniqueNodes)
+{
+	parseInput(R"(
+		define void @func1() {
+			%y = add i32 1, 2
+			ret void
+		}
+	)");
+	auto* y = getInstructionByName("y");
+	RDA.runOnModule(*module);
+
+	SymbolicTree root3(RDA, y, nullptr, 3);
+	SymbolicTree root2(RDA, y, nullptr, 2);
+
+	EXPECT_TRUE(root3.isConstructedSuccessfully());
+	EXPECT_EQ(2, root3.ops.size());
+	EXPECT_FALSE(root2.isConstructedSuccessfully());
+}
+
+} // namespace tests
+} // namespace bin2llvmir
+} // namespace retdec
@@ -0,0 +1,206 @@
+/**
+* @file tests/bin2llvmir/optimizations/decoder/decoder_tests.cpp
+* @brief Tests for the @c Decoder pass.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+
+#include "retdec/bin2llvmir/optimizations/decoder/decoder.h"
+#include "bin2llvmir/utils/llvmir_tests.h"
+
+using namespace ::testing;
+using namespace llvm;
+using namespace retdec::fileformat;
+
+namespace retdec {
+namespace bin2llvmir {
+namespace tests {
+
+namespace {
+
+using Bytes = std::vector<std::uint8_t>;
+
+/// Address the tested code is loaded at.
+const retdec::utils::Address BASE = 0x1000;
+
+/**
+ * Function of @a size bytes made of @a prologue, nops and @a epilogue.
+ */
+Bytes makeFunction(const Bytes& prologue, const Bytes& epilogue, std::size_t size)
+{
+	Bytes f = prologue;
+	f.resize(size - epilogue.size(), 0x90);
+	f.insert(f.end(), epilogue.begin(), epilogue.end());
+	return f;
+}
+
+/**
+ * Static code signature (stacofin YARA rule) of function @a name with body
+ * @a body.
+ */
+std::string makeSignature(const std::string& name, const Bytes& body)
+{
+	std::stringstream s;
+	s << "rule " << name << "_rule\n"
+			<< "{\n"
+			<< "	meta:\n"
+			<< "		name = \"" << name << "\"\n"
+			<< "		size = " << body.size() << "\n"
+			<< "	strings:\n"
+			<< "		$1 = {";
+	for (auto b : body)
+	{
+		s << " " << std::hex << std::setw(2) << std::setfill('0')
+				<< unsigned(b);
+	}
+	s << " }\n"
+			<< "	condition:\n"
+			<< "		$1\n"
+			<< "}\n";
+	return s.str();
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Tests for the @c Decoder pass.
+ */
+class DecoderTests: public LlvmIrTests
+{
+	protected:
+		virtual void SetUp() override
+		{
+			ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory(
+					"retdec-decoder-tests", dir));
+		}
+
+		virtual void TearDown() override
+		{
+			for (auto& f : files)
+			{
+				llvm::sys::fs::remove(f);
+			}
+			llvm::sys::fs::remove(dir);
+		}
+
+		/**
+		 * Write @a content into file @a name in the temporary directory.
+		 * @return Path to the file.
+		 */
+		std::string writeFile(const std::string& name, const std::string& content)
+		{
+			llvm::SmallString<256> path(dir);
+			llvm::sys::path::append(path, name);
+			std::ofstream(path.str(), std::ios::binary) << content;
+			files.push_back(path.str());
+			return path.str();
+		}
+
+	protected:
+		Decoder pass;
+		llvm::SmallString<256> dir;
+		std::vector<std::string> files;
+};
+
+TEST_F(DecoderTests, skipStaticCodeCreatesOnlyDeclarationsOfStaticallyLinkedFunctions)
+{
+	// 0x1000: call abs; call _CrtSetCheckCount; ret
+	// 0x1010: abs
+	// 0x1040: _CrtSetCheckCount, main detection needs its body
+	auto absBody = makeFunction({0x55, 0x89, 0xe5}, {0x5d, 0xc3}, 0x30);
+	auto crtBody = makeFunction({0x53}, {0x5b, 0xc3}, 0x30);
+	Bytes code = {
+			0xe8, 0x0b, 0x00, 0x00, 0x00,
+			0xe8, 0x36, 0x00, 0x00, 0x00,
+			0xc3,
+			0x90, 0x90, 0x90, 0x90, 0x90};
+	code.insert(code.end(), absBody.begin(), absBody.end());
+	code.insert(code.end(), crtBody.begin(), crtBody.end());
+
+	auto sigPath = writeFile(
+			"static-code.yara",
+			makeSignature("abs", absBody)
+					+ makeSignature("_CrtSetCheckCount", crtBody));
+	// LTI files are loaded by the prefix of their names.
+	auto ltiPath = writeFile("cstdlib.json", R"({
+		"functions": {
+			"abs": {
+				"decl": "int abs(int j);",
+				"header": "stdlib.h",
+				"name": "abs",
+				"params": [
+					{
+						"name": "j",
+						"type": "46f8ab7c0cff9df7cd124852e26022a6bf89e315"
+					}
+				],
+				"ret_type": "46f8ab7c0cff9df7cd124852e26022a6bf89e315"
+			}
+		},
+		"types": {
+			"46f8ab7c0cff9df7cd124852e26022a6bf89e315": {
+				"name": "int",
+				"type": "integral_type"
+			}
+		}
+	})");
+	auto binPath = writeFile(
+			"input.bin",
+			std::string(code.begin(), code.end()));
+
+	parseInput("");
+	auto c = Config::fromJsonString(module.get(), R"({
+		"architecture" : {
+			"bitSize" : 32,
+			"endian" : "little",
+			"name" : "x86"
+		}
+	})");
+	c.getConfig().setEntryPoint(BASE);
+	c.getConfig().parameters.setIsSkipStaticCode(true);
+	c.getConfig().parameters.userStaticSignaturePaths.insert(sigPath);
+	c.getConfig().parameters.libraryTypeInfoPaths.insert(ltiPath);
+	auto format = std::make_shared<RawDataFormat>(binPath);
+	format->setTargetArchitecture(Architecture::X86);
+	format->setBaseAddress(BASE);
+	format->setEntryPoint(BASE);
+	auto image = FileImage(module.get(), format, &c);
+	ASSERT_TRUE(image.isOk());
+	LtiProvider::addLti(module.get(), &c, image.getImage());
+	auto* debug = DebugFormatProvider::addDebugFormat(
+			module.get(),
+			image.getImage(),
+			"",
+			0x0,
+			nullptr);
+
+	bool b = pass.runOnModuleCustom(*module, &c, &image, debug);
+
+	EXPECT_TRUE(b);
+	auto* absFnc = module->getFunction("abs");
+	ASSERT_NE(nullptr, absFnc);
+	EXPECT_TRUE(absFnc->isDeclaration());
+	EXPECT_TRUE(AsmInstruction(module.get(), BASE + 0x10).isInvalid());
+	auto* absCf = c.getConfigFunction(absFnc);
+	ASSERT_NE(nullptr, absCf);
+	EXPECT_TRUE(absCf->isStaticallyLinked());
+	EXPECT_EQ("int abs(int j);", absCf->getDeclarationString());
+
+	auto* crtFnc = module->getFunction("_CrtSetCheckCount");
+	ASSERT_NE(nullptr, crtFnc);
+	EXPECT_FALSE(crtFnc->isDeclaration());
+	EXPECT_TRUE(AsmInstruction(module.get(), BASE + 0x40).isValid());
+}
+
+} // namespace tests
+} // namespace bin2llvmir
+} // namespace retdec
@@ -0,0 +1,86 @@
+/**
+* @file tests/bin2llvmir/optimizations/idioms/idioms_analysis_tests.cpp
+* @brief Tests for the @c IdiomsAnalysis.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include "retdec/bin2llvmir/optimizations/idioms/idioms_analysis.h"
+#include "bin2llvmir/utils/llvmir_tests.h"
+
+using namespace ::testing;
+using namespace llvm;
+
+namespace retdec {
+namespace bin2llvmir {
+namespace tests {
+
+/**
+ * @brief Tests for the @c IdiomsAnalysis.
+ */
+class IdiomsAnalysisTests: public LlvmIrTests
+{
+	protected:
+		bool runIdioms(CC_compiler cc, CC_arch arch)
+		{
+			auto c = Config::empty(module.get());
+			IdiomsAnalysis idioms(module.get(), &c, cc, arch);
+			return idioms.doAnalysis(*getFunctionByName("fnc"), nullptr);
+		}
+};
+
+TEST_F(IdiomsAnalysisTests, idiomIsExchangedInBlockWithoutOtherRootOpcodes)
+{
+	parseInput(R"(
+		define i32 @fnc(i32 %a) {
+			%r = shl i32 %a, 2
+			ret i32 %r
+		}
+	)");
+
+	bool b = runIdioms(CC_Intel, ARCH_x86);
+
+	std::string exp = R"(
+		define i32 @fnc(i32 %a) {
+			%r = mul i32 %a, 4
+			ret i32 %r
+		}
+	)";
+	checkModuleAgainstExpectedIr(exp);
+	EXPECT_TRUE(b);
+}
+
+TEST_F(IdiomsAnalysisTests, idiomWithSecondRootOpcodeIsExchanged)
+{
+	// ((X ^ -1) u>> 31) --> X >= 0, the xor is not in the block of the root.
+	//
+	parseInput(R"(
+		define i32 @fnc(i32 %a) {
+		entry:
+			%x = xor i32 %a, -1
+			br label %next
+		next:
+			%r = lshr i32 %x, 31
+			ret i32 %r
+		}
+	)");
+
+	bool b = runIdioms(CC_Intel, ARCH_x86);
+
+	std::string exp = R"(
+		define i32 @fnc(i32 %a) {
+		entry:
+			%x = xor i32 %a, -1
+			br label %next
+		next:
+			%0 = icmp sge i32 %a, 0
+			%r = zext i1 %0 to i32
+			ret i32 %r
+		}
+	)";
+	checkModuleAgainstExpectedIr(exp);
+	EXPECT_TRUE(b);
+}
+
+} // namespace tests
+} // namespace bin2llvmir
+} // namespace retdec
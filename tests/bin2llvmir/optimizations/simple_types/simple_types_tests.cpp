@@ -0,0 +1,68 @@
+/**
+* @file tests/bin2llvmir/optimizations/simple_types/simple_types_tests.cpp
+* @brief Tests for the @c SimpleTypesAnalysis pass.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include "retdec/bin2llvmir/optimizations/simple_types/simple_types.h"
+#include "bin2llvmir/utils/llvmir_tests.h"
+
+using namespace ::testing;
+using namespace llvm;
+
+namespace retdec {
+namespace bin2llvmir {
+namespace tests {
+
+/**
+ * @brief Tests for the @c SimpleTypesAnalysis pass.
+ */
+class SimpleTypesAnalysisTests: public LlvmIrTests
+{
+	protected:
+		SimpleTypesAnalysis pass;
+};
+
+TEST_F(SimpleTypesAnalysisTests, valueFromRemovedSmallSetDoesNotCreateEquation)
+{
+	// @glob is alone in its set, which is removed. %p is related to it
+	// (pointer to @glob), but it is in the set of %arg.
+	//
+	parseInput(R"(
+		@glob = global i32 0
+		define void @fnc(i32 %arg) {
+			%p = ptrtoint i32* @glob to i32
+			%m = mul i32 %arg, %p
+			ret void
+		}
+	)");
+	auto c = Config::fromJsonString(module.get(), R"({
+		"architecture" : {
+			"bitSize" : 32,
+			"endian" : "little",
+			"name" : "x86"
+		}
+	})");
+	auto s = retdec::config::Storage::inMemory(0x1234);
+	c.getConfig().globals.insert(retdec::config::Object("glob", s));
+	auto format = createFormat();
+	auto image = FileImage(module.get(), std::move(format), &c);
+	ASSERT_TRUE(image.isOk());
+
+	bool b = pass.runOnModuleCustom(*module, &c, &image);
+
+	std::string exp = R"(
+		@glob = global i32 0
+		define void @fnc(i32 %arg) {
+			%p = ptrtoint i32* @glob to i32
+			%m = mul i32 %arg, %p
+			ret void
+		}
+	)";
+	checkModuleAgainstExpectedIr(exp);
+	EXPECT_FALSE(b);
+}
+
+} // namespace tests
+} // namespace bin2llvmir
+} // namespace retdec
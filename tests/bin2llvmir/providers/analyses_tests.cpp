@@ -0,0 +1,130 @@
+/**
+ * @file tests/bin2llvmir/providers/analyses_tests.cpp
+ * @brief Tests the @c AnalysesProvider.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include "retdec/bin2llvmir/providers/analyses.h"
+#include "bin2llvmir/utils/llvmir_tests.h"
+
+using namespace ::testing;
+using namespace llvm;
+
+namespace retdec {
+namespace bin2llvmir {
+namespace tests {
+
+/**
+ * @brief Tests the @c AnalysesProvider.
+ */
+class AnalysesProviderTests: public LlvmIrTests
+{
+
+};
+
+TEST_F(AnalysesProviderTests, getReachingDefinitionsReturnsNullptrForNoModule)
+{
+	EXPECT_EQ(nullptr, AnalysesProvider::getReachingDefinitions(nullptr, nullptr));
+}
+
+TEST_F(AnalysesProviderTests, getReachingDefinitionsReturnsSharedResults)
+{
+	parseInput(R"(
+		@glob0 = global i32 0
+		define void @func1() {
+			store i32 1, i32* @glob0
+			%x = load i32, i32* @glob0
+			ret void
+		}
+	)");
+	auto* s = getNthInstruction<StoreInst>();
+	auto* x = getInstructionByName("x");
+
+	auto* rda1 = AnalysesProvider::getReachingDefinitions(module.get(), nullptr);
+	auto* rda2 = AnalysesProvider::getReachingDefinitions(module.get(), nullptr);
+	auto* rda3 = AnalysesProvider::getReachingDefinitions(
+			module.get(),
+			nullptr,
+			true);
+
+	ASSERT_NE(nullptr, rda1);
+	EXPECT_EQ(rda1, rda2);
+	EXPECT_NE(rda1, rda3);
+	auto& defs = rda1->defsFromUse(x);
+	ASSERT_EQ(1, defs.size());
+	EXPECT_EQ(s, (*defs.begin())->def);
+}
+
+TEST_F(AnalysesProviderTests, getReachingDefinitionsRecomputesOnlyChangedFunctions)
+{
+	parseInput(R"(
+		@glob0 = global i32 0
+		define void @func1() {
+			store i32 1, i32* @glob0
+			%x = load i32, i32* @glob0
+			ret void
+		}
+		define void @func2() {
+			store i32 2, i32* @glob0
+			%y = load i32, i32* @glob0
+			ret void
+		}
+	)");
+	auto* x = getInstructionByName("x");
+	auto* y = getInstructionByName("y");
+	auto* rda = AnalysesProvider::getReachingDefinitions(module.get(), nullptr);
+	auto* yUse = rda->getUse(y);
+	ASSERT_NE(nullptr, yUse);
+
+	auto* glob0 = getGlobalByName("glob0");
+	auto* s = new StoreInst(
+			ConstantInt::get(Type::getInt32Ty(context), 3),
+			glob0,
+			x);
+	rda = AnalysesProvider::getReachingDefinitions(module.get(), nullptr);
+
+	auto& defs = rda->defsFromUse(x);
+	ASSERT_EQ(1, defs.size());
+	EXPECT_EQ(s, (*defs.begin())->def);
+	EXPECT_EQ(yUse, rda->getUse(y));
+}
+
+TEST_F(AnalysesProviderTests, getReachingDefinitionsRecomputesManyChangedFunctions)
+{
+	// Enough functions to be recomputed by several threads.
+	std::string input = "@glob0 = global i32 0\n";
+	for (int i = 0; i < 100; ++i)
+	{
+		input += "define void @func" + std::to_string(i) + "() {\n"
+				"	store i32 1, i32* @glob0\n"
+				"	%x = load i32, i32* @glob0\n"
+				"	ret void\n"
+				"}\n";
+	}
+	parseInput(input);
+	AnalysesProvider::getReachingDefinitions(module.get(), nullptr);
+
+	auto* glob0 = getGlobalByName("glob0");
+	std::vector<std::pair<Instruction*, StoreInst*>> loads;
+	for (auto& f : *module)
+	{
+		auto* x = f.front().front().getNextNode();
+		auto* s = new StoreInst(
+				ConstantInt::get(Type::getInt32Ty(context), 2),
+				glob0,
+				x);
+		loads.emplace_back(x, s);
+	}
+	auto* rda = AnalysesProvider::getReachingDefinitions(module.get(), nullptr);
+
+	for (auto& p : loads)
+	{
+		auto& defs = rda->defsFromUse(p.first);
+		ASSERT_EQ(1, defs.size());
+		EXPECT_EQ(p.second, (*defs.begin())->def);
+	}
+}
+
+} // namespace tests
+} // namespace bin2llvmir
+} // namespace retdec
@@ -326,6 +326,101 @@ TEST_F(AsmInstructionTests, AsmInstructionCtorAddressConstructsValidForGoodAddre
 	EXPECT_EQ(ref, a.getLlvmToAsmInstruction());
 }
 
+TEST_F(AsmInstructionTests, AsmInstructionCtorAddressConstructsValidForDistantAddresses)
+{
+	parseInput(R"(
+		define void @fnc() {
+			store volatile i64 1234, i64* @llvm2asm, !asm !1
+			store volatile i64 1238, i64* @llvm2asm, !asm !2
+			store volatile i64 305419896, i64* @llvm2asm, !asm !3
+			ret void
+		}
+		!1 = !{ !"name", i64 1234, i64 4, !"asm", !"annotation" }
+		!2 = !{ !"name", i64 1238, i64 4, !"asm", !"annotation" }
+		!3 = !{ !"name", i64 305419896, i64 4, !"asm", !"annotation" }
+		!0 = !{ !"llvm2asm" }
+		!llvmToAsmGlobalVariableName = !{ !0 }
+		@llvm2asm = global i64 0
+	)");
+	auto* s1 = getNthInstruction<StoreInst>(0);
+	auto* s2 = getNthInstruction<StoreInst>(1);
+	auto* s3 = getNthInstruction<StoreInst>(2);
+
+	EXPECT_EQ(s1, AsmInstruction(module.get(), 1234).getLlvmToAsmInstruction());
+	EXPECT_EQ(s2, AsmInstruction(module.get(), 1238).getLlvmToAsmInstruction());
+	EXPECT_EQ(s3, AsmInstruction(module.get(), 0x12345678).getLlvmToAsmInstruction());
+	EXPECT_TRUE(AsmInstruction(module.get(), 1236).isInvalid());
+}
+
+TEST_F(AsmInstructionTests, AsmInstructionCtorAddressConstructsInvalidForErasedInstruction)
+{
+	parseInput(R"(
+		define void @fnc() {
+			store volatile i64 1234, i64* @llvm2asm, !asm !1
+			ret void
+		}
+		!1 = !{ !"name", i64 1234, i64 10, !"asm", !"annotation" }
+		!0 = !{ !"llvm2asm" }
+		!llvmToAsmGlobalVariableName = !{ !0 }
+		@llvm2asm = global i64 0
+	)");
+	auto* s = getNthInstruction<StoreInst>();
+	ASSERT_TRUE(AsmInstruction(module.get(), 1234).isValid());
+
+	s->eraseFromParent();
+
+	EXPECT_TRUE(AsmInstruction(module.get(), 1234).isInvalid());
+}
+
+TEST_F(AsmInstructionTests, registerLlvmToAsmInstructionMakesNewInstructionAvailable)
+{
+	parseInput(R"(
+		define void @fnc() {
+			store volatile i64 1234, i64* @llvm2asm, !asm !1
+			ret void
+		}
+		!1 = !{ !"name", i64 1234, i64 10, !"asm", !"annotation" }
+		!0 = !{ !"llvm2asm" }
+		!llvmToAsmGlobalVariableName = !{ !0 }
+		@llvm2asm = global i64 0
+	)");
+	auto* s = getNthInstruction<StoreInst>();
+	ASSERT_TRUE(AsmInstruction(module.get(), 1234).isValid());
+	auto* ns = new StoreInst(
+			ConstantInt::get(Type::getInt64Ty(context), 1244),
+			s->getPointerOperand(),
+			s->getNextNode());
+
+	AsmInstruction::registerLlvmToAsmInstruction(ns);
+
+	EXPECT_EQ(ns, AsmInstruction(module.get(), 1244).getLlvmToAsmInstruction());
+	EXPECT_EQ(s, AsmInstruction(module.get(), 1234).getLlvmToAsmInstruction());
+}
+
+TEST_F(AsmInstructionTests, AsmInstructionCtorAddressFindsMovedInstruction)
+{
+	parseInput(R"(
+		define void @fnc1() {
+			store volatile i64 1234, i64* @llvm2asm, !asm !1
+			ret void
+		}
+		define void @fnc2() {
+			ret void
+		}
+		!1 = !{ !"name", i64 1234, i64 10, !"asm", !"annotation" }
+		!0 = !{ !"llvm2asm" }
+		!llvmToAsmGlobalVariableName = !{ !0 }
+		@llvm2asm = global i64 0
+	)");
+	auto* s = getNthInstruction<StoreInst>();
+	auto* f2 = getFunctionByName("fnc2");
+	ASSERT_TRUE(AsmInstruction(module.get(), 1234).isValid());
+
+	s->moveBefore(&f2->front().front());
+
+	EXPECT_EQ(s, AsmInstruction(module.get(), 1234).getLlvmToAsmInstruction());
+}
+
 //
 // AsmInstruction(llvm::Function*)
 //
@@ -722,6 +817,130 @@ TEST_F(AsmInstructionTests, eraseInstructionsFailsToEraseInstructionsButDoesNotC
 	checkModuleAgainstExpectedIr(exp);
 }
 
+TEST_F(AsmInstructionTests, eraseInstructionsReloadsGlobalsUsedByFollowingInstructions)
+{
+	parseInput(R"(
+		@r = global i32 0
+		define void @fnc() {
+			store volatile i64 1234, i64* @llvm2asm, !asm !1
+			%a = load i32, i32* @r
+			%b = mul i32 %a, 3
+			store volatile i64 5678, i64* @llvm2asm, !asm !2
+			%c = add i32 %a, 1
+			ret void
+		}
+		!1 = !{ !"name", i64 1234, i64 10, !"asm", !"annotation" }
+		!2 = !{ !"name", i64 5678, i64 10, !"asm", !"annotation" }
+		!0 = !{ !"llvm2asm" }
+		!llvmToAsmGlobalVariableName = !{ !0 }
+		@llvm2asm = global i64 0
+	)");
+	auto a = AsmInstruction(module.get(), 1234);
+	bool b = a.eraseInstructions();
+
+	std::string exp = R"(
+		@r = global i32 0
+		define void @fnc() {
+			store volatile i64 1234, i64* @llvm2asm, !asm !1
+			store volatile i64 5678, i64* @llvm2asm, !asm !2
+			%1 = load i32, i32* @r
+			%c = add i32 %1, 1
+			ret void
+		}
+		!1 = !{ !"name", i64 1234, i64 10, !"asm", !"annotation" }
+		!2 = !{ !"name", i64 5678, i64 10, !"asm", !"annotation" }
+		!0 = !{ !"llvm2asm" }
+		!llvmToAsmGlobalVariableName = !{ !0 }
+		@llvm2asm = global i64 0
+	)";
+	EXPECT_TRUE(b);
+	checkModuleAgainstExpectedIr(exp);
+}
+
+TEST_F(AsmInstructionTests, eraseInstructionsDoesNotReloadGlobalsStoredInBetween)
+{
+	parseInput(R"(
+		@r = global i32 0
+		define void @fnc() {
+			store volatile i64 1234, i64* @llvm2asm, !asm !1
+			%a = load i32, i32* @r
+			store volatile i64 5678, i64* @llvm2asm, !asm !2
+			store i32 1, i32* @r
+			%c = add i32 %a, 1
+			ret void
+		}
+		!1 = !{ !"name", i64 1234, i64 10, !"asm", !"annotation" }
+		!2 = !{ !"name", i64 5678, i64 10, !"asm", !"annotation" }
+		!0 = !{ !"llvm2asm" }
+		!llvmToAsmGlobalVariableName = !{ !0 }
+		@llvm2asm = global i64 0
+	)");
+	auto a = AsmInstruction(module.get(), 1234);
+	bool b = a.eraseInstructions();
+
+	std::string exp = R"(
+		@r = global i32 0
+		define void @fnc() {
+			store volatile i64 1234, i64* @llvm2asm, !asm !1
+			%a = load i32, i32* @r
+			store volatile i64 5678, i64* @llvm2asm, !asm !2
+			store i32 1, i32* @r
+			%c = add i32 %a, 1
+			ret void
+		}
+		!1 = !{ !"name", i64 1234, i64 10, !"asm", !"annotation" }
+		!2 = !{ !"name", i64 5678, i64 10, !"asm", !"annotation" }
+		!0 = !{ !"llvm2asm" }
+		!llvmToAsmGlobalVariableName = !{ !0 }
+		@llvm2asm = global i64 0
+	)";
+	EXPECT_FALSE(b);
+	checkModuleAgainstExpectedIr(exp);
+}
+
+TEST_F(AsmInstructionTests, eraseInstructionsDoesNotReloadGlobalsIfEraseFails)
+{
+	parseInput(R"(
+		@r = global i32 0
+		define void @fnc() {
+			store volatile i64 1234, i64* @llvm2asm, !asm !1
+			%a = load i32, i32* @r
+			%b = mul i32 %a, 3
+			store volatile i64 5678, i64* @llvm2asm, !asm !2
+			%c = add i32 %a, 1
+			%d = add i32 %b, 1
+			ret void
+		}
+		!1 = !{ !"name", i64 1234, i64 10, !"asm", !"annotation" }
+		!2 = !{ !"name", i64 5678, i64 10, !"asm", !"annotation" }
+		!0 = !{ !"llvm2asm" }
+		!llvmToAsmGlobalVariableName = !{ !0 }
+		@llvm2asm = global i64 0
+	)");
+	auto a = AsmInstruction(module.get(), 1234);
+	bool b = a.eraseInstructions();
+
+	std::string exp = R"(
+		@r = global i32 0
+		define void @fnc() {
+			store volatile i64 1234, i64* @llvm2asm, !asm !1
+			%a = load i32, i32* @r
+			%b = mul i32 %a, 3
+			store volatile i64 5678, i64* @llvm2asm, !asm !2
+			%c = add i32 %a, 1
+			%d = add i32 %b, 1
+			ret void
+		}
+		!1 = !{ !"name", i64 1234, i64 10, !"asm", !"annotation" }
+		!2 = !{ !"name", i64 5678, i64 10, !"asm", !"annotation" }
+		!0 = !{ !"llvm2asm" }
+		!llvmToAsmGlobalVariableName = !{ !0 }
+		@llvm2asm = global i64 0
+	)";
+	EXPECT_FALSE(b);
+	checkModuleAgainstExpectedIr(exp);
+}
+
 TEST_F(AsmInstructionTests, eraseInstructionsBasicBlocks1)
 {
 	parseInput(R"(
@@ -75,6 +75,20 @@ TEST_F(DemanglerProviderTests, addedDemanglerWorks)
 	EXPECT_EQ("wikipedia::article::print_to(std::ostream &)", name);
 }
 
+TEST_F(DemanglerProviderTests, demanglerOfTheSameKindIsSharedByModules)
+{
+	retdec::config::ToolInfo tool;
+	tool.setIsGcc();
+	retdec::config::ToolInfoContainer tools;
+	tools.insert(tool);
+	auto* r1 = DemanglerProvider::addDemangler(module.get(), tools);
+	parseInput(""); // creates a different module
+	auto* r2 = DemanglerProvider::addDemangler(module.get(), tools);
+
+	EXPECT_NE(nullptr, r1);
+	EXPECT_EQ(r1, r2);
+}
+
 TEST_F(DemanglerProviderTests, clearRemovesAllData)
 {
 	retdec::config::ToolInfo tool;
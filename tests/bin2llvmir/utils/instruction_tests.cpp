@@ -797,6 +797,165 @@ TEST_F(InstructionTests, insertAtBeginOfEmptyBasicBlock)
 	EXPECT_EQ(add, &b->front());
 }
 
+//
+// reloadGlobalsAfterSplit()
+//
+
+TEST_F(InstructionTests, reloadGlobalsAfterSplitReloadsGlobalUsedInNewBb)
+{
+	parseInput(R"(
+		@r = global i32 0
+		define void @fnc() {
+			%a = load i32, i32* @r
+			%b = add i32 %a, 1
+			%c = add i32 %a, 2
+			%d = add i32 %a, 3
+			ret void
+		}
+	)");
+	auto* c = getInstructionByName("c");
+	auto* oldBb = c->getParent();
+	auto* newBb = oldBb->splitBasicBlock(c);
+
+	reloadGlobalsAfterSplit(oldBb, newBb);
+
+	std::string exp = R"(
+		@r = global i32 0
+		define void @fnc() {
+			%a = load i32, i32* @r
+			%b = add i32 %a, 1
+			br label %1
+			%2 = load i32, i32* @r
+			%c = add i32 %2, 2
+			%d = add i32 %2, 3
+			ret void
+		}
+	)";
+	checkModuleAgainstExpectedIr(exp);
+}
+
+TEST_F(InstructionTests, reloadGlobalsAfterSplitKeepsOtherValues)
+{
+	parseInput(R"(
+		define void @fnc() {
+			%r = alloca i32
+			%a = load i32, i32* %r
+			%b = add i32 %a, 1
+			ret void
+		}
+	)");
+	auto* b = getInstructionByName("b");
+	auto* oldBb = b->getParent();
+	auto* newBb = oldBb->splitBasicBlock(b);
+
+	reloadGlobalsAfterSplit(oldBb, newBb);
+
+	std::string exp = R"(
+		define void @fnc() {
+			%r = alloca i32
+			%a = load i32, i32* %r
+			br label %1
+			%b = add i32 %a, 1
+			ret void
+		}
+	)";
+	checkModuleAgainstExpectedIr(exp);
+}
+
+TEST_F(InstructionTests, reloadGlobalsAfterSplitKeepsValueStoredBeforeSplit)
+{
+	parseInput(R"(
+		@r = global i32 0
+		define void @fnc() {
+			%a = load i32, i32* @r
+			store i32 1, i32* @r
+			%b = add i32 %a, 1
+			ret void
+		}
+	)");
+	auto* b = getInstructionByName("b");
+	auto* oldBb = b->getParent();
+	auto* newBb = oldBb->splitBasicBlock(b);
+
+	reloadGlobalsAfterSplit(oldBb, newBb);
+
+	std::string exp = R"(
+		@r = global i32 0
+		define void @fnc() {
+			%a = load i32, i32* @r
+			store i32 1, i32* @r
+			br label %1
+			%b = add i32 %a, 1
+			ret void
+		}
+	)";
+	checkModuleAgainstExpectedIr(exp);
+}
+
+TEST_F(InstructionTests, reloadGlobalsAfterSplitKeepsValueStoredAfterSplit)
+{
+	parseInput(R"(
+		@r = global i32 0
+		define void @fnc() {
+			%a = load i32, i32* @r
+			%b = add i32 %a, 1
+			store i32 1, i32* @r
+			%c = add i32 %a, 2
+			ret void
+		}
+	)");
+	auto* b = getInstructionByName("b");
+	auto* oldBb = b->getParent();
+	auto* newBb = oldBb->splitBasicBlock(b);
+
+	reloadGlobalsAfterSplit(oldBb, newBb);
+
+	std::string exp = R"(
+		@r = global i32 0
+		define void @fnc() {
+			%a = load i32, i32* @r
+			br label %1
+			%b = add i32 %a, 1
+			store i32 1, i32* @r
+			%c = add i32 %a, 2
+			ret void
+		}
+	)";
+	checkModuleAgainstExpectedIr(exp);
+}
+
+TEST_F(InstructionTests, reloadGlobalsAfterSplitKeepsValueIfCallInBetween)
+{
+	parseInput(R"(
+		@r = global i32 0
+		declare void @foo()
+		define void @fnc() {
+			%a = load i32, i32* @r
+			call void @foo()
+			%b = add i32 %a, 1
+			ret void
+		}
+	)");
+	auto* b = getInstructionByName("b");
+	auto* oldBb = b->getParent();
+	auto* newBb = oldBb->splitBasicBlock(b);
+
+	reloadGlobalsAfterSplit(oldBb, newBb);
+
+	std::string exp = R"(
+		@r = global i32 0
+		declare void @foo()
+		define void @fnc() {
+			%a = load i32, i32* @r
+			call void @foo()
+			br label %1
+			%b = add i32 %a, 1
+			ret void
+		}
+	)";
+	checkModuleAgainstExpectedIr(exp);
+}
+
 //
 // splitFunctionOn()
 //
@@ -829,6 +988,35 @@ TEST_F(InstructionTests, splitFunctionOnBasic)
 	EXPECT_TRUE(newFnc->getName().empty());
 }
 
+TEST_F(InstructionTests, splitFunctionOnReloadsGlobals)
+{
+	parseInput(R"(
+		@r = global i32 0
+		define void @fnc() {
+			%a = load i32, i32* @r
+			%b = add i32 %a, 1
+			ret void
+		}
+	)");
+	auto* b = getInstructionByName("b");
+
+	splitFunctionOn(b);
+
+	std::string exp = R"(
+		@r = global i32 0
+		define void @fnc() {
+			%a = load i32, i32* @r
+			ret void
+		}
+		define void @0() {
+			%1 = load i32, i32* @r
+			%b = add i32 %1, 1
+			ret void
+		}
+	)";
+	checkModuleAgainstExpectedIr(exp);
+}
+
 TEST_F(InstructionTests, splitFunctionOnWithName)
 {
 	parseInput(R"(
@@ -20,6 +20,7 @@
 #include "retdec/llvm-support/utils.h"
 #include "retdec/utils/string.h"
 #include "retdec/bin2llvmir/providers/abi.h"
+#include "retdec/bin2llvmir/providers/analyses.h"
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
 #include "retdec/bin2llvmir/providers/config.h"
 #include "retdec/bin2llvmir/providers/debugformat.h"
@@ -47,6 +48,7 @@ class LlvmIrTests : public retdec::llvm_support::tests::LlvmIrTests
 		void clearAllStaticData()
 		{
 			AbiProvider::clear();
+			AnalysesProvider::clear();
 			ConfigProvider::clear();
 			DebugFormatProvider::clear();
 			DemanglerProvider::clear();
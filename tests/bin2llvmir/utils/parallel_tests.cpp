@@ -0,0 +1,83 @@
+/**
+ * @file tests/bin2llvmir/utils/tests/parallel_tests.cpp
+ * @brief Tests for the @c parallel utils module.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/bin2llvmir/utils/parallel.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace bin2llvmir {
+namespace tests {
+
+/**
+ * @brief Tests for the @c parallel module.
+ */
+class ParallelTests: public Test
+{
+
+};
+
+TEST_F(ParallelTests, runInParallelRunsEachTaskOnce)
+{
+	std::vector<std::atomic<int>> runs(100);
+	for (auto& r : runs)
+	{
+		r = 0;
+	}
+
+	runInParallel(runs.size(), [&runs](std::size_t i) { ++runs[i]; }, 4);
+
+	for (auto& r : runs)
+	{
+		EXPECT_EQ(1, r);
+	}
+}
+
+TEST_F(ParallelTests, runInParallelWithNoTasksDoesNothing)
+{
+	bool run = false;
+	runInParallel(0, [&run](std::size_t) { run = true; });
+	EXPECT_FALSE(run);
+}
+
+TEST_F(ParallelTests, runInParallelRethrowsTaskException)
+{
+	std::atomic<int> runs(0);
+
+	EXPECT_THROW(
+		runInParallel(100, [&runs](std::size_t i)
+		{
+			++runs;
+			if (i == 10)
+			{
+				throw std::runtime_error("task failed");
+			}
+		}, 4),
+		std::runtime_error
+	);
+	EXPECT_LE(11, runs);
+}
+
+TEST_F(ParallelTests, runInParallelOnOneThreadRethrowsTaskException)
+{
+	EXPECT_THROW(
+		runInParallel(10, [](std::size_t)
+		{
+			throw std::runtime_error("task failed");
+		}, 1),
+		std::runtime_error
+	);
+}
+
+} // namespace tests
+} // namespace bin2llvmir
+} // namespace retdec
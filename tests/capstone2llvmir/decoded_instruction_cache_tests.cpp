@@ -0,0 +1,132 @@
+/**
+ * @file tests/capstone2llvmir/decoded_instruction_cache_tests.cpp
+ * @brief DecodedInstructionCache unit tests.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/capstone2llvmir/decoded_instruction_cache.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace capstone2llvmir {
+namespace tests {
+
+class DecodedInstructionCacheTests : public Test
+{
+	protected:
+		virtual void SetUp() override
+		{
+			ASSERT_EQ(CS_ERR_OK, cs_open(CS_ARCH_X86, CS_MODE_32, &handle));
+			ASSERT_EQ(CS_ERR_OK, cs_option(handle, CS_OPT_DETAIL, CS_OPT_ON));
+			insn = cs_malloc(handle);
+		}
+
+		virtual void TearDown() override
+		{
+			cs_free(insn, 1);
+			cs_close(&handle);
+		}
+
+	protected:
+		csh handle = 0;
+		cs_insn* insn = nullptr;
+		DecodedInstructionCache cache{CS_ARCH_X86, CS_MODE_32, CS_MODE_LITTLE_ENDIAN};
+};
+
+TEST_F(DecodedInstructionCacheTests, cachedInstructionIsSameAsDisassembledOne)
+{
+	// push ebp; mov ebp, esp; mov eax, 0x12345678; ret
+	std::vector<uint8_t> bytes = {
+			0x55, 0x89, 0xe5, 0xb8, 0x78, 0x56, 0x34, 0x12, 0xc3};
+	cache.addRange(0x1000, std::vector<uint8_t>(bytes));
+	cache.decode(2);
+	EXPECT_EQ(4, cache.size());
+
+	const uint8_t* code = bytes.data() + 3;
+	size_t size = bytes.size() - 3;
+	uint64_t address = 0x1003;
+	ASSERT_TRUE(cache.disasmIter(&code, &size, &address, insn));
+	EXPECT_EQ(bytes.data() + 8, code);
+	EXPECT_EQ(1, size);
+	EXPECT_EQ(0x1008, address);
+	EXPECT_EQ(X86_INS_MOV, insn->id);
+	EXPECT_EQ(0x1003, insn->address);
+	EXPECT_EQ(5, insn->size);
+	EXPECT_STREQ("mov", insn->mnemonic);
+	EXPECT_STREQ("eax, 0x12345678", insn->op_str);
+	ASSERT_EQ(2, insn->detail->x86.op_count);
+	EXPECT_EQ(X86_OP_REG, insn->detail->x86.operands[0].type);
+	EXPECT_EQ(X86_REG_EAX, insn->detail->x86.operands[0].reg);
+	EXPECT_EQ(X86_OP_IMM, insn->detail->x86.operands[1].type);
+	EXPECT_EQ(0x12345678, insn->detail->x86.operands[1].imm);
+}
+
+TEST_F(DecodedInstructionCacheTests, instructionNotInCacheIsNotReturned)
+{
+	std::vector<uint8_t> bytes = {0x55, 0x89, 0xe5, 0xc3};
+	cache.addRange(0x1000, std::vector<uint8_t>(bytes));
+	cache.decode();
+
+	// Middle of an instruction.
+	const uint8_t* code = bytes.data() + 2;
+	size_t size = bytes.size() - 2;
+	uint64_t address = 0x1002;
+	EXPECT_FALSE(cache.disasmIter(&code, &size, &address, insn));
+	EXPECT_EQ(0x1002, address);
+
+	// Outside of the added range.
+	address = 0x2000;
+	EXPECT_FALSE(cache.disasmIter(&code, &size, &address, insn));
+}
+
+TEST_F(DecodedInstructionCacheTests, instructionLongerThanAvailableBytesIsNotReturned)
+{
+	std::vector<uint8_t> bytes = {0xb8, 0x78, 0x56, 0x34, 0x12};
+	cache.addRange(0x1000, std::vector<uint8_t>(bytes));
+	cache.decode();
+
+	const uint8_t* code = bytes.data();
+	size_t size = 3;
+	uint64_t address = 0x1000;
+	EXPECT_FALSE(cache.disasmIter(&code, &size, &address, insn));
+	EXPECT_EQ(3, size);
+}
+
+TEST_F(DecodedInstructionCacheTests, instructionWithDifferentBytesIsNotReturned)
+{
+	std::vector<uint8_t> bytes = {0x55, 0xc3};
+	cache.addRange(0x1000, std::vector<uint8_t>(bytes));
+	cache.decode();
+
+	// Same address and size, but different bytes (nop instead of push ebp).
+	std::vector<uint8_t> other = {0x90, 0xc3};
+	const uint8_t* code = other.data();
+	size_t size = other.size();
+	uint64_t address = 0x1000;
+	EXPECT_FALSE(cache.disasmIter(&code, &size, &address, insn));
+	EXPECT_EQ(other.data(), code);
+	EXPECT_EQ(0x1000, address);
+}
+
+TEST_F(DecodedInstructionCacheTests, instructionsBehindUndecodableBytesAreCached)
+{
+	// ret; <invalid bytes>; nop
+	std::vector<uint8_t> bytes = {0xc3, 0xff, 0xff, 0xff, 0xff, 0x90};
+	cache.addRange(0x1000, std::vector<uint8_t>(bytes));
+	cache.decode();
+
+	const uint8_t* code = bytes.data() + 5;
+	size_t size = 1;
+	uint64_t address = 0x1005;
+	ASSERT_TRUE(cache.disasmIter(&code, &size, &address, insn));
+	EXPECT_EQ(X86_INS_NOP, insn->id);
+}
+
+} // namespace tests
+} // namespace capstone2llvmir
+} // namespace retdec
@@ -10514,6 +10514,109 @@ TEST_P(Capstone2LlvmIrTranslatorX86Tests, X86_INS_RDTSCP)
 	});
 }
 
+//
+// Overwritten flags
+//
+
+TEST_P(Capstone2LlvmIrTranslatorX86Tests, overwritten_flags_are_not_stored)
+{
+	ONLY_MODE_32;
+
+	setRegisters({
+		{X86_REG_EAX, 0x1},
+		{X86_REG_EBX, 0x2},
+		{X86_REG_ECX, 0x3},
+	});
+
+	auto* f = emulate("add eax, ebx; sub eax, ecx");
+
+	std::size_t zfStores = 0;
+	for (auto& insn : llvm::instructions(f))
+	{
+		if (auto* s = llvm::dyn_cast<llvm::StoreInst>(&insn))
+		{
+			zfStores += s->getPointerOperand() == getRegister(X86_REG_ZF);
+		}
+	}
+	EXPECT_EQ(1, zfStores);
+
+	EXPECT_JUST_REGISTERS_STORED({
+		{X86_REG_EAX, 0x0},
+		{X86_REG_AF, false},
+		{X86_REG_CF, false},
+		{X86_REG_OF, false},
+		{X86_REG_SF, false},
+		{X86_REG_ZF, true},
+		{X86_REG_PF, true},
+	});
+	EXPECT_NO_MEMORY_LOADED_STORED();
+	EXPECT_NO_VALUE_CALLED();
+}
+
+TEST_P(Capstone2LlvmIrTranslatorX86Tests, read_flags_are_stored)
+{
+	ONLY_MODE_32;
+
+	setRegisters({
+		{X86_REG_EAX, 0xffffffff},
+		{X86_REG_EBX, 0x1},
+		{X86_REG_ECX, 0x0},
+		{X86_REG_EDX, 0x0},
+	});
+
+	emulate("add eax, ebx; adc ecx, edx");
+
+	EXPECT_JUST_REGISTERS_STORED({
+		{X86_REG_EAX, 0x0},
+		{X86_REG_ECX, 0x1},
+		{X86_REG_AF, false},
+		{X86_REG_CF, false},
+		{X86_REG_OF, false},
+		{X86_REG_SF, false},
+		{X86_REG_ZF, false},
+		{X86_REG_PF, false},
+	});
+	EXPECT_NO_MEMORY_LOADED_STORED();
+	EXPECT_NO_VALUE_CALLED();
+}
+
+//
+// Register load caching
+//
+
+TEST_P(Capstone2LlvmIrTranslatorX86Tests, register_load_caching_reuses_loads)
+{
+	ONLY_MODE_32;
+
+	setRegisters({
+		{X86_REG_EAX, 0x1234},
+		{X86_REG_EBX, 0x1},
+	});
+
+	_translator->setRegisterLoadCaching(true);
+	auto* f = emulate("mov ecx, eax; mov edx, eax; mov eax, ebx; mov esi, eax");
+
+	std::size_t eaxLoads = 0;
+	for (auto& insn : llvm::instructions(f))
+	{
+		if (auto* l = llvm::dyn_cast<llvm::LoadInst>(&insn))
+		{
+			eaxLoads += l->getPointerOperand() == getRegister(X86_REG_EAX);
+		}
+	}
+	EXPECT_EQ(2, eaxLoads);
+
+	EXPECT_JUST_REGISTERS_LOADED({X86_REG_EAX, X86_REG_EBX});
+	EXPECT_JUST_REGISTERS_STORED({
+		{X86_REG_EAX, 0x1},
+		{X86_REG_ECX, 0x1234},
+		{X86_REG_EDX, 0x1234},
+		{X86_REG_ESI, 0x1},
+	});
+	EXPECT_NO_MEMORY_LOADED_STORED();
+	EXPECT_NO_VALUE_CALLED();
+}
+
 } // namespace tests
 } // namespace capstone2llvmir
 } // namespace retdec
@@ -0,0 +1,74 @@
+/**
+ * @file tests/config/parameters_tests.cpp
+ * @brief Tests for the @c parameters module.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <gtest/gtest.h>
+
+#include "retdec/config/parameters.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace config {
+namespace tests {
+
+class ParametersTests : public Test
+{
+	protected:
+		Parameters params;
+};
+
+TEST_F(ParametersTests, SkipStaticCodeIsNotSetByDefault)
+{
+	EXPECT_FALSE(params.isSkipStaticCode());
+}
+
+TEST_F(ParametersTests, SkipStaticCodeIsReadFromJson)
+{
+	Json::Value val;
+	val["skipStaticCode"] = true;
+
+	params.readJsonValue(val);
+
+	EXPECT_TRUE(params.isSkipStaticCode());
+}
+
+TEST_F(ParametersTests, SkipStaticCodeIsNotSetIfMissingInJson)
+{
+	params.setIsSkipStaticCode(true);
+	Json::Value val;
+	val["keepAllFuncs"] = true;
+
+	params.readJsonValue(val);
+
+	EXPECT_FALSE(params.isSkipStaticCode());
+}
+
+TEST_F(ParametersTests, SkipStaticCodeSurvivesJsonRoundTrip)
+{
+	params.setIsSkipStaticCode(true);
+
+	Parameters read;
+	read.readJsonValue(params.getJsonValue());
+
+	EXPECT_TRUE(read.isSkipStaticCode());
+	EXPECT_FALSE(read.isKeepAllFunctions());
+	EXPECT_FALSE(read.isSelectedDecodeOnly());
+}
+
+TEST_F(ParametersTests, UnsetSkipStaticCodeSurvivesJsonRoundTrip)
+{
+	params.setIsSelectedDecodeOnly(true);
+
+	Parameters read;
+	read.readJsonValue(params.getJsonValue());
+
+	EXPECT_FALSE(read.isSkipStaticCode());
+	EXPECT_TRUE(read.isSelectedDecodeOnly());
+}
+
+} // namespace tests
+} // namespace config
+} // namespace retdec
@@ -0,0 +1,170 @@
+/**
+ * @file tests/cpdetect/search_tests.cpp
+ * @brief Tests for the @c search module.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "retdec/cpdetect/compiler_detector/search/search.h"
+#include "retdec/fileformat/file_format/raw_data/raw_data_format.h"
+
+using namespace ::testing;
+using namespace retdec::fileformat;
+
+namespace retdec {
+namespace cpdetect {
+namespace tests {
+
+/**
+ * Tests for the @c search module
+ */
+class SearchTests : public Test
+{
+	protected:
+		/**
+		 * Search in x86 little endian file with content @a content.
+		 */
+		void setContent(const std::string &content)
+		{
+			inputStream << content;
+			parser = std::make_unique<RawDataFormat>(inputStream);
+			search = std::make_unique<Search>(*parser);
+		}
+
+		std::size_t lastOffset() const
+		{
+			return parser->getLoadedFileLength() - 1;
+		}
+
+	protected:
+		std::stringstream inputStream;
+		std::unique_ptr<RawDataFormat> parser;
+		std::unique_ptr<Search> search;
+};
+
+//
+// SignaturePattern
+//
+
+TEST_F(SearchTests, SignaturePatternCountsFixedNibblesAndSlashes)
+{
+	Search::SignaturePattern signature("55-B?C/6A00;comment");
+
+	EXPECT_TRUE(signature.isValid());
+	EXPECT_EQ(11, signature.getLength());
+	EXPECT_EQ(1, signature.getNumberOfSlashes());
+	EXPECT_EQ(8, signature.getNumberOfFixedNibbles());
+	ASSERT_EQ(2, signature.getParts().size());
+	EXPECT_EQ(6, signature.getParts()[0].nibbles);
+	EXPECT_EQ(4, signature.getParts()[1].nibbles);
+}
+
+TEST_F(SearchTests, SignaturePatternWithUnsupportedCharacterIsInvalid)
+{
+	setContent(std::string("\x55\x8B\xEC", 3));
+	Search::SignaturePattern signature("558X");
+
+	EXPECT_FALSE(signature.isValid());
+	EXPECT_EQ(0, search->findUnslashedSignature(signature, 0, lastOffset()));
+	EXPECT_EQ(0, search->exactComparison(signature, 0));
+}
+
+//
+// findUnslashedSignature()
+//
+
+TEST_F(SearchTests, findUnslashedSignatureFindsSignatureWithWildcards)
+{
+	setContent(std::string("\x90\x55\x8B\xEC\x6A\x00\x90", 7));
+
+	EXPECT_EQ(6, search->findUnslashedSignature("558B--6A", 0, lastOffset()));
+	EXPECT_EQ(6, search->findUnslashedSignature("558B??6A", 0, lastOffset()));
+	EXPECT_EQ(0, search->findUnslashedSignature("558B--6B", 0, lastOffset()));
+}
+
+TEST_F(SearchTests, findUnslashedSignatureUsesNibbleMasks)
+{
+	setContent(std::string("\x90\x55\x8B\xEC\x6A\x00\x90", 7));
+
+	EXPECT_EQ(5, search->findUnslashedSignature("5-8BEC", 0, lastOffset()));
+	EXPECT_EQ(5, search->findUnslashedSignature("558?EC", 0, lastOffset()));
+	EXPECT_EQ(0, search->findUnslashedSignature("5-8CEC", 0, lastOffset()));
+}
+
+TEST_F(SearchTests, findUnslashedSignatureFindsSignatureStartingInMiddleOfByte)
+{
+	setContent(std::string("\x90\x55\x8B\xEC\x6A\x00\x90", 7));
+
+	// 0x55 0x8B 0xEC contains nibbles 5 8 B E only from the second nibble.
+	EXPECT_EQ(4, search->findUnslashedSignature("58BE", 0, lastOffset()));
+	EXPECT_EQ(0, search->findUnslashedSignature("58BF", 0, lastOffset()));
+}
+
+TEST_F(SearchTests, findUnslashedSignatureFindsOnlySignatureInsideArea)
+{
+	setContent(std::string("\x90\x55\x8B\xEC\x6A\x00\x90", 7));
+
+	EXPECT_EQ(6, search->findUnslashedSignature("558BEC", 1, 3));
+	EXPECT_EQ(0, search->findUnslashedSignature("558BEC", 1, 2));
+	EXPECT_EQ(0, search->findUnslashedSignature("558BEC", 2, lastOffset()));
+}
+
+TEST_F(SearchTests, findUnslashedSignatureFindsSignatureAtEndOfFile)
+{
+	// Old nibble-string search required one more nibble after the match.
+	setContent(std::string("\x90\x90\x6A\x00\xC3", 5));
+
+	EXPECT_EQ(6, search->findUnslashedSignature("6A00C3", 0, lastOffset()));
+	EXPECT_EQ(2, search->findUnslashedSignature("C3", lastOffset(), lastOffset()));
+	EXPECT_EQ(2, search->exactComparison("C3", lastOffset()));
+	EXPECT_EQ(0, search->findUnslashedSignature("C390", 0, lastOffset()));
+}
+
+TEST_F(SearchTests, signatureWithWildcardPrefixIsNotSearchedBehindEndOfFile)
+{
+	setContent(std::string("\x90\x90\x6A\x00\xC3", 5));
+
+	EXPECT_EQ(0, search->findUnslashedSignature("??C3", lastOffset(), lastOffset()));
+	EXPECT_EQ(2, search->findUnslashedSignature("??C3", lastOffset() - 3, lastOffset()));
+	EXPECT_EQ(0, search->findSlashedSignature("????C3", lastOffset(), lastOffset() + 0x40));
+	EXPECT_EQ(0, search->findSlashedSignature("--??6A/90", lastOffset(), lastOffset() + 0x40));
+}
+
+//
+// findSlashedSignature()
+//
+
+TEST_F(SearchTests, findSlashedSignatureFollowsShortRelativeJump)
+{
+	// push ebp; jmp short +2; <2 skipped bytes>; push 0
+	setContent(std::string("\x55\xEB\x02\xAA\xBB\x6A\x00", 7));
+
+	// Fixed nibbles plus the average size of slash (2 nibbles).
+	EXPECT_EQ(8, search->findSlashedSignature("55/6A00", 0, lastOffset()));
+	EXPECT_EQ(8, search->exactComparison("55/6A00", 0));
+	EXPECT_EQ(0, search->findSlashedSignature("55/6A01", 0, lastOffset()));
+}
+
+TEST_F(SearchTests, findSlashedSignatureFollowsNearRelativeJump)
+{
+	// push ebp; jmp near +1; <1 skipped byte>; push 0
+	setContent(std::string("\x55\xE9\x01\x00\x00\x00\xAA\x6A\x00", 9));
+
+	EXPECT_EQ(8, search->findSlashedSignature("55/6A00", 0, lastOffset()));
+}
+
+TEST_F(SearchTests, findSlashedSignatureRequiresJumpAtSlash)
+{
+	setContent(std::string("\x55\x90\x02\xAA\xBB\x6A\x00", 7));
+
+	EXPECT_EQ(0, search->findSlashedSignature("55/6A00", 0, lastOffset()));
+}
+
+} // namespace tests
+} // namespace cpdetect
+} // namespace retdec
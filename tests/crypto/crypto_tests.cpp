@@ -0,0 +1,76 @@
+/**
+ * @file tests/crypto/crypto_tests.cpp
+ * @brief Tests for the @c crypto module.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/crypto/crypto.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace crypto {
+namespace tests {
+
+/**
+ * @brief Tests for the @c crypto module.
+ */
+class CryptoTests: public Test
+{
+	protected:
+		const unsigned char* bytes(const std::string& s)
+		{
+			return reinterpret_cast<const unsigned char*>(s.data());
+		}
+
+		void checkSinglePassHashes(const unsigned char* data, std::uint64_t length)
+		{
+			std::string crc32, md5, sha256;
+			getCrc32Md5Sha256(data, length, crc32, md5, sha256);
+
+			EXPECT_EQ(getCrc32(data, length), crc32);
+			EXPECT_EQ(getMd5(data, length), md5);
+			EXPECT_EQ(getSha256(data, length), sha256);
+		}
+};
+
+TEST_F(CryptoTests, getCrc32Md5Sha256ComputesKnownHashes)
+{
+	std::string data = "abc";
+	std::string crc32, md5, sha256;
+
+	getCrc32Md5Sha256(bytes(data), data.size(), crc32, md5, sha256);
+
+	EXPECT_EQ("352441c2", crc32);
+	EXPECT_EQ("900150983cd24fb0d6963f7d28e17f72", md5);
+	EXPECT_EQ(
+			"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+			sha256);
+}
+
+TEST_F(CryptoTests, getCrc32Md5Sha256OfEmptyDataIsSameAsSeparateHashes)
+{
+	std::string data;
+	checkSinglePassHashes(bytes(data), 0);
+}
+
+TEST_F(CryptoTests, getCrc32Md5Sha256OfManyBlocksIsSameAsSeparateHashes)
+{
+	// Spans several internal blocks and ends in the middle of one.
+	std::vector<unsigned char> data(100 * 1024 + 17);
+	for (std::size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = static_cast<unsigned char>(i * 31 + (i >> 8));
+	}
+
+	checkSinglePassHashes(data.data(), data.size());
+}
+
+} // namespace tests
+} // namespace crypto
+} // namespace retdec
@@ -4,6 +4,7 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <iterator>
 #include <string>
 
 #include <gtest/gtest.h>
@@ -99,6 +100,18 @@ TEST_F(ElfFormatTests, DataInterpretationBig)
 	EXPECT_EQ(0x7f454c4601010148, res);
 }
 
+TEST_F(ElfFormatTests, LazyLoadingGivesSameResultsAsEagerLoading)
+{
+	std::string elfString(std::begin(elfBytes), std::end(elfBytes));
+	std::stringstream elfStringStream(elfString);
+	ElfFormat lazyParser(elfStringStream, LoadFlags::LAZY_LOAD);
+
+	EXPECT_EQ(true, lazyParser.isInValidState());
+	EXPECT_EQ(parser->getNumberOfSegments(), lazyParser.getNumberOfSegments());
+	EXPECT_EQ(parser->getElfNoteSecSegs().size(), lazyParser.getElfNoteSecSegs().size());
+	EXPECT_EQ(parser->getElfCoreInfo() == nullptr, lazyParser.getElfCoreInfo() == nullptr);
+}
+
 } // namespace tests
 } // namespace fileformat
 } // namespace retdec
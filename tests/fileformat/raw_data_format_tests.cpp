@@ -9,6 +9,7 @@
 
 #include <gtest/gtest.h>
 
+#include "retdec/crypto/crypto.h"
 #include "retdec/fileformat/file_format/raw_data/raw_data_format.h"
 
 using namespace ::testing;
@@ -74,6 +75,21 @@ TEST_F(RawDataFormatTests, TestSettersGetters)
 	EXPECT_EQ(4, parser->getBytesPerWord());
 }
 
+TEST_F(RawDataFormatTests, SectionHashesAreSameWithParallelHashes)
+{
+	std::stringstream stream;
+	stream << input;
+	RawDataFormat parallelParser(stream, LoadFlags::PARALLEL_HASHES);
+	const auto* data = reinterpret_cast<const unsigned char*>(input.data());
+
+	ASSERT_EQ(1, parallelParser.getNumberOfSections());
+	const auto* sec = parallelParser.getSections()[0];
+	EXPECT_EQ(retdec::crypto::getCrc32(data, input.size()), sec->getCrc32());
+	EXPECT_EQ(retdec::crypto::getMd5(data, input.size()), sec->getMd5());
+	EXPECT_EQ(retdec::crypto::getSha256(data, input.size()), sec->getSha256());
+	EXPECT_EQ(parser->getSections()[0]->getSha256(), sec->getSha256());
+}
+
 TEST_F(RawDataFormatTests, TestInvalidEP)
 {
 	unsigned long long result;
@@ -8,6 +8,7 @@
 
 #include "retdec/llvmir2hll/config/configs/json_config.h"
 #include "retdec/llvmir2hll/support/types.h"
+#include "retdec/config/config.h"
 
 using namespace ::testing;
 
@@ -41,6 +42,30 @@ ConfigFromStringRaisesJSONParsingErrorWhenJSONIsInvalid) {
 	ASSERT_THROW(JSONConfig::fromString("%"), JSONConfigParsingError);
 }
 
+TEST_F(JSONConfigTests,
+ConfigFromConfigUsesDataFromGivenConfig) {
+	retdec::config::Config origConfig;
+	origConfig.readJsonString(R"({
+		"globals": [
+			{
+				"name": "g",
+				"storage": {
+					"type": "global",
+					"value": 1000
+				},
+				"type": {
+					"llvmIr": "i32*",
+					"isWideString": true
+				}
+			}
+		]
+	})");
+
+	auto config = JSONConfig::fromConfig(origConfig);
+
+	ASSERT_TRUE(config->isGlobalVarStoringWideString("g"));
+}
+
 //
 // isGlobalVarStoringWideString()
 //
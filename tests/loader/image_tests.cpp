@@ -0,0 +1,150 @@
+/**
+ * @file tests/loader/image_tests.cpp
+ * @brief Tests for the @c image module.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <gtest/gtest.h>
+
+#include "retdec/loader/loader/image.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace loader {
+namespace tests {
+
+/**
+ * Image whose segments are inserted directly by tests.
+ */
+class TestImage : public Image
+{
+public:
+	TestImage() : Image(nullptr) {}
+
+	virtual bool load() override { return true; }
+
+	Segment* addSegment(std::uint64_t address, std::uint64_t size)
+	{
+		return insertSegment(std::make_unique<Segment>(nullptr, address, size, nullptr));
+	}
+
+	Segment* addSegment(std::uint64_t address, std::uint64_t size, const std::vector<std::uint8_t>& data)
+	{
+		llvm::StringRef dataRef(reinterpret_cast<const char*>(data.data()), data.size());
+		return insertSegment(std::make_unique<Segment>(nullptr, address, size,
+			std::make_unique<SegmentDataSource>(dataRef)));
+	}
+
+	using Image::removeSegment;
+	using Image::sortSegments;
+	using Image::invalidateSegmentIndex;
+};
+
+class ImageTests : public Test
+{
+protected:
+	TestImage image;
+};
+
+TEST_F(ImageTests,
+GetSegmentFromAddressReturnsNullWhenThereAreNoSegments) {
+	EXPECT_EQ(nullptr, image.getSegmentFromAddress(0x1000));
+}
+
+TEST_F(ImageTests,
+GetSegmentFromAddressFindsSegmentContainingAddress) {
+	auto* seg1 = image.addSegment(0x1000, 0x100);
+	auto* seg2 = image.addSegment(0x3000, 0x100);
+
+	EXPECT_EQ(nullptr, image.getSegmentFromAddress(0xFFF));
+	EXPECT_EQ(seg1, image.getSegmentFromAddress(0x1000));
+	EXPECT_EQ(seg1, image.getSegmentFromAddress(0x10FF));
+	EXPECT_EQ(nullptr, image.getSegmentFromAddress(0x1100));
+	EXPECT_EQ(nullptr, image.getSegmentFromAddress(0x2FFF));
+	EXPECT_EQ(seg2, image.getSegmentFromAddress(0x3000));
+	EXPECT_EQ(seg2, image.getSegmentFromAddress(0x3050));
+	EXPECT_EQ(nullptr, image.getSegmentFromAddress(0x3100));
+}
+
+TEST_F(ImageTests,
+GetSegmentFromAddressPrefersFirstOfOverlappingSegments) {
+	auto* seg1 = image.addSegment(0x1000, 0x100);
+	auto* seg2 = image.addSegment(0x0F00, 0x400);
+
+	EXPECT_EQ(seg2, image.getSegmentFromAddress(0x0F00));
+	EXPECT_EQ(seg1, image.getSegmentFromAddress(0x1000));
+	EXPECT_EQ(seg1, image.getSegmentFromAddress(0x10FF));
+	EXPECT_EQ(seg2, image.getSegmentFromAddress(0x1100));
+	EXPECT_EQ(seg2, image.getSegmentFromAddress(0x12FF));
+	EXPECT_EQ(nullptr, image.getSegmentFromAddress(0x1300));
+}
+
+TEST_F(ImageTests,
+GetSegmentFromAddressWorksWithSegmentAtTheEndOfAddressSpace) {
+	auto* seg = image.addSegment(0xFFFFFFFFFFFFFF00, 0x100);
+
+	EXPECT_EQ(seg, image.getSegmentFromAddress(0xFFFFFFFFFFFFFFFF));
+	EXPECT_EQ(nullptr, image.getSegmentFromAddress(0xFFFFFFFFFFFFFEFF));
+}
+
+TEST_F(ImageTests,
+GetSegmentFromAddressReflectsInsertionAndRemovalOfSegments) {
+	auto* seg1 = image.addSegment(0x1000, 0x100);
+	EXPECT_EQ(seg1, image.getSegmentFromAddress(0x1000));
+	EXPECT_EQ(nullptr, image.getSegmentFromAddress(0x2000));
+
+	auto* seg2 = image.addSegment(0x2000, 0x100);
+	EXPECT_EQ(seg2, image.getSegmentFromAddress(0x2000));
+
+	image.removeSegment(seg1);
+	EXPECT_EQ(nullptr, image.getSegmentFromAddress(0x1000));
+	EXPECT_EQ(seg2, image.getSegmentFromAddress(0x2000));
+}
+
+TEST_F(ImageTests,
+GetSegmentFromAddressReflectsSortingOfSegments) {
+	auto* seg1 = image.addSegment(0x1080, 0x100);
+	auto* seg2 = image.addSegment(0x1000, 0x100);
+	EXPECT_EQ(seg1, image.getSegmentFromAddress(0x10A0));
+
+	image.sortSegments();
+	EXPECT_EQ(seg2, image.getSegmentFromAddress(0x10A0));
+}
+
+TEST_F(ImageTests,
+GetSegmentFromAddressReflectsResizedSegmentAfterInvalidation) {
+	auto* seg = image.addSegment(0x1000, 0x100);
+	EXPECT_EQ(nullptr, image.getSegmentFromAddress(0x1100));
+
+	seg->resize(0x200);
+	image.invalidateSegmentIndex();
+	EXPECT_EQ(seg, image.getSegmentFromAddress(0x1100));
+}
+
+TEST_F(ImageTests,
+ReadBytesReadsAcrossAdjacentSegments) {
+	std::vector<std::uint8_t> data1 = { 0x10, 0x11 };
+	std::vector<std::uint8_t> data2 = { 0x20, 0x21, 0x22, 0x23 };
+	image.addSegment(0x1000, 4, data1);
+	image.addSegment(0x1004, 4, data2);
+
+	std::uint8_t loaded[8] = {};
+	EXPECT_EQ(6, image.readBytes(0x1002, loaded, 8));
+
+	std::vector<std::uint8_t> expected = { 0x00, 0x00, 0x20, 0x21, 0x22, 0x23 };
+	EXPECT_EQ(expected, std::vector<std::uint8_t>(loaded, loaded + 6));
+}
+
+TEST_F(ImageTests,
+ReadBytesReturnsZeroOutsideOfSegments) {
+	std::vector<std::uint8_t> data = { 0x10, 0x11 };
+	image.addSegment(0x1000, 2, data);
+
+	std::uint8_t loaded[2] = {};
+	EXPECT_EQ(0, image.readBytes(0x2000, loaded, 2));
+}
+
+} // namespace tests
+} // namespace loader
+} // namespace retdec
@@ -615,6 +615,50 @@ Get8ByteArrayWorks) {
 	EXPECT_EQ(expected, loaded);
 }
 
+TEST_F(ByteValueStorageTests,
+ReadWorks) {
+	MockByteValueStorage storage;
+
+	std::uint64_t address = 0;
+	std::uint64_t width = 2;
+
+	EXPECT_CALL(storage, getXByte(address,width,_,_))
+		.Times(1)
+		.WillOnce(DoAll(SetArgReferee<2>(0x4243), Return(true)));
+
+	std::uint16_t val = 0;
+	EXPECT_TRUE(storage.read(address, val));
+	EXPECT_EQ(0x4243, val);
+}
+
+TEST_F(ByteValueStorageTests,
+ReadFailsIfGetXByteFails) {
+	MockByteValueStorage storage;
+
+	EXPECT_CALL(storage, getXByte(_,4,_,_))
+		.Times(1)
+		.WillOnce(Return(false));
+
+	std::uint32_t val = 0;
+	EXPECT_FALSE(storage.read(0, val));
+}
+
+TEST_F(ByteValueStorageTests,
+ReadBytesStopsAtFirstUnreadableByte) {
+	MockByteValueStorage storage;
+
+	EXPECT_CALL(storage, getXByte(AllOf(Ge(0),Le(2)),1,_,_))
+		.Times(3)
+		.WillOnce(DoAll(SetArgReferee<2>(0x10), Return(true)))
+		.WillOnce(DoAll(SetArgReferee<2>(0x20), Return(true)))
+		.WillOnce(Return(false));
+
+	std::uint8_t loaded[4] = {};
+	EXPECT_EQ(2, storage.readBytes(0, loaded, 4));
+	EXPECT_EQ(0x10, loaded[0]);
+	EXPECT_EQ(0x20, loaded[1]);
+}
+
 } // namespace tests
 } // namespace utils
 } // namespace retdec
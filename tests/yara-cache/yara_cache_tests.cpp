@@ -0,0 +1,207 @@
+/**
+ * @file tests/yara-cache/yara_cache_tests.cpp
+ * @brief Tests for the @c yara_cache module.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <fstream>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "retdec/utils/os.h"
+#include "retdec/yara-cache/yara_cache.h"
+#include "yara-cache/yara_tests.h"
+
+#ifdef OS_POSIX
+	#include <sys/stat.h>
+#endif
+
+using namespace ::testing;
+
+namespace retdec {
+namespace yara_cache {
+namespace tests {
+
+/**
+ * @brief Tests for the @c yara_cache module.
+ */
+class YaraCacheTests : public YaraTests
+{
+	protected:
+		std::string getCachePath(
+				const std::string& cacheDir,
+				const std::string& ruleFile) const
+		{
+			llvm::SmallString<256> path(cacheDir);
+			llvm::sys::path::append(path, getRuleFileKey(ruleFile) + ".yarac");
+			return path.str();
+		}
+
+		std::string readFile(const std::string& path) const
+		{
+			std::ifstream file(path, std::ios::binary);
+			std::stringstream content;
+			content << file.rdbuf();
+			return content.str();
+		}
+};
+
+//
+// getRuleFileKey()
+//
+
+TEST_F(YaraCacheTests, getRuleFileKeyDependsOnlyOnContent)
+{
+	auto file1 = writeFile("rules1.yar", VALID_RULES);
+	auto file2 = writeFile("rules2.yar", VALID_RULES);
+	auto file3 = writeFile("rules3.yar", VALID_RULES + "\n");
+
+	auto key = getRuleFileKey(file1);
+	EXPECT_FALSE(key.empty());
+	EXPECT_EQ(key, getRuleFileKey(file1));
+	EXPECT_EQ(key, getRuleFileKey(file2));
+	EXPECT_NE(key, getRuleFileKey(file3));
+}
+
+TEST_F(YaraCacheTests, getRuleFileKeyOfMissingFileIsEmpty)
+{
+	EXPECT_TRUE(getRuleFileKey(getPath("missing.yar")).empty());
+}
+
+//
+// getLocalCompiledRuleFile()
+//
+
+TEST_F(YaraCacheTests, getLocalCompiledRuleFileReturnsRulesCompiledNextToRuleFile)
+{
+	auto ruleFile = writeFile("rules.yar", VALID_RULES);
+	auto localDir = getPath(LOCAL_CACHE_DIR_NAME);
+	ASSERT_TRUE(addToCache(ruleFile, localDir, true));
+
+	auto compiled = getLocalCompiledRuleFile(ruleFile);
+
+	EXPECT_EQ(getCachePath(localDir, ruleFile), compiled);
+	EXPECT_TRUE(isCompiledRuleFile(compiled));
+}
+
+TEST_F(YaraCacheTests, getLocalCompiledRuleFileReturnsEmptyStringWithoutLocalCache)
+{
+	auto ruleFile = writeFile("rules.yar", VALID_RULES);
+
+	EXPECT_TRUE(getLocalCompiledRuleFile(ruleFile).empty());
+}
+
+TEST_F(YaraCacheTests, getLocalCompiledRuleFileIgnoresRulesCompiledFromOldContent)
+{
+	auto ruleFile = writeFile("rules.yar", VALID_RULES);
+	ASSERT_TRUE(addToCache(ruleFile, getPath(LOCAL_CACHE_DIR_NAME), true));
+	writeFile("rules.yar", VALID_RULES + "\n");
+
+	EXPECT_TRUE(getLocalCompiledRuleFile(ruleFile).empty());
+}
+
+//
+// getCompiledRuleFile()
+//
+
+TEST_F(YaraCacheTests, getCompiledRuleFileCompilesRulesIntoCacheOnMiss)
+{
+	auto ruleFile = writeFile("rules.yar", VALID_RULES);
+
+	auto compiled = getCompiledRuleFile(ruleFile, cacheDir);
+
+	EXPECT_EQ(getCachePath(cacheDir, ruleFile), compiled);
+	EXPECT_TRUE(isCompiledRuleFile(compiled));
+	EXPECT_TRUE(isTrustedCachePath(cacheDir));
+	EXPECT_TRUE(isTrustedCachePath(compiled));
+}
+
+TEST_F(YaraCacheTests, getCompiledRuleFileReturnsCachedRulesOnHit)
+{
+	auto ruleFile = writeFile("rules.yar", VALID_RULES);
+	auto compiled = getCompiledRuleFile(ruleFile, cacheDir);
+	ASSERT_EQ(getCachePath(cacheDir, ruleFile), compiled);
+	// Marks the cached file, it would be overwritten by another compilation.
+	std::ofstream(compiled, std::ios::binary | std::ios::app) << "cached";
+	auto content = readFile(compiled);
+
+	EXPECT_EQ(compiled, getCompiledRuleFile(ruleFile, cacheDir));
+	EXPECT_EQ(content, readFile(compiled));
+}
+
+TEST_F(YaraCacheTests, getCompiledRuleFilePrefersLocalCache)
+{
+	auto ruleFile = writeFile("rules.yar", VALID_RULES);
+	auto localDir = getPath(LOCAL_CACHE_DIR_NAME);
+	ASSERT_TRUE(addToCache(ruleFile, localDir, true));
+
+	EXPECT_EQ(getCachePath(localDir, ruleFile), getCompiledRuleFile(ruleFile, cacheDir));
+	EXPECT_FALSE(llvm::sys::fs::exists(cacheDir));
+}
+
+TEST_F(YaraCacheTests, getCompiledRuleFileReturnsRuleFileIfRulesCannotBeCompiled)
+{
+	auto ruleFile = writeFile("broken.yar", BROKEN_RULES);
+
+	EXPECT_EQ(ruleFile, getCompiledRuleFile(ruleFile, cacheDir));
+}
+
+TEST_F(YaraCacheTests, getCompiledRuleFileReturnsRuleFileWithoutCacheDir)
+{
+	auto ruleFile = writeFile("rules.yar", VALID_RULES);
+
+	EXPECT_EQ(ruleFile, getCompiledRuleFile(ruleFile, ""));
+}
+
+#ifdef OS_POSIX
+
+TEST_F(YaraCacheTests, getCompiledRuleFileIgnoresRulesInWorldWritableCacheDir)
+{
+	auto ruleFile = writeFile("rules.yar", VALID_RULES);
+	ASSERT_EQ(0, mkdir(cacheDir.c_str(), 0700));
+	ASSERT_EQ(0, chmod(cacheDir.c_str(), 0777));
+	auto planted = getCachePath(cacheDir, ruleFile);
+	std::ofstream(planted, std::ios::binary) << "YARA planted";
+	ASSERT_EQ(0, chmod(planted.c_str(), 0600));
+
+	EXPECT_FALSE(isTrustedCachePath(cacheDir));
+	EXPECT_EQ(ruleFile, getCompiledRuleFile(ruleFile, cacheDir));
+}
+
+TEST_F(YaraCacheTests, getCompiledRuleFileIgnoresGroupWritableCachedRules)
+{
+	auto ruleFile = writeFile("rules.yar", VALID_RULES);
+	ASSERT_EQ(0, mkdir(cacheDir.c_str(), 0700));
+	auto planted = getCachePath(cacheDir, ruleFile);
+	std::ofstream(planted, std::ios::binary) << "YARA planted";
+	ASSERT_EQ(0, chmod(planted.c_str(), 0620));
+
+	EXPECT_FALSE(isTrustedCachePath(planted));
+	EXPECT_EQ(ruleFile, getCompiledRuleFile(ruleFile, cacheDir));
+}
+
+TEST_F(YaraCacheTests, cacheDirIsCreatedAccessibleOnlyByOwner)
+{
+	auto ruleFile = writeFile("rules.yar", VALID_RULES);
+	getCompiledRuleFile(ruleFile, cacheDir);
+
+	struct stat st;
+	ASSERT_EQ(0, stat(cacheDir.c_str(), &st));
+	EXPECT_EQ(0, st.st_mode & 077);
+}
+
+#endif
+
+//
+// isTrustedCachePath()
+//
+
+TEST_F(YaraCacheTests, missingPathIsNotTrusted)
+{
+	EXPECT_FALSE(isTrustedCachePath(getPath("missing")));
+}
+
+} // namespace tests
+} // namespace yara_cache
+} // namespace retdec
@@ -0,0 +1,192 @@
+/**
+ * @file tests/yara-cache/yara_scanner_tests.cpp
+ * @brief Tests for the @c yara_scanner module.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include <cstdint>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "retdec/yara-cache/yara_scanner.h"
+#include "yara-cache/yara_tests.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace yara_cache {
+namespace tests {
+
+namespace {
+
+const std::string RULES_ABC =
+		"rule rule_abc { strings: $a = \"abc\" condition: $a }\n";
+
+const std::string RULES_XYZ =
+		"rule rule_xyz { strings: $a = \"xyz\" condition: $a }\n";
+
+const std::string RULES_NOT_FOUND =
+		"rule rule_not_found { strings: $a = \"not found\" condition: $a }\n";
+
+} // anonymous namespace
+
+/**
+ * @brief Tests for the @c yara_scanner module.
+ */
+class YaraScannerTests : public YaraTests
+{
+	protected:
+		bool analyze(
+				YaraScanner &scanner,
+				const std::string &data,
+				bool storeAll = false,
+				std::size_t baseOffset = 0)
+		{
+			return scanner.analyze(
+					reinterpret_cast<const std::uint8_t*>(data.data()),
+					data.size(),
+					storeAll,
+					baseOffset);
+		}
+};
+
+TEST_F(YaraScannerTests, rulesAreReportedInNamespacesOfTheirFiles)
+{
+	YaraScanner scanner(cacheDir);
+	ASSERT_TRUE(scanner.addRuleFile(writeFile("abc.yar", RULES_ABC), "first"));
+	ASSERT_TRUE(scanner.addRuleFile(writeFile("xyz.yar", RULES_XYZ), "second"));
+
+	EXPECT_TRUE(analyze(scanner, "--abc--xyz--"));
+
+	const auto &first = scanner.getDetectedRules("first");
+	ASSERT_EQ(1, first.size());
+	EXPECT_EQ("rule_abc", first[0].getName());
+	const auto &second = scanner.getDetectedRules("second");
+	ASSERT_EQ(1, second.size());
+	EXPECT_EQ("rule_xyz", second[0].getName());
+	EXPECT_TRUE(scanner.getDetectedRules().empty());
+}
+
+TEST_F(YaraScannerTests, rulesWithoutNamespaceAreReportedInDefaultNamespace)
+{
+	YaraScanner scanner(cacheDir);
+	ASSERT_TRUE(scanner.addRuleFile(writeFile("abc.yar", RULES_ABC)));
+
+	EXPECT_TRUE(analyze(scanner, "abc"));
+
+	ASSERT_EQ(1, scanner.getDetectedRules().size());
+	EXPECT_EQ("rule_abc", scanner.getDetectedRules()[0].getName());
+}
+
+TEST_F(YaraScannerTests, compiledRulesAreReportedInTheirNamespace)
+{
+	auto compiled = getPath("abc.yarac");
+	ASSERT_TRUE(compileRuleFile(writeFile("abc.yar", RULES_ABC), compiled));
+	YaraScanner scanner(cacheDir);
+	ASSERT_TRUE(scanner.addRuleFile(compiled, "compiled"));
+
+	EXPECT_TRUE(analyze(scanner, "abc"));
+
+	ASSERT_EQ(1, scanner.getDetectedRules("compiled").size());
+	EXPECT_EQ("rule_abc", scanner.getDetectedRules("compiled")[0].getName());
+}
+
+TEST_F(YaraScannerTests, baseOffsetIsAddedToOffsetsOfMatches)
+{
+	YaraScanner scanner(cacheDir);
+	ASSERT_TRUE(scanner.addRuleFile(writeFile("abc.yar", RULES_ABC)));
+
+	EXPECT_TRUE(analyze(scanner, "--abc", false, 0x100));
+
+	const auto &rules = scanner.getDetectedRules();
+	ASSERT_EQ(1, rules.size());
+	ASSERT_EQ(1, rules[0].getNumberOfMatches());
+	EXPECT_EQ(0x102, rules[0].getMatch(0)->getOffset());
+}
+
+TEST_F(YaraScannerTests, undetectedRulesAreStoredOnlyWithStoreAll)
+{
+	YaraScanner scanner(cacheDir);
+	ASSERT_TRUE(scanner.addRuleFile(writeFile("abc.yar", RULES_ABC)));
+	ASSERT_TRUE(scanner.addRuleFile(writeFile("nf.yar", RULES_NOT_FOUND)));
+
+	EXPECT_TRUE(analyze(scanner, "abc"));
+	EXPECT_EQ(1, scanner.getDetectedRules().size());
+	EXPECT_TRUE(scanner.getUndetectedRules().empty());
+
+	EXPECT_TRUE(analyze(scanner, "abc", true));
+	EXPECT_EQ(1, scanner.getDetectedRules().size());
+	ASSERT_EQ(1, scanner.getUndetectedRules().size());
+	EXPECT_EQ("rule_not_found", scanner.getUndetectedRules()[0].getName());
+}
+
+TEST_F(YaraScannerTests, brokenFileDoesNotDisableRulesFromOtherFiles)
+{
+	YaraScanner scanner(cacheDir);
+	ASSERT_TRUE(scanner.addRuleFile(writeFile("abc.yar", RULES_ABC), "good"));
+	ASSERT_TRUE(scanner.addRuleFile(writeFile("broken.yar", BROKEN_RULES), "bad"));
+
+	EXPECT_FALSE(analyze(scanner, "abc"));
+
+	EXPECT_FALSE(scanner.isInValidState());
+	ASSERT_EQ(1, scanner.getDetectedRules("good").size());
+	EXPECT_EQ("rule_abc", scanner.getDetectedRules("good")[0].getName());
+}
+
+TEST_F(YaraScannerTests, rulesAreCompiledInMemoryWithoutCache)
+{
+	YaraScanner scanner("");
+	ASSERT_TRUE(scanner.addRuleFile(writeFile("abc.yar", RULES_ABC)));
+
+	EXPECT_TRUE(analyze(scanner, "abc"));
+
+	EXPECT_EQ(1, scanner.getDetectedRules().size());
+}
+
+TEST_F(YaraScannerTests, rulesCompiledDuringInstallationAreUsedIfAllFilesHaveThem)
+{
+	auto abcFile = writeFile("abc.yar", RULES_ABC);
+	auto xyzFile = writeFile("xyz.yar", RULES_XYZ);
+	ASSERT_TRUE(addToCache(abcFile, getPath(LOCAL_CACHE_DIR_NAME), true));
+	ASSERT_TRUE(addToCache(xyzFile, getPath(LOCAL_CACHE_DIR_NAME), true));
+	YaraScanner scanner(cacheDir);
+	ASSERT_TRUE(scanner.addRuleFile(abcFile, "first"));
+	ASSERT_TRUE(scanner.addRuleFile(xyzFile, "second"));
+
+	EXPECT_TRUE(analyze(scanner, "--abc--xyz--"));
+
+	ASSERT_EQ(1, scanner.getDetectedRules("first").size());
+	EXPECT_EQ("rule_abc", scanner.getDetectedRules("first")[0].getName());
+	ASSERT_EQ(1, scanner.getDetectedRules("second").size());
+	EXPECT_EQ("rule_xyz", scanner.getDetectedRules("second")[0].getName());
+	// Nothing had to be compiled into the cache of the user.
+	EXPECT_FALSE(llvm::sys::fs::exists(cacheDir));
+}
+
+TEST_F(YaraScannerTests, rulesAreCompiledTogetherIfSomeFileIsNotCompiledDuringInstallation)
+{
+	auto abcFile = writeFile("abc.yar", RULES_ABC);
+	ASSERT_TRUE(addToCache(abcFile, getPath(LOCAL_CACHE_DIR_NAME), true));
+	YaraScanner scanner(cacheDir);
+	ASSERT_TRUE(scanner.addRuleFile(abcFile, "first"));
+	ASSERT_TRUE(scanner.addRuleFile(writeFile("xyz.yar", RULES_XYZ), "second"));
+
+	EXPECT_TRUE(analyze(scanner, "--abc--xyz--"));
+
+	EXPECT_EQ(1, scanner.getDetectedRules("first").size());
+	EXPECT_EQ(1, scanner.getDetectedRules("second").size());
+	EXPECT_TRUE(llvm::sys::fs::exists(cacheDir));
+}
+
+TEST_F(YaraScannerTests, missingRuleFileIsNotAdded)
+{
+	YaraScanner scanner(cacheDir);
+
+	EXPECT_FALSE(scanner.addRuleFile(getPath("missing.yar")));
+	EXPECT_FALSE(scanner.isInValidState());
+}
+
+} // namespace tests
+} // namespace yara_cache
+} // namespace retdec
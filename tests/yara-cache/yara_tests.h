@@ -0,0 +1,113 @@
+/**
+ * @file tests/yara-cache/yara_tests.h
+ * @brief Base class for tests working with YARA rule files.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#ifndef TESTS_YARA_CACHE_YARA_TESTS_H
+#define TESTS_YARA_CACHE_YARA_TESTS_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+
+namespace retdec {
+namespace yara_cache {
+namespace tests {
+
+/**
+ * Tests with files in a unique temporary directory, which is removed
+ * together with its content after each test.
+ */
+class YaraTests : public ::testing::Test
+{
+	protected:
+		virtual void SetUp() override
+		{
+			ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory(
+					"retdec-yara-tests", dir));
+			cacheDir = getPath("cache");
+		}
+
+		virtual void TearDown() override
+		{
+			removeTree(dir.str());
+		}
+
+		/**
+		 * Get path of @a name in the temporary directory.
+		 */
+		std::string getPath(const std::string& name) const
+		{
+			llvm::SmallString<256> path(dir);
+			llvm::sys::path::append(path, name);
+			return path.str();
+		}
+
+		/**
+		 * Write @a content into file @a name in the temporary directory.
+		 * @return Path to the file.
+		 */
+		std::string writeFile(
+				const std::string& name,
+				const std::string& content) const
+		{
+			auto path = getPath(name);
+			std::ofstream file(path, std::ios::binary);
+			file << content;
+			return path;
+		}
+
+	private:
+		static void removeTree(const std::string& path)
+		{
+			std::error_code ec;
+			std::vector<std::string> entries;
+			for (llvm::sys::fs::directory_iterator it(path, ec), end;
+					it != end && !ec;
+					it.increment(ec))
+			{
+				entries.push_back(it->path());
+			}
+			for (const auto& entry : entries)
+			{
+				if (llvm::sys::fs::is_directory(entry))
+				{
+					removeTree(entry);
+				}
+				else
+				{
+					llvm::sys::fs::remove(entry);
+				}
+			}
+			llvm::sys::fs::remove(path);
+		}
+
+	protected:
+		llvm::SmallString<256> dir;
+		std::string cacheDir;
+};
+
+/// Valid source rules.
+const std::string VALID_RULES =
+		"rule test_rule\n"
+		"{\n"
+		"	strings:\n"
+		"		$a = \"abc\"\n"
+		"	condition:\n"
+		"		$a\n"
+		"}\n";
+
+/// Rules that cannot be compiled.
+const std::string BROKEN_RULES = "rule broken_rule { condition: }\n";
+
+} // namespace tests
+} // namespace yara_cache
+} // namespace retdec
+
+#endif